@@ -0,0 +1,429 @@
+// Нагрузочный генератор для financial_manager: сценарии поверх drogon::HttpClient,
+// результат — JSON с пропускной способностью и перцентилями задержки по каждому запросу.
+//
+//   ./financial_manager_bench --url http://127.0.0.1:9000 --connections 64 \
+//       --rps 2000 --duration 30 --scenario mixed --out run.json
+//
+// Каждое соединение — отдельный виртуальный пользователь: при старте он регистрируется,
+// создаёт семью, два счёта и категорию, затем крутит выбранный сценарий.
+// --scenario hot_account: все соединения пишут транзакции в один счёт одного пользователя,
+// как члены семьи в общий семейный счёт; сравнивает пакетную запись (db/GroupCommit.h)
+// с custom_config.group_commit.max_batch = 1.
+// --rps 0 — замкнутый цикл (следующий запрос сразу после ответа). При --rps > 0 запросы
+// идут по расписанию, и задержка считается от запланированного момента отправки,
+// чтобы медленные ответы не прятали очередь (coordinated omission).
+#include <drogon/HttpClient.h>
+#include <drogon/utils/coroutine.h>
+#include <jsoncpp/json/json.h>
+#include <trantor/net/EventLoopThreadPool.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string url = "http://127.0.0.1:9000";
+    size_t connections = 32;
+    double rps = 0;
+    double durationSec = 10;
+    size_t threads = 2;
+    double timeoutSec = 5;
+    std::string scenario = "mixed";
+    std::string out;
+};
+
+enum class Scenario { Auth, CreateTransaction, CreateTransfer, ListTransactions, BudgetPage, HotAccount, Mixed };
+
+static const std::map<std::string, Scenario> scenarioNames = {
+    {"auth", Scenario::Auth},
+    {"create_transaction", Scenario::CreateTransaction},
+    {"create_transfer", Scenario::CreateTransfer},
+    {"list_transactions", Scenario::ListTransactions},
+    {"budget_page", Scenario::BudgetPage},
+    {"hot_account", Scenario::HotAccount},
+    {"mixed", Scenario::Mixed},
+};
+
+// Задержки успешных ответов (мкс) и число ошибок по одному виду запроса
+struct Series {
+    std::vector<uint32_t> latencyUs;
+    uint64_t errors = 0;
+};
+
+using Stats = std::map<std::string, Series>;
+
+struct VirtualUser {
+    size_t index = 0;
+    drogon::HttpClientPtr client;
+    std::string token;
+    int accountA = 0;
+    int accountB = 0;
+    int categoryId = 0;
+    bool transferForward = true;
+    uint64_t counter = 0;
+    std::mt19937 rng;
+    Stats stats;
+};
+
+// Общий счёт сценария hot_account: его владелец заводится до запуска соединений
+struct HotAccount {
+    std::string token;
+    int accountId = 0;
+    int categoryId = 0;
+};
+
+static HotAccount hotAccount;
+
+static Options parseOptions(int argc, char *argv[]) {
+    Options o;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string key = argv[i];
+        std::string value = argv[i + 1];
+        if (key == "--url") o.url = value;
+        else if (key == "--connections") o.connections = std::stoul(value);
+        else if (key == "--rps") o.rps = std::stod(value);
+        else if (key == "--duration") o.durationSec = std::stod(value);
+        else if (key == "--threads") o.threads = std::stoul(value);
+        else if (key == "--timeout") o.timeoutSec = std::stod(value);
+        else if (key == "--scenario") o.scenario = value;
+        else if (key == "--out") o.out = value;
+        else throw std::invalid_argument("unknown option " + key);
+    }
+    if (!scenarioNames.count(o.scenario)) {
+        throw std::invalid_argument("unknown scenario " + o.scenario);
+    }
+    if (o.connections == 0 || o.threads == 0) {
+        throw std::invalid_argument("connections and threads must be positive");
+    }
+    return o;
+}
+
+static drogon::HttpRequestPtr makeRequest(drogon::HttpMethod method,
+                                          const std::string &path,
+                                          const std::string &token,
+                                          const Json::Value *body = nullptr) {
+    auto req = body ? drogon::HttpRequest::newHttpJsonRequest(*body) : drogon::HttpRequest::newHttpRequest();
+    req->setMethod(method);
+    req->setPath(path);
+    if (!token.empty()) {
+        req->addHeader("Authorization", "Bearer " + token);
+    }
+    return req;
+}
+
+static std::string uniqueEmail(VirtualUser &u) {
+    return "bench-" + std::to_string(getpid()) + "-" + std::to_string(u.index) + "-" +
+           std::to_string(u.counter++) + "@example.com";
+}
+
+// Запрос с замером; при ошибке (не 2xx, таймаут, обрыв) возвращает nullptr
+static drogon::Task<drogon::HttpResponsePtr> timed(VirtualUser &u,
+                                                   const Options &opts,
+                                                   std::string name,
+                                                   drogon::HttpRequestPtr req,
+                                                   Clock::time_point start) {
+    auto &series = u.stats[name];
+    try {
+        auto resp = co_await u.client->sendRequestCoro(req, opts.timeoutSec);
+        int code = static_cast<int>(resp->statusCode());
+        if (code < 200 || code >= 300) {
+            ++series.errors;
+            co_return nullptr;
+        }
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+        series.latencyUs.push_back(static_cast<uint32_t>(std::min<int64_t>(us, UINT32_MAX)));
+        co_return resp;
+    } catch (const std::exception &) {
+        ++series.errors;
+        co_return nullptr;
+    }
+}
+
+// Подготовка виртуального пользователя; при ошибке бросает исключение
+static drogon::Task<void> setup(VirtualUser &u, const Options &opts) {
+    auto expect = [&](const drogon::HttpResponsePtr &resp, const char *what) -> Json::Value {
+        int code = static_cast<int>(resp->statusCode());
+        if (code < 200 || code >= 300 || !resp->getJsonObject()) {
+            throw std::runtime_error(std::string(what) + " failed: HTTP " + std::to_string(code));
+        }
+        return *resp->getJsonObject();
+    };
+
+    Json::Value reg;
+    reg["name"] = "bench " + std::to_string(u.index);
+    reg["email"] = uniqueEmail(u);
+    reg["password"] = "bench-password";
+    auto resp = co_await u.client->sendRequestCoro(
+        makeRequest(drogon::Post, "/api/auth/register", "", &reg), opts.timeoutSec);
+    u.token = expect(resp, "register")["token"].asString();
+
+    Json::Value family;
+    family["name"] = "bench family " + std::to_string(u.index);
+    co_await u.client->sendRequestCoro(makeRequest(drogon::Post, "/api/family", u.token, &family), opts.timeoutSec);
+
+    Json::Value account;
+    account["account_type"] = "card";
+    account["balance"] = "1000000";
+    account["account_name"] = "bench A";
+    resp = co_await u.client->sendRequestCoro(makeRequest(drogon::Post, "/accounts", u.token, &account), opts.timeoutSec);
+    u.accountA = expect(resp, "create account")["id"].asInt();
+    account["account_name"] = "bench B";
+    resp = co_await u.client->sendRequestCoro(makeRequest(drogon::Post, "/accounts", u.token, &account), opts.timeoutSec);
+    u.accountB = expect(resp, "create account")["id"].asInt();
+
+    Json::Value category;
+    category["name"] = "bench income";
+    category["type"] = "income";
+    resp = co_await u.client->sendRequestCoro(makeRequest(drogon::Post, "/categories", u.token, &category), opts.timeoutSec);
+    u.categoryId = expect(resp, "create category")["id"].asInt();
+}
+
+static Scenario pickMixed(VirtualUser &u) {
+    // Доли примерно как у живого трафика: чтение преобладает
+    int roll = std::uniform_int_distribution<int>(0, 99)(u.rng);
+    if (roll < 40) return Scenario::ListTransactions;
+    if (roll < 60) return Scenario::CreateTransaction;
+    if (roll < 75) return Scenario::CreateTransfer;
+    if (roll < 95) return Scenario::BudgetPage;
+    return Scenario::Auth;
+}
+
+static drogon::Task<void> runStep(VirtualUser &u, const Options &opts, Scenario s, Clock::time_point start) {
+    switch (s) {
+        case Scenario::Auth: {
+            // Регистрация нового пользователя и сразу вход
+            Json::Value reg;
+            reg["name"] = "bench";
+            reg["email"] = uniqueEmail(u);
+            reg["password"] = "bench-password";
+            auto resp = co_await timed(u, opts, "register", makeRequest(drogon::Post, "/api/auth/register", "", &reg), start);
+            if (!resp) {
+                co_return;
+            }
+            Json::Value login;
+            login["email"] = reg["email"];
+            login["password"] = reg["password"];
+            co_await timed(u, opts, "login", makeRequest(drogon::Post, "/api/auth/login", "", &login), Clock::now());
+            co_return;
+        }
+        case Scenario::CreateTransaction: {
+            Json::Value tx;
+            tx["id_account"] = u.accountA;
+            tx["id_category"] = u.categoryId;
+            tx["amount"] = "1.00";
+            tx["type"] = "income";
+            tx["description"] = "bench";
+            co_await timed(u, opts, "create_transaction", makeRequest(drogon::Post, "/transactions", u.token, &tx), start);
+            co_return;
+        }
+        case Scenario::CreateTransfer: {
+            // Направление чередуется, чтобы балансы не уходили в ноль
+            Json::Value tr;
+            tr["account_from"] = u.transferForward ? u.accountA : u.accountB;
+            tr["account_to"] = u.transferForward ? u.accountB : u.accountA;
+            tr["amount"] = "0.01";
+            u.transferForward = !u.transferForward;
+            co_await timed(u, opts, "create_transfer", makeRequest(drogon::Post, "/transfers", u.token, &tr), start);
+            co_return;
+        }
+        case Scenario::HotAccount: {
+            Json::Value tx;
+            tx["id_account"] = hotAccount.accountId;
+            tx["id_category"] = hotAccount.categoryId;
+            tx["amount"] = "1.00";
+            tx["type"] = "income";
+            tx["description"] = "bench";
+            co_await timed(u, opts, "hot_account", makeRequest(drogon::Post, "/transactions", hotAccount.token, &tx),
+                           start);
+            co_return;
+        }
+        case Scenario::ListTransactions: {
+            bool family = u.counter++ % 2 == 1;
+            co_await timed(u, opts, family ? "list_transactions_family" : "list_transactions",
+                           makeRequest(drogon::Get, family ? "/transactions?family=true" : "/transactions", u.token),
+                           start);
+            co_return;
+        }
+        case Scenario::BudgetPage: {
+            // Страница рендерится на сервере по cookie, как в браузере
+            auto req = makeRequest(drogon::Get, "/ui/budgets", "");
+            req->addCookie("token", u.token);
+            co_await timed(u, opts, "budget_page", req, start);
+            co_return;
+        }
+        case Scenario::Mixed:
+            break;
+    }
+}
+
+static drogon::AsyncTask runUser(VirtualUser &u,
+                                 const Options &opts,
+                                 trantor::EventLoop *loop,
+                                 Clock::time_point end,
+                                 std::atomic<size_t> &remaining,
+                                 std::promise<void> &finished) {
+    try {
+        co_await setup(u, opts);
+        const Scenario scenario = scenarioNames.at(opts.scenario);
+        // Каждое соединение даёт rps / connections запросов в секунду
+        const auto interval = opts.rps > 0
+                                  ? std::chrono::duration_cast<Clock::duration>(
+                                        std::chrono::duration<double>(opts.connections / opts.rps))
+                                  : Clock::duration::zero();
+        auto next = Clock::now();
+        while (Clock::now() < end) {
+            if (opts.rps > 0) {
+                auto wait = next - Clock::now();
+                if (wait > Clock::duration::zero()) {
+                    co_await drogon::sleepCoro(loop, std::chrono::duration<double>(wait).count());
+                }
+            }
+            auto start = opts.rps > 0 ? next : Clock::now();
+            co_await runStep(u, opts, scenario == Scenario::Mixed ? pickMixed(u) : scenario, start);
+            next += interval;
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "user " << u.index << ": " << e.what() << std::endl;
+        ++u.stats["setup"].errors;
+    }
+    if (remaining.fetch_sub(1) == 1) {
+        finished.set_value();
+    }
+}
+
+static Json::Value summarize(Series &s, double elapsedSec) {
+    Json::Value out;
+    auto &lat = s.latencyUs;
+    std::sort(lat.begin(), lat.end());
+    auto percentile = [&](double p) -> double {
+        if (lat.empty()) {
+            return 0;
+        }
+        size_t idx = std::min(lat.size() - 1, static_cast<size_t>(p * static_cast<double>(lat.size())));
+        return lat[idx] / 1000.0;
+    };
+    out["requests"] = Json::UInt64(lat.size());
+    out["errors"] = Json::UInt64(s.errors);
+    out["throughput_rps"] = elapsedSec > 0 ? static_cast<double>(lat.size()) / elapsedSec : 0.0;
+    Json::Value latency;
+    latency["p50"] = percentile(0.50);
+    latency["p90"] = percentile(0.90);
+    latency["p99"] = percentile(0.99);
+    latency["p999"] = percentile(0.999);
+    latency["max"] = lat.empty() ? 0.0 : lat.back() / 1000.0;
+    out["latency_ms"] = latency;
+    return out;
+}
+
+int main(int argc, char *argv[]) {
+    Options opts;
+    try {
+        opts = parseOptions(argc, argv);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\nusage: " << argv[0]
+                  << " [--url URL] [--connections N] [--rps R] [--duration SEC] [--threads N]"
+                     " [--timeout SEC] [--scenario auth|create_transaction|create_transfer|"
+                     "list_transactions|budget_page|hot_account|mixed] [--out FILE]"
+                  << std::endl;
+        return 2;
+    }
+
+    trantor::EventLoopThreadPool pool(opts.threads, "bench");
+    pool.start();
+
+    VirtualUser owner;
+    if (scenarioNames.at(opts.scenario) == Scenario::HotAccount) {
+        auto *loop = pool.getNextLoop();
+        owner.index = opts.connections;
+        owner.client = drogon::HttpClient::newHttpClient(opts.url, loop);
+        std::promise<std::string> ready;
+        auto setupDone = ready.get_future();
+        loop->queueInLoop([&owner, &opts, &ready] {
+            [](VirtualUser &owner, const Options &opts, std::promise<std::string> &ready) -> drogon::AsyncTask {
+                try {
+                    co_await setup(owner, opts);
+                    ready.set_value("");
+                } catch (const std::exception &e) {
+                    ready.set_value(e.what());
+                }
+            }(owner, opts, ready);
+        });
+        if (auto error = setupDone.get(); !error.empty()) {
+            std::cerr << "hot account setup: " << error << std::endl;
+            return 1;
+        }
+        hotAccount = {owner.token, owner.accountA, owner.categoryId};
+    }
+
+    std::vector<VirtualUser> users(opts.connections);
+    std::atomic<size_t> remaining{users.size()};
+    std::promise<void> finished;
+    auto done = finished.get_future();
+
+    const auto begin = Clock::now();
+    const auto end = begin + std::chrono::duration_cast<Clock::duration>(
+                                 std::chrono::duration<double>(opts.durationSec));
+    for (size_t i = 0; i < users.size(); ++i) {
+        auto *loop = pool.getNextLoop();
+        auto &u = users[i];
+        u.index = i;
+        u.rng.seed(static_cast<uint32_t>(i));
+        u.client = drogon::HttpClient::newHttpClient(opts.url, loop);
+        loop->queueInLoop([&u, &opts, loop, end, &remaining, &finished] {
+            runUser(u, opts, loop, end, remaining, finished);
+        });
+    }
+    done.wait();
+    const double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    // Сводим статистику всех пользователей
+    Stats merged;
+    for (auto &u : users) {
+        for (auto &[name, series] : u.stats) {
+            auto &m = merged[name];
+            m.latencyUs.insert(m.latencyUs.end(), series.latencyUs.begin(), series.latencyUs.end());
+            m.errors += series.errors;
+        }
+    }
+    Series total;
+    Json::Value report;
+    report["url"] = opts.url;
+    report["scenario"] = opts.scenario;
+    report["connections"] = Json::UInt64(opts.connections);
+    report["target_rps"] = opts.rps;
+    report["duration_sec"] = elapsed;
+    for (auto &[name, series] : merged) {
+        if (name != "setup") {
+            total.latencyUs.insert(total.latencyUs.end(), series.latencyUs.begin(), series.latencyUs.end());
+        }
+        total.errors += series.errors;
+        report["requests"][name] = summarize(series, elapsed);
+    }
+    report["total"] = summarize(total, elapsed);
+
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "  ";
+    const std::string json = Json::writeString(writer, report);
+    if (opts.out.empty()) {
+        std::cout << json << std::endl;
+    } else {
+        std::ofstream(opts.out) << json << std::endl;
+    }
+
+    for (auto &u : users) {
+        u.client.reset();
+    }
+    owner.client.reset();
+    return total.latencyUs.empty() ? 1 : 0;
+}
@@ -0,0 +1,577 @@
+// Генератор синтетических данных для нагрузочных тестов и проверки планов запросов.
+// Заливает пользователей, семьи, счета, категории, транзакции, переводы и бюджеты
+// через COPY. Один и тот же --seed даёт одни и те же данные.
+//
+//   ./bench/financial_manager_datagen --conninfo "host=127.0.0.1 dbname=financial_manager"
+//       --users 100000 --transactions 10000000 --transfers 1000000 --seed 42
+//
+// Пароль всех сгенерированных пользователей — --password (по умолчанию bench-password),
+// email — user<id>@datagen.local, так что под ними можно логиниться из financial_manager_bench.
+// Идентификаторы выдаются генератором, начиная с max(id) + 1 в каждой таблице, после
+// загрузки последовательности подтягиваются. Пользовательские триггеры (журнал /sync)
+// на время загрузки отключаются, если не указан --keep-triggers.
+#include <libpq-fe.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "utils/PasswordUtils.h"
+
+struct Options {
+    std::string conninfo;
+    uint64_t users = 1000;
+    // Вес размера очередной группы пользователей: k — семья из k человек, 1 — без семьи
+    std::map<int, double> familySizes = {{1, 0.55}, {2, 0.25}, {3, 0.12}, {4, 0.08}};
+    int accountsPerUser = 3;
+    int categoriesPerUser = 8;
+    uint64_t transactions = 100000;
+    uint64_t transfers = 10000;
+    int months = 12;
+    int budgetsPerMonth = 3;
+    std::string endDate = "2024-12-31";
+    std::string password = "bench-password";
+    uint64_t seed = 42;
+    bool truncate = false;
+    bool keepTriggers = false;
+};
+
+// splitmix64: свой генератор и свои преобразования, а не std::*_distribution,
+// чтобы данные совпадали между компиляторами и стандартными библиотеками
+class Rng {
+public:
+    explicit Rng(uint64_t seed) : state_(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // [0, n)
+    uint64_t below(uint64_t n) {
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(next()) * n) >> 64);
+    }
+
+    // [0, 1)
+    double unit() {
+        return static_cast<double>(next() >> 11) * 0x1.0p-53;
+    }
+
+    bool chance(double p) {
+        return unit() < p;
+    }
+
+    // Логнормальное распределение с заданной медианой
+    double lognormal(double median, double sigma) {
+        double u1 = std::max(unit(), 1e-12);
+        double u2 = unit();
+        double normal = std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * M_PI * u2);
+        return median * std::exp(sigma * normal);
+    }
+
+    template <typename T>
+    const T &pick(const std::vector<T> &v) {
+        return v[below(v.size())];
+    }
+
+private:
+    uint64_t state_;
+};
+
+static const std::vector<std::string> expenseCategories = {
+    "Продукты", "Транспорт", "Кафе и рестораны", "Здоровье", "Дом", "Развлечения",
+    "Одежда", "Связь", "Подписки", "Образование", "Подарки", "Путешествия"};
+static const std::vector<std::string> incomeCategories = {"Зарплата", "Подработка", "Кэшбэк", "Проценты"};
+static const std::map<std::string, std::vector<std::string>> descriptions = {
+    {"Продукты", {"Пятёрочка", "Перекрёсток", "Магнит", "ВкусВилл", "Рынок"}},
+    {"Транспорт", {"Метро", "Яндекс Такси", "Бензин", "Парковка", "Каршеринг"}},
+    {"Кафе и рестораны", {"Кофейня", "Обед", "Доставка еды", "Ужин с друзьями"}},
+    {"Здоровье", {"Аптека", "Стоматолог", "Анализы", "Спортзал"}},
+    {"Дом", {"ЖКХ", "Хозтовары", "Ремонт", "Интернет"}},
+    {"Развлечения", {"Кино", "Концерт", "Игры", "Книги"}},
+    {"Одежда", {"Обувь", "Куртка", "Маркетплейс"}},
+    {"Связь", {"Мобильная связь"}},
+    {"Подписки", {"Музыка", "Онлайн-кинотеатр", "Облако"}},
+    {"Образование", {"Курсы", "Репетитор", "Учебники"}},
+    {"Подарки", {"День рождения", "Цветы"}},
+    {"Путешествия", {"Авиабилеты", "Отель", "Поезд"}},
+    {"Зарплата", {"Зарплата", "Аванс", "Премия"}},
+    {"Подработка", {"Фриланс", "Консультация"}},
+    {"Кэшбэк", {"Кэшбэк за месяц"}},
+    {"Проценты", {"Проценты по вкладу"}}};
+static const std::vector<std::pair<const char *, const char *>> accountKinds = {
+    {"card", "Основная карта"}, {"card", "Кредитка"}, {"cash", "Наличные"},
+    {"deposit", "Вклад"}, {"card", "Зарплатная карта"}};
+
+static Options parseOptions(int argc, char *argv[]) {
+    Options o;
+    for (int i = 1; i < argc; ++i) {
+        std::string key = argv[i];
+        if (key == "--truncate") { o.truncate = true; continue; }
+        if (key == "--keep-triggers") { o.keepTriggers = true; continue; }
+        if (i + 1 >= argc) throw std::invalid_argument("missing value for " + key);
+        std::string value = argv[++i];
+        if (key == "--conninfo") o.conninfo = value;
+        else if (key == "--users") o.users = std::stoull(value);
+        else if (key == "--accounts-per-user") o.accountsPerUser = std::stoi(value);
+        else if (key == "--categories-per-user") o.categoriesPerUser = std::stoi(value);
+        else if (key == "--transactions") o.transactions = std::stoull(value);
+        else if (key == "--transfers") o.transfers = std::stoull(value);
+        else if (key == "--months") o.months = std::stoi(value);
+        else if (key == "--budgets-per-month") o.budgetsPerMonth = std::stoi(value);
+        else if (key == "--end-date") o.endDate = value;
+        else if (key == "--password") o.password = value;
+        else if (key == "--seed") o.seed = std::stoull(value);
+        else if (key == "--family-sizes") {
+            // "1:0.6,2:0.25,4:0.15"
+            o.familySizes.clear();
+            size_t pos = 0;
+            while (pos < value.size()) {
+                size_t comma = value.find(',', pos);
+                std::string item = value.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+                size_t colon = item.find(':');
+                if (colon == std::string::npos) throw std::invalid_argument("bad --family-sizes item " + item);
+                o.familySizes[std::stoi(item.substr(0, colon))] = std::stod(item.substr(colon + 1));
+                if (comma == std::string::npos) break;
+                pos = comma + 1;
+            }
+        }
+        else throw std::invalid_argument("unknown option " + key);
+    }
+    if (o.users == 0 || o.accountsPerUser < 1 || o.categoriesPerUser < 2 || o.months < 1) {
+        throw std::invalid_argument("users, accounts, categories (>= 2) and months must be positive");
+    }
+    return o;
+}
+
+class Db {
+public:
+    explicit Db(const std::string &conninfo) : conn_(PQconnectdb(conninfo.c_str())) {
+        if (PQstatus(conn_) != CONNECTION_OK) {
+            std::string err = PQerrorMessage(conn_);
+            PQfinish(conn_);
+            throw std::runtime_error("connection failed: " + err);
+        }
+    }
+    ~Db() { PQfinish(conn_); }
+
+    void exec(const std::string &sql) {
+        PGresult *res = PQexec(conn_, sql.c_str());
+        auto status = PQresultStatus(res);
+        std::string err = PQresultErrorMessage(res);
+        PQclear(res);
+        if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK) {
+            throw std::runtime_error(sql + ": " + err);
+        }
+    }
+
+    int64_t scalar(const std::string &sql) {
+        PGresult *res = PQexec(conn_, sql.c_str());
+        if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+            std::string err = PQresultErrorMessage(res);
+            PQclear(res);
+            throw std::runtime_error(sql + ": " + err);
+        }
+        int64_t v = PQgetisnull(res, 0, 0) ? 0 : std::stoll(PQgetvalue(res, 0, 0));
+        PQclear(res);
+        return v;
+    }
+
+    PGconn *conn() { return conn_; }
+
+private:
+    PGconn *conn_;
+};
+
+// COPY ... FROM STDIN в текстовом формате, строки копятся в буфер и уходят пачками
+class CopyWriter {
+public:
+    CopyWriter(Db &db, const std::string &table, const std::string &columns) : db_(db), table_(table) {
+        PGresult *res = PQexec(db_.conn(), ("COPY " + table + " (" + columns + ") FROM STDIN").c_str());
+        if (PQresultStatus(res) != PGRES_COPY_IN) {
+            std::string err = PQresultErrorMessage(res);
+            PQclear(res);
+            throw std::runtime_error("COPY " + table + ": " + err);
+        }
+        PQclear(res);
+    }
+
+    CopyWriter &field(const std::string &v) {
+        separator();
+        for (char c : v) {
+            switch (c) {
+                case '\\': buf_ += "\\\\"; break;
+                case '\t': buf_ += "\\t"; break;
+                case '\n': buf_ += "\\n"; break;
+                case '\r': buf_ += "\\r"; break;
+                default: buf_ += c;
+            }
+        }
+        return *this;
+    }
+    CopyWriter &field(const char *v) { return field(std::string(v)); }
+    CopyWriter &field(int64_t v) { separator(); buf_ += std::to_string(v); return *this; }
+    CopyWriter &field(bool v) { separator(); buf_ += v ? 't' : 'f'; return *this; }
+    CopyWriter &money(double v) {
+        separator();
+        char tmp[32];
+        std::snprintf(tmp, sizeof(tmp), "%.2f", v);
+        buf_ += tmp;
+        return *this;
+    }
+    CopyWriter &null() { separator(); buf_ += "\\N"; return *this; }
+
+    void endRow() {
+        buf_ += '\n';
+        first_ = true;
+        ++rows_;
+        if (buf_.size() >= (1 << 20)) {
+            flush();
+        }
+    }
+
+    uint64_t finish() {
+        flush();
+        if (PQputCopyEnd(db_.conn(), nullptr) != 1) {
+            throw std::runtime_error("COPY " + table_ + " end failed: " + PQerrorMessage(db_.conn()));
+        }
+        PGresult *res = PQgetResult(db_.conn());
+        auto status = PQresultStatus(res);
+        std::string err = PQresultErrorMessage(res);
+        PQclear(res);
+        while ((res = PQgetResult(db_.conn())) != nullptr) {
+            PQclear(res);
+        }
+        if (status != PGRES_COMMAND_OK) {
+            throw std::runtime_error("COPY " + table_ + ": " + err);
+        }
+        return rows_;
+    }
+
+private:
+    void separator() {
+        if (!first_) {
+            buf_ += '\t';
+        }
+        first_ = false;
+    }
+
+    void flush() {
+        if (!buf_.empty() && PQputCopyData(db_.conn(), buf_.data(), static_cast<int>(buf_.size())) != 1) {
+            throw std::runtime_error("COPY " + table_ + " failed: " + PQerrorMessage(db_.conn()));
+        }
+        buf_.clear();
+    }
+
+    Db &db_;
+    std::string table_;
+    std::string buf_;
+    bool first_ = true;
+    uint64_t rows_ = 0;
+};
+
+// Метки времени генерируются в секундах от начала эпохи (UTC) и пишутся как timestamp
+static std::string timestamp(int64_t epochSec) {
+    std::time_t t = static_cast<std::time_t>(epochSec);
+    std::tm tm{};
+    gmtime_r(&t, &tm);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm);
+    return buf;
+}
+
+static int64_t parseDate(const std::string &date) {
+    std::tm tm{};
+    if (!strptime(date.c_str(), "%Y-%m-%d", &tm)) {
+        throw std::invalid_argument("bad date " + date);
+    }
+    tm.tm_hour = 23;
+    tm.tm_min = 59;
+    tm.tm_sec = 59;
+    return static_cast<int64_t>(timegm(&tm));
+}
+
+struct AccountRef {
+    int64_t id;
+    bool family;
+};
+
+struct CategoryRef {
+    int64_t id;
+    std::string name;
+    bool income;
+    bool family;
+};
+
+struct UserData {
+    int64_t id;
+    int64_t family = 0;
+    double activity = 1;
+    std::vector<AccountRef> accounts;
+    std::vector<CategoryRef> categories;
+};
+
+int main(int argc, char *argv[]) {
+    Options opts;
+    try {
+        opts = parseOptions(argc, argv);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\nusage: " << argv[0]
+                  << " [--conninfo STR] [--users N] [--family-sizes 1:0.55,2:0.25,...]"
+                     " [--accounts-per-user N] [--categories-per-user N] [--transactions N]"
+                     " [--transfers N] [--months N] [--budgets-per-month N] [--end-date YYYY-MM-DD]"
+                     " [--password STR] [--seed N] [--truncate] [--keep-triggers]"
+                  << std::endl;
+        return 2;
+    }
+
+    try {
+        Db db(opts.conninfo);
+        Rng rng(opts.seed);
+        const int64_t end = parseDate(opts.endDate);
+        const int64_t begin = end - static_cast<int64_t>(opts.months) * 30 * 86400;
+        const std::vector<std::string> tables = {"users", "families", "family_members", "account",
+                                                 "category", "transactions", "transfer", "budgets"};
+
+        db.exec("BEGIN");
+        if (opts.truncate) {
+            db.exec("TRUNCATE users, families, family_members, family_invite, account, category, "
+                    "transactions, transfer, budgets RESTART IDENTITY CASCADE");
+        }
+        if (!opts.keepTriggers) {
+            for (const auto &t : tables) {
+                db.exec("ALTER TABLE " + t + " DISABLE TRIGGER USER");
+            }
+        }
+        std::map<std::string, int64_t> nextId;
+        for (const auto &t : tables) {
+            nextId[t] = db.scalar("SELECT COALESCE(MAX(id), 0) + 1 FROM " + t);
+        }
+
+        // Пользователи; activity — вес при выборе автора транзакции (немногие активны, многие нет)
+        const std::string hash = security::hashPassword(opts.password);
+        std::vector<UserData> users(opts.users);
+        {
+            CopyWriter copy(db, "users", "id, name, email, hashed_password, created_at");
+            for (auto &u : users) {
+                u.id = nextId["users"]++;
+                u.activity = rng.lognormal(1.0, 1.0);
+                copy.field(u.id).field("User " + std::to_string(u.id))
+                    .field("user" + std::to_string(u.id) + "@datagen.local").field(hash)
+                    .field(timestamp(begin - static_cast<int64_t>(rng.below(365 * 86400)))).endRow();
+            }
+            copy.finish();
+        }
+
+        // Семьи: пользователи идут подряд, размер следующей семьи — по --family-sizes
+        {
+            CopyWriter families(db, "families", "id, name, id_owner, created_at");
+            std::vector<std::pair<int64_t, int64_t>> members;
+            double total = 0;
+            for (const auto &entry : opts.familySizes) {
+                total += entry.second;
+            }
+            size_t i = 0;
+            while (i < users.size()) {
+                double roll = rng.unit() * total;
+                int size = 1;
+                for (const auto &[s, share] : opts.familySizes) {
+                    size = s;
+                    if ((roll -= share) < 0) {
+                        break;
+                    }
+                }
+                size = std::max(1, std::min<int>(size, static_cast<int>(users.size() - i)));
+                if (size > 1) {
+                    int64_t familyId = nextId["families"]++;
+                    families.field(familyId).field("Семья " + std::to_string(familyId)).field(users[i].id)
+                        .field(timestamp(begin)).endRow();
+                    for (int k = 0; k < size; ++k) {
+                        users[i + k].family = familyId;
+                        members.emplace_back(familyId, users[i + k].id);
+                    }
+                }
+                i += static_cast<size_t>(size);
+            }
+            families.finish();
+            CopyWriter copy(db, "family_members", "id, id_family, id_user, joined_at");
+            for (const auto &[familyId, userId] : members) {
+                copy.field(nextId["family_members"]++).field(familyId).field(userId).field(timestamp(begin)).endRow();
+            }
+            copy.finish();
+        }
+
+        // Счета и категории; у членов семьи часть из них семейные
+        {
+            CopyWriter accounts(db, "account", "id, id_user, account_type, account_name, balance, created_at, is_family");
+            for (auto &u : users) {
+                for (int k = 0; k < opts.accountsPerUser; ++k) {
+                    const auto &kind = accountKinds[static_cast<size_t>(k) % accountKinds.size()];
+                    bool family = u.family != 0 && k == opts.accountsPerUser - 1;
+                    AccountRef ref{nextId["account"]++, family};
+                    accounts.field(ref.id).field(u.id).field(kind.first).field(kind.second)
+                        .money(rng.lognormal(30000, 1.2)).field(timestamp(begin)).field(family).endRow();
+                    u.accounts.push_back(ref);
+                }
+            }
+            accounts.finish();
+
+            CopyWriter categories(db, "category", "id, id_user, name, type, is_family");
+            for (auto &u : users) {
+                const int incomes = std::max(1, opts.categoriesPerUser / 4);
+                for (int k = 0; k < opts.categoriesPerUser; ++k) {
+                    bool income = k < incomes;
+                    const auto &names = income ? incomeCategories : expenseCategories;
+                    size_t idx = static_cast<size_t>(income ? k : k - incomes);
+                    CategoryRef ref{nextId["category"]++, names[idx % names.size()], income,
+                                    u.family != 0 && !income && k >= opts.categoriesPerUser - 2};
+                    categories.field(ref.id).field(u.id).field(ref.name).field(income ? "income" : "expense")
+                        .field(ref.family).endRow();
+                    u.categories.push_back(ref);
+                }
+            }
+            categories.finish();
+        }
+
+        // Выбор пользователя с учётом activity: префиксные суммы + двоичный поиск
+        std::vector<double> cumulative(users.size());
+        double acc = 0;
+        for (size_t i = 0; i < users.size(); ++i) {
+            cumulative[i] = (acc += users[i].activity);
+        }
+        auto pickUser = [&]() -> UserData & {
+            auto it = std::lower_bound(cumulative.begin(), cumulative.end(), rng.unit() * acc);
+            return users[static_cast<size_t>(std::min<ptrdiff_t>(it - cumulative.begin(),
+                                                                 static_cast<ptrdiff_t>(users.size()) - 1))];
+        };
+        // Время операции: равномерно по дням окна, днём чаще, чем ночью
+        auto pickTime = [&]() -> int64_t {
+            int64_t day = begin + static_cast<int64_t>(rng.below(static_cast<uint64_t>((end - begin) / 86400))) * 86400;
+            int64_t hour = rng.chance(0.85) ? 8 + static_cast<int64_t>(rng.below(15)) : static_cast<int64_t>(rng.below(24));
+            return day - day % 86400 + hour * 3600 + static_cast<int64_t>(rng.below(3600));
+        };
+
+        {
+            CopyWriter copy(db, "transactions",
+                            "id, id_user, id_account, id_category, amount, type, description, created_at, is_family");
+            for (uint64_t n = 0; n < opts.transactions; ++n) {
+                auto &u = pickUser();
+                bool income = rng.chance(0.08);
+                std::vector<const CategoryRef *> fitting;
+                bool family = false;
+                for (const auto &c : u.categories) {
+                    if (c.income == income) {
+                        fitting.push_back(&c);
+                    }
+                }
+                const CategoryRef *cat = fitting.empty() ? nullptr : fitting[rng.below(fitting.size())];
+                family = cat && cat->family;
+                // Счёт того же режима (личный/семейный), что и категория
+                std::vector<int64_t> accountIds;
+                for (const auto &a : u.accounts) {
+                    if (a.family == family) {
+                        accountIds.push_back(a.id);
+                    }
+                }
+                if (accountIds.empty()) {
+                    family = false;
+                    cat = nullptr;
+                    for (const auto &a : u.accounts) {
+                        if (!a.family) {
+                            accountIds.push_back(a.id);
+                        }
+                    }
+                }
+                if (accountIds.empty()) {
+                    continue;
+                }
+                double amount = income ? rng.lognormal(55000, 0.5) : rng.lognormal(600, 1.1);
+                copy.field(nextId["transactions"]++).field(u.id).field(accountIds[rng.below(accountIds.size())]);
+                if (cat && rng.chance(0.95)) {
+                    copy.field(cat->id);
+                } else {
+                    copy.null();
+                }
+                copy.money(std::max(amount, 1.0)).field(income ? "income" : "expense");
+                auto d = cat ? descriptions.find(cat->name) : descriptions.end();
+                if (d != descriptions.end() && rng.chance(0.7)) {
+                    copy.field(rng.pick(d->second));
+                } else {
+                    copy.null();
+                }
+                copy.field(timestamp(pickTime())).field(family).endRow();
+            }
+            std::cerr << "transactions: " << copy.finish() << " rows" << std::endl;
+        }
+
+        {
+            CopyWriter copy(db, "transfer", "id, id_user, account_from, account_to, amount, created_at, is_family");
+            for (uint64_t n = 0; n < opts.transfers; ++n) {
+                auto &u = pickUser();
+                std::vector<int64_t> personal;
+                for (const auto &a : u.accounts) {
+                    if (!a.family) {
+                        personal.push_back(a.id);
+                    }
+                }
+                if (personal.size() < 2) {
+                    continue;
+                }
+                size_t from = rng.below(personal.size());
+                size_t to = (from + 1 + rng.below(personal.size() - 1)) % personal.size();
+                copy.field(nextId["transfer"]++).field(u.id).field(personal[from]).field(personal[to])
+                    .money(std::max(rng.lognormal(5000, 0.9), 1.0)).field(timestamp(pickTime())).field(false).endRow();
+            }
+            std::cerr << "transfers: " << copy.finish() << " rows" << std::endl;
+        }
+
+        // Бюджеты: на каждый месяц окна — лимиты по первым budgetsPerMonth расходным категориям
+        {
+            CopyWriter copy(db, "budgets", "id, id_user, id_category, month, year, limit_amount, created_at, is_family");
+            for (const auto &u : users) {
+                std::vector<const CategoryRef *> expenses;
+                for (const auto &c : u.categories) {
+                    if (!c.income && !c.family) {
+                        expenses.push_back(&c);
+                    }
+                }
+                for (int m = 0; m < opts.months; ++m) {
+                    std::time_t t = static_cast<std::time_t>(end - static_cast<int64_t>(m) * 30 * 86400);
+                    std::tm tm{};
+                    gmtime_r(&t, &tm);
+                    for (int k = 0; k < opts.budgetsPerMonth && k < static_cast<int>(expenses.size()); ++k) {
+                        copy.field(nextId["budgets"]++).field(u.id).field(expenses[static_cast<size_t>(k)]->id)
+                            .field(static_cast<int64_t>(tm.tm_mon + 1)).field(static_cast<int64_t>(tm.tm_year + 1900))
+                            .money(std::round(rng.lognormal(15000, 0.6) / 100) * 100)
+                            .field(timestamp(static_cast<int64_t>(t))).field(false).endRow();
+                    }
+                }
+            }
+            copy.finish();
+        }
+
+        for (const auto &t : tables) {
+            db.exec("SELECT setval(pg_get_serial_sequence('" + t + "', 'id'), " + std::to_string(nextId[t] - 1) +
+                    ", " + (nextId[t] > 1 ? "true" : "false") + ")");
+            if (!opts.keepTriggers) {
+                db.exec("ALTER TABLE " + t + " ENABLE TRIGGER USER");
+            }
+        }
+        db.exec("COMMIT");
+        for (const auto &t : tables) {
+            db.exec("ANALYZE " + t);
+        }
+        std::cerr << "done: " << users.size() << " users" << std::endl;
+    } catch (const std::exception &e) {
+        std::cerr << "datagen failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,265 @@
+// Стоимость обработчиков без базы данных: авторизация, разбор JSON, проверки,
+// работа мапперов и сериализация ответа. Вместо PostgreSQL — db::FakeDbClient,
+// поэтому время запроса к БД здесь — это поиск по таблице в памяти и один проход event loop.
+//
+//   ./bench/financial_manager_microbench --benchmark_filter=Controller
+#include <benchmark/benchmark.h>
+#include <drogon/HttpRequest.h>
+#include <drogon/HttpResponse.h>
+#include <drogon/utils/coroutine.h>
+#include <trantor/net/EventLoop.h>
+#include <trantor/utils/Logger.h>
+#include <jsoncpp/json/json.h>
+#include <set>
+#include <string>
+#include <vector>
+#include "controllers/TransactionsController.h"
+#include "controllers/TransferController.h"
+#include "db/DataBase.h"
+#include "db/FakeDbClient.h"
+#include "utils/CoroUtils.h"
+#include "utils/JwtUtils.h"
+
+using drogon::HttpRequestPtr;
+using drogon::HttpResponsePtr;
+
+static constexpr int64_t kUserId = 7;
+
+// Пользователь с двумя счетами и категориями обоих типов; счёт 1 не уходит в минус.
+// Он же владелец семьи с семейными счетами 3 и 4 и семейной категорией 3
+static std::shared_ptr<db::FakeDbClient> fakeDb() {
+    static auto client = [] {
+        trantor::Logger::setLogLevel(trantor::Logger::kWarn);
+        auto c = std::make_shared<db::FakeDbClient>();
+        c->addAppSchema();
+        const auto user = std::to_string(kUserId);
+        c->insert("users", {{"id", user}, {"name", "Bench"}, {"email", "bench@example.com"}, {"hashed_password", "x"}});
+        c->insert("account", {{"id", "1"}, {"id_user", user}, {"account_type", "card"},
+                              {"account_name", "Основная карта"}, {"balance", "1000000000000.00"}});
+        c->insert("account", {{"id", "2"}, {"id_user", user}, {"account_type", "cash"},
+                              {"account_name", "Наличные"}, {"balance", "0.00"}});
+        c->insert("category", {{"id", "1"}, {"id_user", user}, {"name", "Зарплата"}, {"type", "income"}});
+        c->insert("category", {{"id", "2"}, {"id_user", user}, {"name", "Продукты"}, {"type", "expense"}});
+        c->insert("families", {{"id", "1"}, {"name", "Bench"}, {"id_owner", user}});
+        c->insert("family_members", {{"id_family", "1"}, {"id_user", user}});
+        c->insert("account", {{"id", "3"}, {"id_user", user}, {"account_type", "card"},
+                              {"account_name", "Семейная карта"}, {"balance", "1000000000000.00"}, {"is_family", "t"}});
+        c->insert("account", {{"id", "4"}, {"id_user", user}, {"account_type", "cash"},
+                              {"account_name", "Семейные наличные"}, {"balance", "0.00"}, {"is_family", "t"}});
+        c->insert("category", {{"id", "3"}, {"id_user", user}, {"name", "Семейный доход"}, {"type", "income"},
+                               {"is_family", "t"}});
+        db::setDbClientOverride(c);
+        return c;
+    }();
+    return client;
+}
+
+template <typename T>
+static drogon::AsyncTask awaitResult(drogon::Task<T> task, T &result, bool &done, const bool &waiting,
+                                     trantor::EventLoop &loop) {
+    result = co_await std::move(task);
+    done = true;
+    if (waiting) {
+        loop.quit();
+    }
+}
+
+// Обработчик выполняется в event loop потока бенчмарка: FakeDbClient возвращает результаты
+// в тот же цикл, как настоящий клиент в IO-потоке
+template <typename T>
+static T runOnLoop(drogon::Task<T> task) {
+    static trantor::EventLoop loop;
+    T result{};
+    bool done = false;
+    bool waiting = false;
+    awaitResult(std::move(task), result, done, waiting, loop);
+    if (!done) {
+        waiting = true;
+        loop.loop();
+    }
+    return result;
+}
+
+static HttpResponsePtr runHandler(drogon::Task<HttpResponsePtr> task) {
+    return runOnLoop(std::move(task));
+}
+
+static HttpRequestPtr jsonRequest(const Json::Value &body, bool authorized = true) {
+    auto req = drogon::HttpRequest::newHttpJsonRequest(body);
+    if (authorized) {
+        req->addHeader("Authorization", "Bearer " + jwt_utils::createToken(kUserId, "bench@example.com"));
+    }
+    return req;
+}
+
+static bool checkStatus(benchmark::State &state, const HttpResponsePtr &resp, drogon::HttpStatusCode expected) {
+    if (!resp || resp->statusCode() != expected) {
+        state.SkipWithError(("unexpected response: " + (resp ? std::string(resp->body()) : std::string("none"))).c_str());
+        return false;
+    }
+    return true;
+}
+
+static void BM_ControllerUnauthorized(benchmark::State &state) {
+    fakeDb();
+    finance::TransactionsController ctrl;
+    Json::Value body;
+    body["id_account"] = 1;
+    body["amount"] = "10.00";
+    body["type"] = "income";
+    auto req = jsonRequest(body, false);
+    for (auto _ : state) {
+        auto resp = runHandler(ctrl.createTransaction(req));
+        if (!checkStatus(state, resp, drogon::k401Unauthorized)) {
+            break;
+        }
+    }
+}
+BENCHMARK(BM_ControllerUnauthorized);
+
+static void BM_ControllerCreateTransaction(benchmark::State &state) {
+    auto client = fakeDb();
+    finance::TransactionsController ctrl;
+    Json::Value body;
+    body["id_account"] = 1;
+    body["id_category"] = 1;
+    body["amount"] = "10.00";
+    body["type"] = "income";
+    body["description"] = "Зарплата";
+    auto req = jsonRequest(body);
+    const auto before = client->statementCount();
+    for (auto _ : state) {
+        auto resp = runHandler(ctrl.createTransaction(req));
+        if (!checkStatus(state, resp, drogon::k201Created)) {
+            break;
+        }
+    }
+    state.counters["queries"] = benchmark::Counter(static_cast<double>(client->statementCount() - before),
+                                                   benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_ControllerCreateTransaction);
+
+// range(0) одновременных POST /transactions на один счёт. Записи, пришедшие, пока пишется
+// пакет, уходят следующим пакетом (db/GroupCommit.h): запросов к БД на одну транзакцию
+// становится меньше с ростом числа одновременных записей
+static void BM_ControllerCreateTransactionHotAccount(benchmark::State &state) {
+    auto client = fakeDb();
+    finance::TransactionsController ctrl;
+    Json::Value body;
+    body["id_account"] = 1;
+    body["id_category"] = 1;
+    body["amount"] = "10.00";
+    body["type"] = "income";
+    body["description"] = "Зарплата";
+    auto req = jsonRequest(body);
+    const auto concurrent = static_cast<size_t>(state.range(0));
+    const auto before = client->statementCount();
+    for (auto _ : state) {
+        std::vector<drogon::Task<HttpResponsePtr>> tasks;
+        for (size_t i = 0; i < concurrent; ++i) {
+            tasks.push_back(ctrl.createTransaction(req));
+        }
+        bool ok = true;
+        for (const auto &resp : runOnLoop(coro::when_all(std::move(tasks)))) {
+            ok = ok && checkStatus(state, resp, drogon::k201Created);
+        }
+        if (!ok) {
+            break;
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * concurrent));
+    state.counters["queries"] =
+        benchmark::Counter(static_cast<double>(client->statementCount() - before) / static_cast<double>(concurrent),
+                           benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_ControllerCreateTransactionHotAccount)->Arg(1)->Arg(8)->Arg(64);
+
+static void BM_ControllerCreateTransfer(benchmark::State &state) {
+    auto client = fakeDb();
+    finance::TransferController ctrl;
+    Json::Value body;
+    body["account_from"] = 1;
+    body["account_to"] = 2;
+    body["amount"] = "1.00";
+    auto req = jsonRequest(body);
+    const auto before = client->statementCount();
+    for (auto _ : state) {
+        auto resp = runHandler(ctrl.CreateTransfer(req));
+        if (!checkStatus(state, resp, drogon::k201Created)) {
+            break;
+        }
+    }
+    state.counters["queries"] = benchmark::Counter(static_cast<double>(client->statementCount() - before),
+                                                   benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_ControllerCreateTransfer);
+
+// Семейная запись: членство и семейный счёт проверяет актор семьи (db/FamilyActors.h),
+// после первой итерации — без запросов к БД
+static void BM_ControllerCreateFamilyTransaction(benchmark::State &state) {
+    auto client = fakeDb();
+    finance::TransactionsController ctrl;
+    Json::Value body;
+    body["id_account"] = 3;
+    body["id_category"] = 3;
+    body["amount"] = "10.00";
+    body["type"] = "income";
+    auto req = jsonRequest(body);
+    req->setParameter("family", "true");
+    const auto before = client->statementCount();
+    for (auto _ : state) {
+        auto resp = runHandler(ctrl.createTransaction(req));
+        if (!checkStatus(state, resp, drogon::k201Created)) {
+            break;
+        }
+    }
+    state.counters["queries"] = benchmark::Counter(static_cast<double>(client->statementCount() - before),
+                                                   benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_ControllerCreateFamilyTransaction);
+
+static void BM_ControllerCreateFamilyTransfer(benchmark::State &state) {
+    auto client = fakeDb();
+    finance::TransferController ctrl;
+    Json::Value body;
+    body["account_from"] = 3;
+    body["account_to"] = 4;
+    body["amount"] = "1.00";
+    auto req = jsonRequest(body);
+    req->setParameter("family", "true");
+    const auto before = client->statementCount();
+    for (auto _ : state) {
+        auto resp = runHandler(ctrl.CreateTransfer(req));
+        if (!checkStatus(state, resp, drogon::k201Created)) {
+            break;
+        }
+    }
+    state.counters["queries"] = benchmark::Counter(static_cast<double>(client->statementCount() - before),
+                                                   benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_ControllerCreateFamilyTransfer);
+
+// GET /transactions для пользователя с range(0) транзакциями
+static void BM_ControllerGetTransactions(benchmark::State &state) {
+    auto client = fakeDb();
+    static std::set<int64_t> seeded;
+    const int64_t rows = state.range(0);
+    const int64_t userId = 1000 + rows;
+    if (seeded.insert(userId).second) {
+        for (int64_t i = 0; i < rows; ++i) {
+            client->insert("transactions", {{"id_user", std::to_string(userId)}, {"id_account", "1"},
+                                            {"id_category", "2"}, {"amount", "349.90"}, {"type", "expense"},
+                                            {"description", "Супермаркет у дома"}});
+        }
+    }
+    finance::TransactionsController ctrl;
+    auto req = drogon::HttpRequest::newHttpRequest();
+    req->addHeader("Authorization", "Bearer " + jwt_utils::createToken(userId, "bench@example.com"));
+    for (auto _ : state) {
+        auto resp = runHandler(ctrl.GetTransactions(req));
+        if (!checkStatus(state, resp, drogon::k200OK)) {
+            break;
+        }
+    }
+}
+BENCHMARK(BM_ControllerGetTransactions)->Arg(10)->Arg(100)->Arg(1000);
@@ -0,0 +1,234 @@
+// Микробенчмарки кода, который выполняется почти на каждом запросе: JWT, пароли,
+// суммы, toJson() моделей с сериализацией и сборка HTML страниц.
+//
+//   ./bench/financial_manager_microbench --benchmark_format=json > micro.json
+//
+// Бенчмарки идут не в IO-потоке drogon, поэтому кеш проверенных токенов
+// (utils/LoopCache.h) здесь не участвует: getUserIdFromRequest меряется с полной проверкой.
+#include <benchmark/benchmark.h>
+#include <drogon/HttpRequest.h>
+#include <jsoncpp/json/json.h>
+#include <string>
+#include "utils/AmountUtils.h"
+#include "utils/JwtUtils.h"
+#include "utils/PageRender.h"
+#include "utils/PasswordUtils.h"
+#include "models/Account.h"
+#include "models/Budgets.h"
+#include "models/Category.h"
+#include "models/Transactions.h"
+#include "models/Transfer.h"
+#include "models/Users.h"
+
+using namespace drogon_model::financial_manager;
+
+static void BM_CreateToken(benchmark::State &state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(jwt_utils::createToken(42, "user@example.com"));
+    }
+}
+BENCHMARK(BM_CreateToken);
+
+static void BM_GetUserIdFromRequest(benchmark::State &state) {
+    auto req = drogon::HttpRequest::newHttpRequest();
+    req->addHeader("Authorization", "Bearer " + jwt_utils::createToken(42, "user@example.com"));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(jwt_utils::getUserIdFromRequest(req));
+    }
+}
+BENCHMARK(BM_GetUserIdFromRequest);
+
+static void BM_HashPassword(benchmark::State &state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(security::hashPassword("correct horse battery staple"));
+    }
+}
+BENCHMARK(BM_HashPassword)->Unit(benchmark::kMillisecond);
+
+static void BM_VerifyPassword(benchmark::State &state) {
+    const auto hash = security::hashPassword("correct horse battery staple");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(security::verifyPassword("correct horse battery staple", hash));
+    }
+}
+BENCHMARK(BM_VerifyPassword)->Unit(benchmark::kMillisecond);
+
+static void BM_BytesToHex(benchmark::State &state) {
+    unsigned char bytes[32];
+    for (int i = 0; i < 32; ++i) {
+        bytes[i] = static_cast<unsigned char>(i * 7);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(security::bytesToHex(bytes, sizeof(bytes)));
+    }
+}
+BENCHMARK(BM_BytesToHex);
+
+static void BM_ParseAmount(benchmark::State &state) {
+    const std::string amount = "123456.78";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(amount_utils::parseAmount(amount));
+    }
+}
+BENCHMARK(BM_ParseAmount);
+
+static void BM_AmountToString(benchmark::State &state) {
+    double amount = 123456.78;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(amount_utils::amountToString(amount));
+    }
+}
+BENCHMARK(BM_AmountToString);
+
+// Типичные строки таблиц в том виде, в каком их отдаёт API
+static Json::Value accountJson(int id) {
+    Json::Value v;
+    v["id"] = id;
+    v["id_user"] = 7;
+    v["account_type"] = "card";
+    v["account_name"] = "Основная карта";
+    v["balance"] = "15234.50";
+    v["created_at"] = "2024-05-01 13:45:00";
+    v["is_family"] = false;
+    return v;
+}
+
+static Json::Value categoryJson(int id) {
+    Json::Value v;
+    v["id"] = id;
+    v["id_user"] = 7;
+    v["name"] = "Продукты";
+    v["type"] = "expense";
+    v["is_family"] = false;
+    return v;
+}
+
+static Json::Value transactionJson(int id) {
+    Json::Value v;
+    v["id"] = id;
+    v["id_user"] = 7;
+    v["id_account"] = 1;
+    v["id_category"] = 1;
+    v["amount"] = "349.90";
+    v["type"] = "expense";
+    v["description"] = "Супермаркет у дома";
+    v["created_at"] = "2024-05-01 13:45:00";
+    v["is_family"] = false;
+    return v;
+}
+
+static Json::Value transferJson(int id) {
+    Json::Value v;
+    v["id"] = id;
+    v["id_user"] = 7;
+    v["account_from"] = 1;
+    v["account_to"] = 2;
+    v["amount"] = "1000.00";
+    v["created_at"] = "2024-05-01 13:45:00";
+    v["is_family"] = false;
+    return v;
+}
+
+static Json::Value budgetJson(int id) {
+    Json::Value v;
+    v["id"] = id;
+    v["id_user"] = 7;
+    v["id_category"] = 1;
+    v["month"] = 5;
+    v["year"] = 2024;
+    v["limit_amount"] = "20000.00";
+    v["created_at"] = "2024-05-01 13:45:00";
+    v["is_family"] = false;
+    return v;
+}
+
+static Json::Value userJson(int id) {
+    Json::Value v;
+    v["id"] = id;
+    v["name"] = "Иван";
+    v["email"] = "ivan@example.com";
+    v["hashed_password"] = security::hashPassword("secret");
+    v["created_at"] = "2024-05-01 13:45:00";
+    return v;
+}
+
+// toJson() модели и сериализация в строку тем же способом, что и newHttpJsonResponse
+template <typename Model>
+static void modelToJson(benchmark::State &state, const Json::Value &sample) {
+    const Model model(sample);
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Json::writeString(builder, model.toJson()));
+    }
+}
+
+static void BM_AccountToJson(benchmark::State &state) { modelToJson<Account>(state, accountJson(1)); }
+static void BM_BudgetsToJson(benchmark::State &state) { modelToJson<Budgets>(state, budgetJson(1)); }
+static void BM_CategoryToJson(benchmark::State &state) { modelToJson<Category>(state, categoryJson(1)); }
+static void BM_TransactionsToJson(benchmark::State &state) { modelToJson<Transactions>(state, transactionJson(1)); }
+static void BM_TransferToJson(benchmark::State &state) { modelToJson<Transfer>(state, transferJson(1)); }
+static void BM_UsersToJson(benchmark::State &state) { modelToJson<Users>(state, userJson(1)); }
+BENCHMARK(BM_AccountToJson);
+BENCHMARK(BM_BudgetsToJson);
+BENCHMARK(BM_CategoryToJson);
+BENCHMARK(BM_TransactionsToJson);
+BENCHMARK(BM_TransferToJson);
+BENCHMARK(BM_UsersToJson);
+
+// Стартовые данные страницы: range(0) строк в каждом списке
+static Json::Value pageData(int rows) {
+    Json::Value data;
+    for (const char *key : {"accounts", "categories", "transactions", "transfers", "budgets"}) {
+        data[key] = Json::Value(Json::arrayValue);
+    }
+    for (int i = 1; i <= rows; ++i) {
+        data["accounts"].append(accountJson(i));
+        data["categories"].append(categoryJson(i));
+        data["transactions"].append(transactionJson(i));
+        data["transfers"].append(transferJson(i));
+        data["budgets"].append(budgetJson(i));
+    }
+    return data;
+}
+
+static void BM_RenderShell(benchmark::State &state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pages::renderTransactionsPage(false, nullptr));
+    }
+}
+BENCHMARK(BM_RenderShell);
+
+static void BM_RenderCategoriesPage(benchmark::State &state) {
+    const auto data = pageData(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pages::renderCategoriesPage(false, &data));
+    }
+}
+BENCHMARK(BM_RenderCategoriesPage)->Arg(10)->Arg(100);
+
+static void BM_RenderTransactionsPage(benchmark::State &state) {
+    const auto data = pageData(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pages::renderTransactionsPage(false, &data));
+    }
+}
+BENCHMARK(BM_RenderTransactionsPage)->Arg(10)->Arg(100)->Arg(1000);
+
+static void BM_RenderTransfersPage(benchmark::State &state) {
+    const auto data = pageData(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pages::renderTransfersPage(false, &data));
+    }
+}
+BENCHMARK(BM_RenderTransfersPage)->Arg(10)->Arg(100);
+
+static void BM_RenderBudgetsPage(benchmark::State &state) {
+    const auto data = pageData(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pages::renderBudgetsPage(false, &data));
+    }
+}
+BENCHMARK(BM_RenderBudgetsPage)->Arg(10)->Arg(100);
+
+BENCHMARK_MAIN();
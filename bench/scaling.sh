@@ -0,0 +1,95 @@
+#!/usr/bin/env bash
+# Масштабирование по числу IO-потоков: запускает сервер с FM_IO_THREADS = 1, 2, 4, 8
+# и меряет requests/sec через wrk на эндпоинтах, которые упираются в CPU сервера
+# (JWT, JSON, кеши списков), а не в Postgres.
+#
+#   cd build && ../bench/scaling.sh            # по умолчанию ./financial_manager
+#   SERVER=./financial_manager LOOPS="1 2 4" DURATION=30s ../bench/scaling.sh
+#
+# Нужны wrk и curl, запущенный Postgres из config.json. wrk лучше держать на других
+# ядрах, чем сервер: задайте SERVER_CPUS / WRK_CPUS (списки для taskset), например
+# SERVER_CPUS=0-7 WRK_CPUS=8-15.
+set -euo pipefail
+
+SERVER_PID=""
+
+SERVER=${SERVER:-./financial_manager}
+HOST=${HOST:-127.0.0.1:9000}
+LOOPS=${LOOPS:-"1 2 4 8"}
+DURATION=${DURATION:-15s}
+CONNECTIONS=${CONNECTIONS:-128}
+WRK_THREADS=${WRK_THREADS:-4}
+ENDPOINTS=${ENDPOINTS:-"/api/bootstrap /accounts /categories /api/auth/profile"}
+
+pin() {
+    local cpus=$1
+    shift
+    if [[ -n "$cpus" ]]; then
+        taskset -c "$cpus" "$@"
+    else
+        "$@"
+    fi
+}
+
+wait_for_port() {
+    for _ in $(seq 1 50); do
+        if curl -s -o /dev/null "http://$HOST/auth/login"; then
+            return 0
+        fi
+        sleep 0.1
+    done
+    echo "server did not start on $HOST" >&2
+    return 1
+}
+
+start_server() {
+    FM_IO_THREADS=$1 pin "${SERVER_CPUS:-}" "$SERVER" >/dev/null 2>&1 &
+    SERVER_PID=$!
+    wait_for_port
+}
+
+stop_server() {
+    kill -TERM "$SERVER_PID" 2>/dev/null || true
+    wait "$SERVER_PID" 2>/dev/null || true
+}
+trap stop_server EXIT
+
+# Пользователь для бенчмарка: регистрируем (если уже есть — просто логинимся)
+EMAIL=${EMAIL:-bench@example.com}
+PASSWORD=${PASSWORD:-bench-password}
+start_server 1
+curl -s -o /dev/null -H 'Content-Type: application/json' \
+    -d "{\"name\":\"bench\",\"email\":\"$EMAIL\",\"password\":\"$PASSWORD\"}" \
+    "http://$HOST/api/auth/register" || true
+TOKEN=$(curl -s -H 'Content-Type: application/json' \
+    -d "{\"email\":\"$EMAIL\",\"password\":\"$PASSWORD\"}" \
+    "http://$HOST/api/auth/login" | sed -n 's/.*"token"[[:space:]]*:[[:space:]]*"\([^"]*\)".*/\1/p')
+stop_server
+if [[ -z "$TOKEN" ]]; then
+    echo "login failed" >&2
+    exit 1
+fi
+
+printf '%-22s' "endpoint \\ loops"
+for n in $LOOPS; do printf '%12s' "$n"; done
+printf '\n'
+
+declare -A RPS
+for n in $LOOPS; do
+    start_server "$n"
+    for ep in $ENDPOINTS; do
+        # Прогрев: заполняем шарды кешей всех потоков
+        pin "${WRK_CPUS:-}" wrk -t"$WRK_THREADS" -c"$CONNECTIONS" -d2s \
+            -H "Authorization: Bearer $TOKEN" "http://$HOST$ep" >/dev/null
+        RPS[$ep,$n]=$(pin "${WRK_CPUS:-}" wrk -t"$WRK_THREADS" -c"$CONNECTIONS" -d"$DURATION" \
+            -H "Authorization: Bearer $TOKEN" "http://$HOST$ep" |
+            awk '/Requests\/sec/ {print $2}')
+    done
+    stop_server
+done
+
+for ep in $ENDPOINTS; do
+    printf '%-22s' "$ep"
+    for n in $LOOPS; do printf '%12s' "${RPS[$ep,$n]}"; done
+    printf '\n'
+done
@@ -0,0 +1,56 @@
+# Копирует static/ в каталог сборки с хешем содержимого в имени файла,
+# рядом кладёт .gz (и .br, если найден brotli) и генерирует StaticAssets.h
+# с путями вида /static/css/app.<hash>.css.
+#
+# Запуск: cmake -DSRC_DIR=... -DOUT_DIR=... -DHEADER=... [-DBROTLI=...] -P FingerprintAssets.cmake
+
+file(GLOB_RECURSE ASSETS RELATIVE ${SRC_DIR}/static
+     ${SRC_DIR}/static/*.css ${SRC_DIR}/static/*.js)
+list(SORT ASSETS)
+
+file(REMOVE_RECURSE ${OUT_DIR}/static)
+
+set(content "// Сгенерировано cmake/FingerprintAssets.cmake, не редактировать.\n")
+string(APPEND content "#pragma once\n\nnamespace assets {\n")
+
+foreach(rel ${ASSETS})
+    set(src ${SRC_DIR}/static/${rel})
+    file(SHA256 ${src} digest)
+    string(SUBSTRING ${digest} 0 10 digest)
+
+    get_filename_component(dir ${rel} DIRECTORY)
+    get_filename_component(name ${rel} NAME_WE)
+    get_filename_component(ext ${rel} EXT)
+    if(dir)
+        set(hashed ${dir}/${name}.${digest}${ext})
+    else()
+        set(hashed ${name}.${digest}${ext})
+    endif()
+
+    set(dst ${OUT_DIR}/static/${hashed})
+    configure_file(${src} ${dst} COPYONLY)
+    execute_process(COMMAND gzip -9 -n -c ${dst}
+                    OUTPUT_FILE ${dst}.gz
+                    RESULT_VARIABLE rc)
+    if(NOT rc EQUAL 0)
+        message(FATAL_ERROR "gzip failed for ${rel}")
+    endif()
+    if(BROTLI)
+        execute_process(COMMAND ${BROTLI} -q 11 -f -o ${dst}.br ${dst}
+                        RESULT_VARIABLE rc)
+        if(NOT rc EQUAL 0)
+            message(FATAL_ERROR "brotli failed for ${rel}")
+        endif()
+    endif()
+
+    string(MAKE_C_IDENTIFIER ${rel} ident)
+    string(APPEND content
+           "inline constexpr const char ${ident}[] = \"/static/${hashed}\";\n")
+endforeach()
+
+string(APPEND content "}\n")
+
+# Перезаписываем заголовок только при изменении, чтобы не пересобирать контроллеры зря
+file(WRITE ${HEADER}.tmp "${content}")
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different ${HEADER}.tmp ${HEADER})
+file(REMOVE ${HEADER}.tmp)
@@ -0,0 +1,93 @@
+#include "AdminController.h"
+#include <drogon/HttpClient.h>
+#include <drogon/HttpResponse.h>
+#include <jsoncpp/json/json.h>
+#include "utils/AsyncLog.h"
+#include "utils/Prefork.h"
+
+using namespace finance;
+using drogon::HttpRequestPtr;
+using drogon::HttpResponsePtr;
+using drogon::Task;
+
+// Ручки обслуживаются только на loopback-листенере процесса: адрес клиента не проверяем,
+// за локальным reverse proxy loopback-ом выглядит любой клиент основного порта.
+// Без листенера (обычный режим без local_listener) ручки недоступны
+static bool onLocalListener(const HttpRequestPtr &req) {
+    return prefork::hasLocalListener() && req->localAddr().isLoopbackIp() &&
+           req->localAddr().toPort() == prefork::localPort();
+}
+
+static HttpResponsePtr notFound() {
+    auto resp = drogon::HttpResponse::newHttpResponse();
+    resp->setStatusCode(drogon::k404NotFound);
+    return resp;
+}
+
+static HttpResponsePtr levelResponse() {
+    Json::Value result;
+    result["level"] = asynclog::logLevel();
+    auto resp = drogon::HttpResponse::newHttpJsonResponse(result);
+    resp->setStatusCode(drogon::k200OK);
+    return resp;
+}
+
+// Передаёт уровень рабочему процессу; ошибки только логируются — процесс мог перезапускаться
+static Task<> forwardLevel(uint16_t port, std::string level) {
+    try {
+        auto client = drogon::HttpClient::newHttpClient(
+            "127.0.0.1", port, false, trantor::EventLoop::getEventLoopOfCurrentThread());
+        auto req = drogon::HttpRequest::newHttpRequest();
+        req->setMethod(drogon::Put);
+        req->setPath("/admin/log-level");
+        req->setParameter("level", level);
+        req->setParameter("local", "1");
+        co_await client->sendRequestCoro(req, 2);
+    } catch (const std::exception &e) {
+        LOG_WARN << "Log level forward to port " << port << " failed: " << e.what();
+    }
+}
+
+Task<HttpResponsePtr> AdminController::GetLogLevel(HttpRequestPtr req) {
+    if (!onLocalListener(req)) {
+        co_return notFound();
+    }
+    co_return levelResponse();
+}
+
+Task<HttpResponsePtr> AdminController::SetLogLevel(HttpRequestPtr req) {
+    if (!onLocalListener(req)) {
+        co_return notFound();
+    }
+    try {
+        auto level = req->getParameter("level");
+        if (level.empty()) {
+            if (auto json = req->getJsonObject()) {
+                level = (*json).get("level", "").asString();
+            }
+        }
+        if (!asynclog::setLogLevel(level)) {
+            auto resp = drogon::HttpResponse::newHttpResponse();
+            resp->setStatusCode(drogon::k400BadRequest);
+            resp->setBody("Invalid level. Must be one of TRACE, DEBUG, INFO, WARN, ERROR, FATAL");
+            co_return resp;
+        }
+        LOG_WARN << "Log level set to " << asynclog::logLevel();
+
+        const auto &options = prefork::options();
+        if (options.workers > 0 && req->getParameter("local") != "1") {
+            for (size_t i = 0; i < options.workers; ++i) {
+                if (i != prefork::workerIndex()) {
+                    co_await forwardLevel(static_cast<uint16_t>(options.metricsPortBase + i), level);
+                }
+            }
+        }
+        co_return levelResponse();
+    } catch (const std::exception &e) {
+        LOG_ERROR << "SetLogLevel error: " << e.what();
+        auto resp = drogon::HttpResponse::newHttpResponse();
+        resp->setStatusCode(drogon::k500InternalServerError);
+        resp->setBody("Internal server error");
+        co_return resp;
+    }
+}
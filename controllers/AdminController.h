@@ -0,0 +1,24 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+#include <drogon/HttpBinder.h>
+
+namespace finance {
+
+// Служебные ручки, доступные только на loopback-листенере процесса (prefork::localPort()),
+// на основном порту отвечают 404.
+// GET /admin/log-level — текущий уровень логирования, PUT /admin/log-level?level=INFO — смена
+// без перезапуска. В prefork-режиме смена рассылается всем рабочим процессам через их
+// loopback-порты (с local=1, чтобы процесс не рассылал её дальше)
+class AdminController : public drogon::HttpController<AdminController> {
+public:
+    METHOD_LIST_BEGIN
+        ADD_METHOD_TO(AdminController::GetLogLevel, "/admin/log-level", drogon::Get);
+        ADD_METHOD_TO(AdminController::SetLogLevel, "/admin/log-level", drogon::Put);
+    METHOD_LIST_END
+
+    drogon::Task<drogon::HttpResponsePtr> GetLogLevel(drogon::HttpRequestPtr req);
+    drogon::Task<drogon::HttpResponsePtr> SetLogLevel(drogon::HttpRequestPtr req);
+};
+
+}
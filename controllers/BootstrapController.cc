@@ -0,0 +1,102 @@
+#include "BootstrapController.h"
+#include <drogon/HttpResponse.h>
+#include <drogon/HttpAppFramework.h>
+#include <jsoncpp/json/json.h>
+#include "utils/JwtUtils.h"
+#include "db/DataBase.h"
+#include "utils/Profiling.h"
+#include "utils/CoroUtils.h"
+#include "db/ListQueries.h"
+
+using namespace finance;
+using drogon::HttpRequestPtr;
+using drogon::HttpResponsePtr;
+using drogon::Task;
+
+// Стартовые данные страницы одним ответом: семья, приглашения, счета и категории.
+// Запросы независимы и уходят в пул одновременно.
+Task<HttpResponsePtr> BootstrapController::GetBootstrap(HttpRequestPtr req) {
+    try {
+        auto userIdOpt = jwt_utils::getUserIdFromRequest(req);
+        if (!userIdOpt) {
+            auto resp = drogon::HttpResponse::newHttpResponse();
+            resp->setStatusCode(drogon::k401Unauthorized);
+            resp->setBody("Unauthorized");
+            co_return resp;
+        }
+
+        auto db = db::getReadDbClient(req);
+        int64_t userId = *userIdOpt;
+        bool familyView = req->getParameter("family") == "true";
+
+        auto familyTask = coro::query(db,
+            R"(
+            /*bootstrap_family_v1*/
+            SELECT f.id, f.name, f.id_owner, f.created_at
+            FROM families f
+            JOIN family_members fm ON f.id = fm.id_family
+            WHERE fm.id_user = $1::int8
+            )", userId
+        );
+        auto invitesTask = coro::query(db,
+            R"(
+            /*bootstrap_invites_v1*/
+            SELECT fi.id, fi.id_family, fi.email, fi.created_at, fi.token,
+                   f.name AS family_name, u.name AS inviter_name
+            FROM family_invite fi
+            JOIN families f ON fi.id_family = f.id
+            JOIN users u ON fi.inviter_id = u.id
+            WHERE fi.email = (SELECT email FROM users WHERE id = $1::int8)
+              AND fi.used_at IS NULL
+            ORDER BY fi.created_at DESC
+            )", userId
+        );
+        auto accountsTask = db::accountsJson(db, userId, familyView);
+        auto categoriesTask = db::categoriesJson(db, userId, familyView);
+
+        auto [family, invites, accounts, categories] = co_await coro::when_all(
+            std::move(familyTask), std::move(invitesTask),
+            std::move(accountsTask), std::move(categoriesTask));
+
+        Json::Value result;
+
+        if (family.empty()) {
+            result["family"] = Json::Value(Json::nullValue);
+        } else {
+            Json::Value f;
+            f["id"] = (Json::Int64)family[0]["id"].as<int64_t>();
+            f["name"] = family[0]["name"].as<std::string>();
+            f["id_owner"] = (Json::Int64)family[0]["id_owner"].as<int64_t>();
+            f["created_at"] = family[0]["created_at"].as<std::string>();
+            f["is_owner"] = (family[0]["id_owner"].as<int64_t>() == userId);
+            result["family"] = f;
+        }
+
+        Json::Value invitesJson(Json::arrayValue);
+        for (const auto &row : invites) {
+            Json::Value invite;
+            invite["id"] = (Json::Int64)row["id"].as<int64_t>();
+            invite["id_family"] = (Json::Int64)row["id_family"].as<int64_t>();
+            invite["family_name"] = row["family_name"].as<std::string>();
+            invite["inviter_name"] = row["inviter_name"].as<std::string>();
+            invite["email"] = row["email"].as<std::string>();
+            invite["token"] = row["token"].as<std::string>();
+            invite["created_at"] = row["created_at"].as<std::string>();
+            invitesJson.append(invite);
+        }
+        result["invites"] = invitesJson;
+
+        result["accounts"] = std::move(accounts);
+        result["categories"] = std::move(categories);
+
+        auto resp = profiling::jsonResponse(req, result);
+        resp->setStatusCode(drogon::k200OK);
+        co_return resp;
+    } catch (const std::exception &e) {
+        LOG_ERROR << "GetBootstrap error: " << e.what();
+        auto resp = drogon::HttpResponse::newHttpResponse();
+        resp->setStatusCode(drogon::k500InternalServerError);
+        resp->setBody("Internal server error");
+        co_return resp;
+    }
+}
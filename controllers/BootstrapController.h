@@ -0,0 +1,17 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+#include <drogon/HttpBinder.h>
+
+namespace finance {
+
+class BootstrapController : public drogon::HttpController<BootstrapController> {
+public:
+    METHOD_LIST_BEGIN
+        ADD_METHOD_TO(BootstrapController::GetBootstrap, "/api/bootstrap", drogon::Get);
+    METHOD_LIST_END
+
+    drogon::Task<drogon::HttpResponsePtr> GetBootstrap(drogon::HttpRequestPtr req);
+};
+
+}
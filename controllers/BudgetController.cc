@@ -4,6 +4,10 @@
 #include <jsoncpp/json/json.h>
 #include <drogon/HttpAppFramework.h>
 #include "utils/JwtUtils.h"
+#include "db/DataBase.h"
+#include "db/Statements.h"
+#include "utils/Profiling.h"
+#include "models/Category.h"
 
 using namespace finance;
 using namespace drogon_model::financial_manager;
@@ -43,11 +47,8 @@ Task<HttpResponsePtr> BudgetController::CreateBudget(HttpRequestPtr req) {
         bool isFamily = req->getParameter("family") == "true";
         if (isFamily) {
             // Проверяем, что пользователь состоит в семье
-            auto db = drogon::app().getFastDbClient();
-            auto familyCheck = co_await db->execSqlCoro(
-                "SELECT id_family FROM family_members WHERE id_user = $1",
-                *userIdOpt
-            );
+            auto db = db::getDbClient(req);
+            auto familyCheck = co_await db::exec(db, db::stmt::familyOfUser, *userIdOpt);
             if (familyCheck.empty()) {
                 auto resp = drogon::HttpResponse::newHttpResponse();
                 resp->setStatusCode(drogon::k400BadRequest);
@@ -68,36 +69,21 @@ Task<HttpResponsePtr> BudgetController::CreateBudget(HttpRequestPtr req) {
             b.setIsFamily(false);
         }
 
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getDbClient(req);
         // Проверка на дубликат бюджета для той же категории/месяца/года в рамках режима (личный/семейный)
         if (isFamily) {
-            auto familyCheck = co_await db->execSqlCoro(
-                "SELECT id_family FROM family_members WHERE id_user = $1", *userIdOpt
-            );
+            auto familyCheck = co_await db::exec(db, db::stmt::familyOfUser, *userIdOpt);
             if (familyCheck.empty()) {
                 auto resp = drogon::HttpResponse::newHttpResponse();
                 resp->setStatusCode(drogon::k400BadRequest);
                 resp->setBody("User is not a member of any family");
                 co_return resp;
             }
-            int64_t familyId = familyCheck[0]["id_family"].as<int64_t>();
-            auto dup = co_await db->execSqlCoro(
-                R"(
-                /*budget_dup_family_v2*/
-                SELECT 1 FROM budgets b
-                JOIN family_members fm ON fm.id_user = b.id_user
-                WHERE fm.id_family = $1::int8
-                  AND b.id_category = $2::int4
-                  AND b.month = $3::int4
-                  AND b.year = $4::int4
-                  AND b.is_family = TRUE
-                LIMIT 1
-                )",
-                familyId,
+            auto dup = co_await db::exec(db, db::stmt::familyBudgetExists, *userIdOpt,
                 static_cast<int32_t>(b.getValueOfIdCategory()),
                 static_cast<int32_t>(b.getValueOfMonth()),
-                static_cast<int32_t>(b.getValueOfYear())
-            );
+                static_cast<int32_t>(b.getValueOfYear()),
+                0);
             if (!dup.empty()) {
                 auto resp = drogon::HttpResponse::newHttpResponse();
                 resp->setStatusCode(drogon::k400BadRequest);
@@ -146,7 +132,7 @@ Task<HttpResponsePtr> BudgetController::CreateBudget(HttpRequestPtr req) {
 
 Task<HttpResponsePtr> BudgetController::GetBudgets(HttpRequestPtr req) {
     try {
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getReadDbClient(req);
 
         auto userIdOpt = jwt_utils::getUserIdFromRequest(req);
         if (!userIdOpt) {
@@ -162,19 +148,7 @@ Task<HttpResponsePtr> BudgetController::GetBudgets(HttpRequestPtr req) {
         Json::Value arr(Json::arrayValue);
         
         if (isFamily) {
-            auto familyBudgets = co_await db->execSqlCoro(
-                R"(
-                /*family_budgets_v3_ordered*/
-                SELECT b.id, b.id_user, b.id_category, b.month, b.year, b.limit_amount, b.is_family, b.created_at
-                FROM budgets b
-                JOIN family_members fm ON fm.id_user = b.id_user
-                WHERE fm.id_family IN (
-                    SELECT fm2.id_family FROM family_members fm2 WHERE fm2.id_user = $1
-                )
-                AND b.is_family = TRUE
-                ORDER BY b.year DESC, b.month DESC
-                )", *userIdOpt
-            );
+            auto familyBudgets = co_await db::exec(db, db::stmt::familyBudgets, *userIdOpt);
             for (const auto &row : familyBudgets) {
                 auto budgetJson = Budgets(row).toJson();
                 budgetJson["is_family"] = true;
@@ -201,7 +175,7 @@ Task<HttpResponsePtr> BudgetController::GetBudgets(HttpRequestPtr req) {
             }
         }
 
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(arr);
+        auto resp = profiling::jsonResponse(req, arr);
         resp->setStatusCode(drogon::k200OK);
         co_return resp;
     } catch (const std::exception &e) {
@@ -233,9 +207,17 @@ Task<HttpResponsePtr> BudgetController::UpdateBudget(HttpRequestPtr req, int bud
             co_return resp;
         }
 
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getDbClient(req);
         drogon::orm::CoroMapper<Budgets> mapper(db);
-        auto b = co_await mapper.findByPrimaryKey(budgetId);
+        // Бюджет выбирается вместе с проверкой принадлежности пользователю / семье
+        auto bOpt = co_await db::findVisible<Budgets>(db, budgetId, *userIdOpt);
+        if (!bOpt) {
+            auto resp = drogon::HttpResponse::newHttpResponse();
+            resp->setStatusCode(drogon::k403Forbidden);
+            resp->setBody("Budget does not belong to user or family");
+            co_return resp;
+        }
+        Budgets &b = *bOpt;
 
         bool budgetIsFamily = b.getIsFamily() && *b.getIsFamily();
         if (budgetIsFamily != isFamilyRequest) {
@@ -245,32 +227,6 @@ Task<HttpResponsePtr> BudgetController::UpdateBudget(HttpRequestPtr req, int bud
             co_return resp;
         }
 
-        if (budgetIsFamily) {
-            auto familyCheck = co_await db->execSqlCoro(
-                R"(
-                /*budget_update_family_scope*/
-                SELECT 1 FROM family_members fm1
-                JOIN family_members fm2 ON fm1.id_family = fm2.id_family
-                WHERE fm1.id_user = $1::int8 AND fm2.id_user = $2::int8
-                )",
-                static_cast<int64_t>(*userIdOpt),
-                static_cast<int64_t>(b.getValueOfIdUser())
-            );
-            if (familyCheck.empty()) {
-                auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k403Forbidden);
-                resp->setBody("Budget is not available for this family");
-                co_return resp;
-            }
-        } else {
-            if (b.getValueOfIdUser() != static_cast<int32_t>(*userIdOpt)) {
-                auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k403Forbidden);
-                resp->setBody("Budget does not belong to user");
-                co_return resp;
-            }
-        }
-
         int32_t newCategoryId = b.getValueOfIdCategory();
         int32_t newMonth = b.getValueOfMonth();
         int32_t newYear = b.getValueOfYear();
@@ -289,70 +245,26 @@ Task<HttpResponsePtr> BudgetController::UpdateBudget(HttpRequestPtr req, int bud
             newLimit = (*json)["limit_amount"].asString();
         }
 
-        // Проверяем категорию
-        auto catRows = co_await db->execSqlCoro(
-            "SELECT id_user, is_family FROM category WHERE id = $1", newCategoryId
-        );
-        if (catRows.empty()) {
+        // Проверяем категорию: чужая категория не выбирается
+        auto category = co_await db::findVisible<Category>(db, newCategoryId, *userIdOpt);
+        if (!category) {
             auto resp = drogon::HttpResponse::newHttpResponse();
-            resp->setStatusCode(drogon::k400BadRequest);
-            resp->setBody("Category not found");
+            resp->setStatusCode(drogon::k403Forbidden);
+            resp->setBody("Category does not belong to user or family");
             co_return resp;
         }
-        bool catIsFamily = !catRows[0]["is_family"].isNull() && catRows[0]["is_family"].as<bool>();
+        bool catIsFamily = category->getIsFamily() && *category->getIsFamily();
         if (catIsFamily != budgetIsFamily) {
             auto resp = drogon::HttpResponse::newHttpResponse();
             resp->setStatusCode(drogon::k403Forbidden);
             resp->setBody("Category scope mismatch");
             co_return resp;
         }
-        if (budgetIsFamily) {
-            auto familyCheck = co_await db->execSqlCoro(
-                R"(
-                /*budget_update_cat_family*/
-                SELECT 1 FROM family_members fm1
-                JOIN family_members fm2 ON fm1.id_family = fm2.id_family
-                WHERE fm1.id_user = $1::int8 AND fm2.id_user = $2::int8
-                )",
-                static_cast<int64_t>(*userIdOpt),
-                static_cast<int64_t>(catRows[0]["id_user"].as<int64_t>())
-            );
-            if (familyCheck.empty()) {
-                auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k403Forbidden);
-                resp->setBody("Category is not available for this family");
-                co_return resp;
-            }
-        } else {
-            if (catRows[0]["id_user"].as<int>() != static_cast<int32_t>(*userIdOpt)) {
-                auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k403Forbidden);
-                resp->setBody("Category does not belong to user");
-                co_return resp;
-            }
-        }
 
         // Проверяем дубликаты
         if (budgetIsFamily) {
-            auto dupCheck = co_await db->execSqlCoro(
-                R"(
-                /*budget_dup_update_family_v1*/
-                SELECT 1 FROM budgets b
-                JOIN family_members fm1 ON fm1.id_user = b.id_user
-                JOIN family_members fm2 ON fm1.id_family = fm2.id_family
-                WHERE fm2.id_user = $1::int8
-                  AND b.id_category = $2::int4
-                  AND b.month = $3::int4
-                  AND b.year = $4::int4
-                  AND b.is_family = TRUE
-                  AND b.id <> $5::int4
-                )",
-                static_cast<int64_t>(*userIdOpt),
-                newCategoryId,
-                newMonth,
-                newYear,
-                budgetId
-            );
+            auto dupCheck = co_await db::exec(db, db::stmt::familyBudgetExists, *userIdOpt,
+                                              newCategoryId, newMonth, newYear, budgetId);
             if (!dupCheck.empty()) {
                 auto resp = drogon::HttpResponse::newHttpResponse();
                 resp->setStatusCode(drogon::k400BadRequest);
@@ -428,9 +340,17 @@ Task<HttpResponsePtr> BudgetController::DeleteBudget(HttpRequestPtr req, int bud
 
         bool isFamilyRequest = req->getParameter("family") == "true";
 
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getDbClient(req);
         drogon::orm::CoroMapper<Budgets> mapper(db);
-        auto b = co_await mapper.findByPrimaryKey(budgetId);
+        // Бюджет выбирается вместе с проверкой принадлежности пользователю / семье
+        auto bOpt = co_await db::findVisible<Budgets>(db, budgetId, *userIdOpt);
+        if (!bOpt) {
+            auto resp = drogon::HttpResponse::newHttpResponse();
+            resp->setStatusCode(drogon::k403Forbidden);
+            resp->setBody("Budget does not belong to user or family");
+            co_return resp;
+        }
+        Budgets &b = *bOpt;
 
         bool budgetIsFamily = b.getIsFamily() && *b.getIsFamily();
         if (budgetIsFamily != isFamilyRequest) {
@@ -440,32 +360,6 @@ Task<HttpResponsePtr> BudgetController::DeleteBudget(HttpRequestPtr req, int bud
             co_return resp;
         }
 
-        if (budgetIsFamily) {
-            auto familyCheck = co_await db->execSqlCoro(
-                R"(
-                /*budget_delete_family_scope*/
-                SELECT 1 FROM family_members fm1
-                JOIN family_members fm2 ON fm1.id_family = fm2.id_family
-                WHERE fm1.id_user = $1::int8 AND fm2.id_user = $2::int8
-                )",
-                static_cast<int64_t>(*userIdOpt),
-                static_cast<int64_t>(b.getValueOfIdUser())
-            );
-            if (familyCheck.empty()) {
-                auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k403Forbidden);
-                resp->setBody("Budget is not available for this family");
-                co_return resp;
-            }
-        } else {
-            if (b.getValueOfIdUser() != static_cast<int32_t>(*userIdOpt)) {
-                auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k403Forbidden);
-                resp->setBody("Budget does not belong to user");
-                co_return resp;
-            }
-        }
-
         co_await mapper.deleteByPrimaryKey(budgetId);
 
         auto resp = drogon::HttpResponse::newHttpResponse();
@@ -4,6 +4,10 @@
 #include <jsoncpp/json/json.h>
 #include <drogon/HttpAppFramework.h>
 #include "utils/JwtUtils.h"
+#include "db/DataBase.h"
+#include "db/Statements.h"
+#include "utils/Profiling.h"
+#include "db/ListQueries.h"
 
 using namespace finance;
 using namespace drogon_model::financial_manager;
@@ -51,11 +55,8 @@ Task<HttpResponsePtr> CategoryController::CreateCategory(HttpRequestPtr req) {
         bool isFamily = req->getParameter("family") == "true";
         if (isFamily) {
             // Проверяем, что пользователь состоит в семье
-            auto db = drogon::app().getFastDbClient();
-            auto familyCheck = co_await db->execSqlCoro(
-                "SELECT id_family FROM family_members WHERE id_user = $1",
-                *userIdOpt
-            );
+            auto db = db::getDbClient(req);
+            auto familyCheck = co_await db::exec(db, db::stmt::familyOfUser, *userIdOpt);
             if (familyCheck.empty()) {
                 auto resp = drogon::HttpResponse::newHttpResponse();
                 resp->setStatusCode(drogon::k400BadRequest);
@@ -64,7 +65,7 @@ Task<HttpResponsePtr> CategoryController::CreateCategory(HttpRequestPtr req) {
             }
         }
 
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getDbClient(req);
         drogon::orm::CoroMapper<Category> mapper(db);
 
         Category cat;
@@ -100,7 +101,7 @@ Task<HttpResponsePtr> CategoryController::CreateCategory(HttpRequestPtr req) {
 
 Task<HttpResponsePtr> CategoryController::GetCategories(HttpRequestPtr req) {
     try {
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getReadDbClient(req);
 
         auto userIdOpt = jwt_utils::getUserIdFromRequest(req);
         if (!userIdOpt) {
@@ -112,71 +113,12 @@ Task<HttpResponsePtr> CategoryController::GetCategories(HttpRequestPtr req) {
 
         // Проверяем параметр family
         bool isFamily = req->getParameter("family") == "true";
-        
-        Json::Value arr(Json::arrayValue);
-        
-        if (isFamily) {
-            // Получаем семейные категории (категории всех членов семьи)
-            auto familyMembers = co_await db->execSqlCoro(
-                R"(
-                SELECT DISTINCT fm.id_user
-                FROM family_members fm
-                WHERE fm.id_family = (
-                    SELECT fm2.id_family 
-                    FROM family_members fm2 
-                    WHERE fm2.id_user = $1
-                )
-                )", *userIdOpt
-            );
-            
-            if (!familyMembers.empty()) {
-                // Получаем семейные категории всех членов семьи (только is_family = true)
-                auto familyCategories = co_await db->execSqlCoro(
-                    R"(
-                    SELECT c.id, c.id_user, c.name, c.type, c.is_family
-                    FROM category c
-                    JOIN family_members fm ON fm.id_user = c.id_user
-                    WHERE fm.id_family IN (
-                        SELECT fm2.id_family FROM family_members fm2 WHERE fm2.id_user = $1
-                    )
-                    AND c.is_family = TRUE
-                    )", *userIdOpt
-                );
-
-                for (const auto &row : familyCategories) {
-                    Json::Value catJson;
-                    catJson["id"] = (Json::Int64)row["id"].as<int64_t>();
-                    catJson["id_user"] = (Json::Int64)row["id_user"].as<int64_t>();
-                    catJson["name"] = row["name"].as<std::string>();
-                    catJson["type"] = row["type"].as<std::string>();
-                    catJson["is_family"] = true;
-                    arr.append(catJson);
-                }
-            }
-        } else {
-            // Получаем только личные категории пользователя
-            drogon::orm::CoroMapper<Category> mapper(db);
-            std::vector<Category> cats = co_await mapper.findBy(
-                drogon::orm::Criteria(Category::Cols::_id_user,
-                                      drogon::orm::CompareOperator::EQ,
-                                      static_cast<int32_t>(*userIdOpt))
-                && drogon::orm::Criteria(Category::Cols::_is_family,
-                                         drogon::orm::CompareOperator::EQ,
-                                         false));
-            for (const auto &c : cats) {
-                auto catJson = c.toJson();
-                // Проверяем, является ли категория семейной
-                auto isFamilyPtr = c.getIsFamily();
-                if (isFamilyPtr && *isFamilyPtr) {
-                    catJson["is_family"] = true;
-                } else {
-                    catJson["is_family"] = false;
-                }
-                arr.append(catJson);
-            }
-        }
 
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(arr);
+        // Семейные категории всех членов семьи (пусто, если семьи нет) или личные;
+        // список берётся из кеша IO-потока, если он не устарел
+        auto arr = co_await db::categoriesJson(db, *userIdOpt, isFamily);
+
+        auto resp = profiling::jsonResponse(req, arr);
         resp->setStatusCode(drogon::k200OK);
         co_return resp;
     } catch (const std::exception &e) {
@@ -208,10 +150,18 @@ Task<HttpResponsePtr> CategoryController::UpdateCategory(HttpRequestPtr req, int
             co_return resp;
         }
 
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getDbClient(req);
         drogon::orm::CoroMapper<Category> mapper(db);
 
-        auto cat = co_await mapper.findByPrimaryKey(categoryId);
+        // Категория выбирается вместе с проверкой принадлежности пользователю / семье
+        auto catOpt = co_await db::findVisible<Category>(db, categoryId, *userIdOpt);
+        if (!catOpt) {
+            auto resp = drogon::HttpResponse::newHttpResponse();
+            resp->setStatusCode(drogon::k403Forbidden);
+            resp->setBody("Category does not belong to user or family");
+            co_return resp;
+        }
+        Category &cat = *catOpt;
 
         bool catIsFamily = cat.getIsFamily() && *cat.getIsFamily();
         if (catIsFamily != isFamilyRequest) {
@@ -221,33 +171,6 @@ Task<HttpResponsePtr> CategoryController::UpdateCategory(HttpRequestPtr req, int
             co_return resp;
         }
 
-        if (catIsFamily) {
-            auto db = drogon::app().getFastDbClient();
-            auto familyCheck = co_await db->execSqlCoro(
-                R"(
-                /*category_update_family_scope*/
-                SELECT 1 FROM family_members fm1
-                JOIN family_members fm2 ON fm1.id_family = fm2.id_family
-                WHERE fm1.id_user = $1::int8 AND fm2.id_user = $2::int8
-                )",
-                static_cast<int64_t>(*userIdOpt),
-                static_cast<int64_t>(cat.getValueOfIdUser())
-            );
-            if (familyCheck.empty()) {
-                auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k403Forbidden);
-                resp->setBody("Category is not available for this family");
-                co_return resp;
-            }
-        } else {
-            if (cat.getValueOfIdUser() != static_cast<int32_t>(*userIdOpt)) {
-                auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k403Forbidden);
-                resp->setBody("Category does not belong to user");
-                co_return resp;
-            }
-        }
-
         if (json->isMember("name")) {
             cat.setName((*json)["name"].asString());
         }
@@ -293,9 +216,17 @@ Task<HttpResponsePtr> CategoryController::DeleteCategory(HttpRequestPtr req, int
 
         bool isFamilyRequest = req->getParameter("family") == "true";
 
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getDbClient(req);
         drogon::orm::CoroMapper<Category> mapper(db);
-        auto cat = co_await mapper.findByPrimaryKey(categoryId);
+        // Категория выбирается вместе с проверкой принадлежности пользователю / семье
+        auto catOpt = co_await db::findVisible<Category>(db, categoryId, *userIdOpt);
+        if (!catOpt) {
+            auto resp = drogon::HttpResponse::newHttpResponse();
+            resp->setStatusCode(drogon::k403Forbidden);
+            resp->setBody("Category does not belong to user or family");
+            co_return resp;
+        }
+        Category &cat = *catOpt;
 
         bool catIsFamily = cat.getIsFamily() && *cat.getIsFamily();
         if (catIsFamily != isFamilyRequest) {
@@ -305,32 +236,6 @@ Task<HttpResponsePtr> CategoryController::DeleteCategory(HttpRequestPtr req, int
             co_return resp;
         }
 
-        if (catIsFamily) {
-            auto familyCheck = co_await db->execSqlCoro(
-                R"(
-                /*category_delete_family_scope*/
-                SELECT 1 FROM family_members fm1
-                JOIN family_members fm2 ON fm1.id_family = fm2.id_family
-                WHERE fm1.id_user = $1::int8 AND fm2.id_user = $2::int8
-                )",
-                static_cast<int64_t>(*userIdOpt),
-                static_cast<int64_t>(cat.getValueOfIdUser())
-            );
-            if (familyCheck.empty()) {
-                auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k403Forbidden);
-                resp->setBody("Category is not available for this family");
-                co_return resp;
-            }
-        } else {
-            if (cat.getValueOfIdUser() != static_cast<int32_t>(*userIdOpt)) {
-                auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k403Forbidden);
-                resp->setBody("Category does not belong to user");
-                co_return resp;
-            }
-        }
-
         co_await mapper.deleteByPrimaryKey(categoryId);
 
         auto resp = drogon::HttpResponse::newHttpResponse();
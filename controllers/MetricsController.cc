@@ -0,0 +1,76 @@
+#include "MetricsController.h"
+#include <algorithm>
+#include <vector>
+#include <drogon/HttpClient.h>
+#include <drogon/HttpResponse.h>
+#include "utils/CoroUtils.h"
+#include "utils/Metrics.h"
+#include "utils/Prefork.h"
+
+using namespace finance;
+using drogon::HttpRequestPtr;
+using drogon::HttpResponsePtr;
+using drogon::Task;
+
+// Один путь одного процесса; пустая строка, если процесс не ответил (например, перезапускается)
+static Task<std::string> scrapePath(uint16_t port, std::string path) {
+    try {
+        auto client = drogon::HttpClient::newHttpClient(
+            "127.0.0.1", port, false, trantor::EventLoop::getEventLoopOfCurrentThread());
+        auto req = drogon::HttpRequest::newHttpRequest();
+        req->setPath(path);
+        auto resp = co_await client->sendRequestCoro(req, 2);
+        if (resp->statusCode() == drogon::k200OK) {
+            co_return std::string(resp->body());
+        }
+    } catch (const std::exception &e) {
+        LOG_WARN << "Metrics scrape of port " << port << path << " failed: " << e.what();
+    }
+    co_return std::string();
+}
+
+// Метрики одного процесса: PromExporter и метрики приложения
+static Task<std::string> scrapeWorker(uint16_t port) {
+    auto [exporter, app] = co_await coro::when_all(scrapePath(port, "/metrics/local"),
+                                                   scrapePath(port, "/metrics/local/app"));
+    co_return exporter + app;
+}
+
+Task<HttpResponsePtr> MetricsController::GetMetrics(HttpRequestPtr req) {
+    try {
+        const auto &opts = prefork::options();
+        const size_t workers = std::max<size_t>(opts.workers, 1);
+
+        std::vector<Task<std::string>> scrapes;
+        scrapes.reserve(workers);
+        if (prefork::hasLocalListener()) {
+            for (size_t i = 0; i < workers; ++i) {
+                scrapes.push_back(scrapeWorker(static_cast<uint16_t>(opts.metricsPortBase + i)));
+            }
+        } else {
+            // Один процесс без loopback-листенера: свои метрики — через порт, на который пришёл запрос
+            scrapes.push_back(scrapeWorker(req->localAddr().toPort()));
+        }
+        auto outputs = co_await coro::when_all(std::move(scrapes));
+
+        auto resp = drogon::HttpResponse::newHttpResponse();
+        resp->setStatusCode(drogon::k200OK);
+        resp->setContentTypeString("text/plain; version=0.0.4");
+        resp->setBody(metrics::mergeWorkers(outputs));
+        co_return resp;
+    } catch (const std::exception &e) {
+        LOG_ERROR << "GetMetrics error: " << e.what();
+        auto resp = drogon::HttpResponse::newHttpResponse();
+        resp->setStatusCode(drogon::k500InternalServerError);
+        resp->setBody("Internal server error");
+        co_return resp;
+    }
+}
+
+Task<HttpResponsePtr> MetricsController::GetLocalAppMetrics(HttpRequestPtr /*req*/) {
+    auto resp = drogon::HttpResponse::newHttpResponse();
+    resp->setStatusCode(drogon::k200OK);
+    resp->setContentTypeString("text/plain; version=0.0.4");
+    resp->setBody(metrics::render());
+    co_return resp;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+#include <drogon/HttpBinder.h>
+
+namespace finance {
+
+// GET /metrics — метрики всех рабочих процессов в одном ответе. Каждый процесс отдаёт
+// свои метрики PromExporter-ом на /metrics/local; здесь они собираются по loopback-портам
+// и склеиваются с меткой worker="<номер процесса>". Метрики приложения (utils/Metrics.h)
+// процесс отдаёт на /metrics/local/app, они собираются так же
+class MetricsController : public drogon::HttpController<MetricsController> {
+public:
+    METHOD_LIST_BEGIN
+        ADD_METHOD_TO(MetricsController::GetMetrics, "/metrics", drogon::Get);
+        ADD_METHOD_TO(MetricsController::GetLocalAppMetrics, "/metrics/local/app", drogon::Get);
+    METHOD_LIST_END
+
+    drogon::Task<drogon::HttpResponsePtr> GetMetrics(drogon::HttpRequestPtr req);
+    drogon::Task<drogon::HttpResponsePtr> GetLocalAppMetrics(drogon::HttpRequestPtr req);
+};
+
+}
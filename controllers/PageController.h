@@ -18,14 +18,10 @@ public:
     void Index(const drogon::HttpRequestPtr& req,
                std::function<void(const drogon::HttpResponsePtr&)> &&callback);
     drogon::Task<drogon::HttpResponsePtr> HomePage(drogon::HttpRequestPtr req);
-    void CategoriesPage(const drogon::HttpRequestPtr& req,
-                        std::function<void(const drogon::HttpResponsePtr&)> &&callback);
-    void TransactionsPage(const drogon::HttpRequestPtr& req,
-                          std::function<void(const drogon::HttpResponsePtr&)> &&callback);
-    void TransfersPage(const drogon::HttpRequestPtr& req,
-                       std::function<void(const drogon::HttpResponsePtr&)> &&callback);
-    void BudgetsPage(const drogon::HttpRequestPtr& req,
-                     std::function<void(const drogon::HttpResponsePtr&)> &&callback);
+    drogon::Task<drogon::HttpResponsePtr> CategoriesPage(drogon::HttpRequestPtr req);
+    drogon::Task<drogon::HttpResponsePtr> TransactionsPage(drogon::HttpRequestPtr req);
+    drogon::Task<drogon::HttpResponsePtr> TransfersPage(drogon::HttpRequestPtr req);
+    drogon::Task<drogon::HttpResponsePtr> BudgetsPage(drogon::HttpRequestPtr req);
 };
 
 }
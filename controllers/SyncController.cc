@@ -0,0 +1,237 @@
+#include "SyncController.h"
+#include <drogon/HttpResponse.h>
+#include <drogon/HttpAppFramework.h>
+#include <jsoncpp/json/json.h>
+#include <map>
+#include <vector>
+#include "utils/JwtUtils.h"
+#include "db/ChangeLog.h"
+#include "db/DataBase.h"
+#include "db/Statements.h"
+#include "utils/Profiling.h"
+#include "models/Account.h"
+#include "models/Category.h"
+#include "models/Transactions.h"
+#include "models/Transfer.h"
+#include "models/Budgets.h"
+
+using namespace finance;
+using namespace drogon_model::financial_manager;
+using drogon::HttpRequestPtr;
+using drogon::HttpResponsePtr;
+using drogon::Task;
+
+namespace {
+
+// Изменения одной сущности, свёрнутые по id за окно синхронизации
+struct EntityChanges {
+    std::vector<int32_t> inserted;
+    std::vector<int32_t> updated;
+    std::vector<int32_t> deleted;
+};
+
+// Имя таблицы в change_log -> ключ в ответе
+const std::map<std::string, std::string> kEntityKeys = {
+    {"account", "accounts"},
+    {"category", "categories"},
+    {"transactions", "transactions"},
+    {"transfer", "transfers"},
+    {"budgets", "budgets"},
+};
+
+// Массив id в виде литерала Postgres: {1,2,3}
+std::string toPgArray(const std::vector<int32_t> &a, const std::vector<int32_t> &b) {
+    std::string s = "{";
+    for (auto id : a) {
+        if (s.size() > 1) s += ',';
+        s += std::to_string(id);
+    }
+    for (auto id : b) {
+        if (s.size() > 1) s += ',';
+        s += std::to_string(id);
+    }
+    s += '}';
+    return s;
+}
+
+template <typename Model>
+Json::Value rowToJson(const drogon::orm::Row &row) {
+    Model m(row);
+    auto json = m.toJson();
+    auto isFamilyPtr = m.getIsFamily();
+    json["is_family"] = isFamilyPtr ? *isFamilyPtr : false;
+    return json;
+}
+
+}
+
+Task<HttpResponsePtr> SyncController::GetChanges(HttpRequestPtr req) {
+    try {
+        auto userIdOpt = jwt_utils::getUserIdFromRequest(req);
+        if (!userIdOpt) {
+            auto resp = drogon::HttpResponse::newHttpResponse();
+            resp->setStatusCode(drogon::k401Unauthorized);
+            resp->setBody("Unauthorized");
+            co_return resp;
+        }
+
+        // Без since клиент только получает текущую версию (после полной загрузки коллекций)
+        const std::string sinceStr = req->getParameter("since");
+        int64_t since = -1;
+        if (!sinceStr.empty()) {
+            try {
+                since = std::stoll(sinceStr);
+            } catch (...) {
+                since = -2;
+            }
+            if (since < 0) {
+                auto resp = drogon::HttpResponse::newHttpResponse();
+                resp->setStatusCode(drogon::k400BadRequest);
+                resp->setBody("Invalid since parameter");
+                co_return resp;
+            }
+        }
+
+        auto db = db::getDbClient(req);
+
+        if (since < 0) {
+            auto snap = co_await db->execSqlCoro(
+                "/*sync_version_v1*/ SELECT txid_snapshot_xmin(txid_current_snapshot()) AS upto"
+            );
+            Json::Value result;
+            result["version"] = (Json::Int64)snap[0]["upto"].as<int64_t>();
+            auto resp = profiling::jsonResponse(req, result);
+            resp->setStatusCode(drogon::k200OK);
+            co_return resp;
+        }
+
+        // Записи старше курсора уже удалены очисткой журнала: клиент загружает коллекции заново
+        if (since < co_await db::changeLogHorizon(db)) {
+            auto resp = drogon::HttpResponse::newHttpResponse();
+            resp->setStatusCode(drogon::k410Gone);
+            resp->setBody("Sync version expired");
+            co_return resp;
+        }
+
+        // Журнал в личной и семейной областях пользователя, свёрнутый по (entity, id)
+        auto changes = co_await db->execSqlCoro(
+            R"(
+            /*sync_changes_v1*/
+            WITH snap AS (
+                SELECT txid_snapshot_xmin(txid_current_snapshot()) AS upto
+            ),
+            fam AS (
+                SELECT id_family FROM family_members WHERE id_user = $1::int8 LIMIT 1
+            ),
+            changes AS (
+                SELECT cl.entity, cl.entity_id,
+                       bool_or(cl.op = 'I') AS was_inserted,
+                       (array_agg(cl.op ORDER BY cl.seq DESC))[1] AS last_op
+                FROM change_log cl, snap
+                WHERE cl.txid >= $2::int8
+                  AND cl.txid < snap.upto
+                  AND ((cl.is_family = FALSE AND cl.id_user = $1::int8)
+                       OR (cl.is_family = TRUE AND cl.id_family = (SELECT id_family FROM fam)))
+                GROUP BY cl.entity, cl.entity_id
+            )
+            SELECT snap.upto, c.entity, c.entity_id, c.was_inserted, c.last_op
+            FROM snap LEFT JOIN changes c ON TRUE
+            )",
+            static_cast<int64_t>(*userIdOpt),
+            since
+        );
+
+        int64_t upto = since;
+        std::map<std::string, EntityChanges> byEntity;
+        for (const auto &row : changes) {
+            upto = row["upto"].as<int64_t>();
+            if (row["entity"].isNull()) {
+                continue;
+            }
+            auto &ec = byEntity[row["entity"].as<std::string>()];
+            const int32_t id = row["entity_id"].as<int32_t>();
+            const bool wasInserted = row["was_inserted"].as<bool>();
+            const std::string lastOp = row["last_op"].as<std::string>();
+            if (lastOp == "D") {
+                // Создано и удалено внутри окна — клиент эту строку не видел
+                if (!wasInserted) {
+                    ec.deleted.push_back(id);
+                }
+            } else if (wasInserted) {
+                ec.inserted.push_back(id);
+            } else {
+                ec.updated.push_back(id);
+            }
+        }
+
+        Json::Value result;
+        result["version"] = (Json::Int64)upto;
+        result["changes"] = Json::Value(Json::objectValue);
+
+        for (const auto &[entity, ec] : byEntity) {
+            auto keyIt = kEntityKeys.find(entity);
+            if (keyIt == kEntityKeys.end()) {
+                continue;
+            }
+            Json::Value entityJson;
+            entityJson["inserted"] = Json::Value(Json::arrayValue);
+            entityJson["updated"] = Json::Value(Json::arrayValue);
+            entityJson["deleted"] = Json::Value(Json::arrayValue);
+            for (auto id : ec.deleted) {
+                entityJson["deleted"].append(id);
+            }
+
+            if (!ec.inserted.empty() || !ec.updated.empty()) {
+                // Имя таблицы взято из белого списка kEntityKeys. Доступ проверяется заново:
+                // семья в журнале — на момент записи, пользователь мог из неё выйти.
+                // Строка, ставшая недоступной, просто не попадает в ответ
+                auto rows = co_await db->execSqlCoro(
+                    "/*sync_rows_v2*/ SELECT * FROM " + entity + " WHERE id = ANY($1::int4[]) AND " +
+                        db::visibleToUser,
+                    toPgArray(ec.inserted, ec.updated),
+                    static_cast<int64_t>(*userIdOpt)
+                );
+                std::map<int32_t, Json::Value> payloads;
+                for (const auto &row : rows) {
+                    Json::Value json;
+                    if (entity == "account") {
+                        json = rowToJson<Account>(row);
+                    } else if (entity == "category") {
+                        json = rowToJson<Category>(row);
+                    } else if (entity == "transactions") {
+                        json = rowToJson<Transactions>(row);
+                    } else if (entity == "transfer") {
+                        json = rowToJson<Transfer>(row);
+                    } else {
+                        json = rowToJson<Budgets>(row);
+                    }
+                    payloads[row["id"].as<int32_t>()] = std::move(json);
+                }
+                // Строки, удалённые после снимка, попадут в deleted следующей синхронизации
+                for (auto id : ec.inserted) {
+                    auto it = payloads.find(id);
+                    if (it != payloads.end()) {
+                        entityJson["inserted"].append(it->second);
+                    }
+                }
+                for (auto id : ec.updated) {
+                    auto it = payloads.find(id);
+                    if (it != payloads.end()) {
+                        entityJson["updated"].append(it->second);
+                    }
+                }
+            }
+            result["changes"][keyIt->second] = entityJson;
+        }
+
+        auto resp = profiling::jsonResponse(req, result);
+        resp->setStatusCode(drogon::k200OK);
+        co_return resp;
+    } catch (const std::exception &e) {
+        LOG_ERROR << "GetChanges error: " << e.what();
+        auto resp = drogon::HttpResponse::newHttpResponse();
+        resp->setStatusCode(drogon::k500InternalServerError);
+        resp->setBody("Internal server error");
+        co_return resp;
+    }
+}
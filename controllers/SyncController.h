@@ -0,0 +1,17 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+#include <drogon/HttpBinder.h>
+
+namespace finance {
+
+class SyncController : public drogon::HttpController<SyncController> {
+public:
+    METHOD_LIST_BEGIN
+        ADD_METHOD_TO(SyncController::GetChanges, "/sync", drogon::Get);
+    METHOD_LIST_END
+
+    drogon::Task<drogon::HttpResponsePtr> GetChanges(drogon::HttpRequestPtr req);
+};
+
+}
@@ -4,9 +4,16 @@
 #include <jsoncpp/json/json.h>
 #include <drogon/HttpAppFramework.h>
 #include "utils/JwtUtils.h"
+#include "db/DataBase.h"
+#include "db/Balances.h"
+#include "db/FamilyActors.h"
+#include "db/GroupCommit.h"
+#include "db/Statements.h"
+#include "db/Transaction.h"
+#include "utils/Profiling.h"
+#include "utils/CoroUtils.h"
+#include "utils/AmountUtils.h"
 #include "models/Account.h"
-#include <sstream>
-#include <iomanip>
 
 using namespace finance;
 using namespace drogon_model::financial_manager;
@@ -63,33 +70,30 @@ Task<HttpResponsePtr> TransactionsController::createTransaction(HttpRequestPtr r
             co_return resp;
         }
 
-        // Парсим сумму для обновления баланса
-        double amountValue = 0.0;
-        try {
-            amountValue = std::stod(amount);
-        } catch (...) {
+        // Парсим сумму для обновления баланса; в запись и в баланс идёт одно и то же значение
+        // с двумя знаками, а не исходная строка клиента
+        auto parsedAmount = amount_utils::parseRequestAmount(amount);
+        if (!parsedAmount) {
             auto resp = drogon::HttpResponse::newHttpResponse();
             resp->setStatusCode(drogon::k400BadRequest);
             resp->setBody("Invalid amount format");
             co_return resp;
         }
+        amount = amount_utils::amountToString(*parsedAmount);
+        const double amountValue = amount_utils::parseAmount(amount);
 
-        auto db = drogon::app().getFastDbClient();
-        drogon::orm::CoroMapper<Transactions> trMapper(db);
-        drogon::orm::CoroMapper<Account> accMapper(db);
+        auto db = db::getDbClient(req);
 
         // Семейный режим задаётся параметром family=true
         bool isFamily = req->getParameter("family") == "true";
         if (isFamily) {
-            // Проверяем, что пользователь состоит в семье
-            auto familyCheck = co_await db->execSqlCoro(
-                "SELECT id_family FROM family_members WHERE id_user = $1",
-                *userIdOpt
-            );
-            if (familyCheck.empty()) {
+            // Членство в семье и семейный счёт проверяет актор семьи (db/FamilyActors.h)
+            auto access = co_await db::checkFamilyWrite(db, *userIdOpt, {idAccount},
+                                                        "Account does not belong to user or family");
+            if (!access.ok()) {
                 auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k400BadRequest);
-                resp->setBody("User is not a member of any family");
+                resp->setStatusCode(access.status);
+                resp->setBody(access.error);
                 co_return resp;
             }
         }
@@ -111,10 +115,10 @@ Task<HttpResponsePtr> TransactionsController::createTransaction(HttpRequestPtr r
             std::transform(catType.begin(), catType.end(), catType.begin(), ::tolower);
             const bool catIsFamily = !catRows[0]["is_family"].isNull() && catRows[0]["is_family"].as<bool>();
 
-            LOG_INFO << "[Tx] user=" << *userIdOpt << " isFamily=" << isFamily
-                     << " account=" << idAccount << " category=" << idCategory
-                     << " catType=" << catType << " reqType=" << type
-                     << " catFamily=" << catIsFamily;
+            LOG_DEBUG << "[Tx] user=" << *userIdOpt << " isFamily=" << isFamily
+                      << " account=" << idAccount << " category=" << idCategory
+                      << " catType=" << catType << " reqType=" << type
+                      << " catFamily=" << catIsFamily;
 
             // Проверяем совпадение типа категории и типа транзакции
             if (catType != type) {
@@ -133,93 +137,38 @@ Task<HttpResponsePtr> TransactionsController::createTransaction(HttpRequestPtr r
             }
         }
 
-        // Получаем счет и проверяем права доступа
-        Account account;
-        try {
-            account = co_await accMapper.findByPrimaryKey(idAccount);
-            bool hasAccess = false;
-            bool accountIsFamily = account.getIsFamily() && *account.getIsFamily();
-            if (isFamily && accountIsFamily) {
-                // Проверяем, что счет принадлежит семье пользователя
-                auto familyCheck = co_await db->execSqlCoro(
-                    R"(
-                    /*tx_family_access_v2*/
-                    SELECT 1 FROM family_members fm1
-                    JOIN family_members fm2 ON fm1.id_family = fm2.id_family
-                    WHERE fm1.id_user = $1::int8 AND fm2.id_user = $2::int8
-                    )", *userIdOpt, static_cast<int64_t>(account.getValueOfIdUser())
-                );
-                hasAccess = !familyCheck.empty();
-            } else if (!isFamily && !accountIsFamily) {
-                hasAccess = (account.getValueOfIdUser() == static_cast<int32_t>(*userIdOpt));
-            }
-            
-            if (!hasAccess) {
+        // Личный счет получаем вместе с проверкой доступа: чужой счет не выбирается
+        if (!isFamily) {
+            auto accountOpt = co_await db::findVisible<Account>(db, idAccount, *userIdOpt);
+            const bool accountIsFamily = accountOpt && accountOpt->getIsFamily() && *accountOpt->getIsFamily();
+            if (!accountOpt || accountIsFamily) {
                 auto resp = drogon::HttpResponse::newHttpResponse();
                 resp->setStatusCode(drogon::k403Forbidden);
                 resp->setBody("Account does not belong to user or family");
                 co_return resp;
             }
-        } catch (const drogon::orm::UnexpectedRows &) {
-            auto resp = drogon::HttpResponse::newHttpResponse();
-            resp->setStatusCode(drogon::k404NotFound);
-            resp->setBody("Account not found");
-            co_return resp;
-        }
-
-        // Обновляем баланс счета
-        double currentBalance = 0.0;
-        try {
-            currentBalance = std::stod(account.getValueOfBalance());
-        } catch (...) {
-            currentBalance = 0.0;
-        }
-
-        if (type == "income") {
-            currentBalance += amountValue;
-        } else {
-            currentBalance -= amountValue;
-            if (currentBalance < 0) {
-                auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k400BadRequest);
-                resp->setBody("Insufficient funds");
-                co_return resp;
-            }
         }
 
-        // Форматируем баланс обратно в строку
-        std::ostringstream oss;
-        oss.setf(std::ios::fixed);
-        oss.precision(2);
-        oss << currentBalance;
-        account.setBalance(oss.str());
-        co_await accMapper.update(account);
-
-        // Создаем транзакцию
-        Transactions tr;
-        tr.setIdUser(static_cast<int32_t>(*userIdOpt));
-        tr.setIdAccount(idAccount);
-        tr.setAmount(amount);
-        tr.setType(type);
-        if (idCategory > 0) {
-            tr.setIdCategory(idCategory);
-        } else {
-            tr.setIdCategoryToNull();
-        }
-        if (!description.empty()) {
-            tr.setDescription(description);
-        } else {
-            tr.setDescriptionToNull();
-        }
-        if (isFamily) {
-            tr.setIsFamily(true);
-        } else {
-            tr.setIsFamily(false);
+        // Баланс счета и новая запись пишутся пакетом вместе с другими транзакциями по этому
+        // счету (db/GroupCommit.h); остаток проверяется там же, под блокировкой строки счета
+        db::NewTransaction item;
+        item.idUser = static_cast<int32_t>(*userIdOpt);
+        item.idAccount = idAccount;
+        item.amount = amount;
+        item.amountValue = amountValue;
+        item.type = type;
+        item.idCategory = idCategory;
+        item.description = description;
+        item.isFamily = isFamily;
+        auto result = co_await db::addTransaction(std::move(item), req);
+        if (!result.inserted) {
+            auto resp = drogon::HttpResponse::newHttpResponse();
+            resp->setStatusCode(result.status);
+            resp->setBody(result.error);
+            co_return resp;
         }
 
-        auto inserted = co_await trMapper.insert(tr);
-
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(inserted.toJson());
+        auto resp = drogon::HttpResponse::newHttpJsonResponse(result.inserted->toJson());
         resp->setStatusCode(drogon::k201Created);
         co_return resp;
     } catch (const drogon::orm::DrogonDbException &e) {
@@ -245,7 +194,7 @@ Task<HttpResponsePtr> TransactionsController::createTransaction(HttpRequestPtr r
 
 Task<HttpResponsePtr> TransactionsController::GetTransactions(HttpRequestPtr req) {
     try {
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getReadDbClient(req);
 
         auto userIdOpt = jwt_utils::getUserIdFromRequest(req);
         if (!userIdOpt) {
@@ -261,19 +210,7 @@ Task<HttpResponsePtr> TransactionsController::GetTransactions(HttpRequestPtr req
         Json::Value arr(Json::arrayValue);
         
         if (isFamily) {
-            auto familyTransactions = co_await db->execSqlCoro(
-                R"(
-                /*family_transactions_v2*/
-                SELECT t.*
-                FROM transactions t
-                JOIN family_members fm ON fm.id_user = t.id_user
-                WHERE fm.id_family IN (
-                    SELECT fm2.id_family FROM family_members fm2 WHERE fm2.id_user = $1
-                )
-                AND t.is_family = TRUE
-                ORDER BY t.created_at DESC
-                )", *userIdOpt
-            );
+            auto familyTransactions = co_await db::exec(db, db::stmt::familyTransactions, *userIdOpt);
             for (const auto &row : familyTransactions) {
                 Transactions t(row);
                 auto trJson = t.toJson();
@@ -300,7 +237,7 @@ Task<HttpResponsePtr> TransactionsController::GetTransactions(HttpRequestPtr req
             }
         }
 
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(arr);
+        auto resp = profiling::jsonResponse(req, arr);
         resp->setStatusCode(drogon::k200OK);
         co_return resp;
     } catch (const std::exception &e) {
@@ -313,9 +250,9 @@ Task<HttpResponsePtr> TransactionsController::GetTransactions(HttpRequestPtr req
 }
 
 Task<HttpResponsePtr> TransactionsController::GetTransactionById(
-    HttpRequestPtr /*req*/, int transactionId) {
+    HttpRequestPtr req, int transactionId) {
     try {
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getReadDbClient(req);
         drogon::orm::CoroMapper<Transactions> mapper(db);
         auto tr = co_await mapper.findByPrimaryKey(transactionId);
 
@@ -366,12 +303,17 @@ Task<HttpResponsePtr> TransactionsController::UpdateTransaction(
             co_return resp;
         }
 
-        auto db = drogon::app().getFastDbClient();
-        drogon::orm::CoroMapper<Transactions> trMapper(db);
-        drogon::orm::CoroMapper<Account> accMapper(db);
+        auto db = db::getDbClient(req);
 
-        // Получаем текущую транзакцию
-        auto existing = co_await trMapper.findByPrimaryKey(transactionId);
+        // Получаем текущую транзакцию вместе с проверкой принадлежности пользователю / семье
+        auto existingOpt = co_await db::findVisible<Transactions>(db, transactionId, *userIdOpt);
+        if (!existingOpt) {
+            auto resp = drogon::HttpResponse::newHttpResponse();
+            resp->setStatusCode(drogon::k403Forbidden);
+            resp->setBody("Transaction does not belong to user or family");
+            co_return resp;
+        }
+        Transactions existing = std::move(*existingOpt);
         const bool txIsFamily = existing.getIsFamily() && *existing.getIsFamily();
         if (txIsFamily != isFamilyRequest) {
             auto resp = drogon::HttpResponse::newHttpResponse();
@@ -380,33 +322,6 @@ Task<HttpResponsePtr> TransactionsController::UpdateTransaction(
             co_return resp;
         }
 
-        // Проверка принадлежности транзакции пользователю / семье
-        if (txIsFamily) {
-            auto familyCheck = co_await db->execSqlCoro(
-                R"(
-                /*tx_update_family_scope*/
-                SELECT 1 FROM family_members fm1
-                JOIN family_members fm2 ON fm1.id_family = fm2.id_family
-                WHERE fm1.id_user = $1::int8 AND fm2.id_user = $2::int8
-                )",
-                static_cast<int64_t>(*userIdOpt),
-                static_cast<int64_t>(existing.getValueOfIdUser())
-            );
-            if (familyCheck.empty()) {
-                auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k403Forbidden);
-                resp->setBody("Transaction is not available for this family");
-                co_return resp;
-            }
-        } else {
-            if (existing.getValueOfIdUser() != static_cast<int32_t>(*userIdOpt)) {
-                auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k403Forbidden);
-                resp->setBody("Transaction does not belong to user");
-                co_return resp;
-            }
-        }
-
         // Сохраняем старые значения для отката баланса
         const int32_t oldAccountId = existing.getValueOfIdAccount();
         std::string oldType = existing.getValueOfType();
@@ -432,15 +347,15 @@ Task<HttpResponsePtr> TransactionsController::UpdateTransaction(
             resp->setBody("Invalid type. Must be 'income' or 'expense'");
             co_return resp;
         }
-        double newAmount = 0.0;
-        try {
-            newAmount = std::stod(newAmountStr);
-        } catch (...) {
+        auto parsedAmount = amount_utils::parseRequestAmount(newAmountStr);
+        if (!parsedAmount) {
             auto resp = drogon::HttpResponse::newHttpResponse();
             resp->setStatusCode(drogon::k400BadRequest);
             resp->setBody("Invalid amount format");
             co_return resp;
         }
+        newAmountStr = amount_utils::amountToString(*parsedAmount);
+        const double newAmount = amount_utils::parseAmount(newAmountStr);
 
         int32_t newCategoryId = 0;
         if (json->isMember("id_category")) {
@@ -479,127 +394,61 @@ Task<HttpResponsePtr> TransactionsController::UpdateTransaction(
             }
         }
 
-        // Откат баланса старого счета
-        auto oldAccount = co_await accMapper.findByPrimaryKey(oldAccountId);
-        bool oldAccFamily = oldAccount.getIsFamily() && *oldAccount.getIsFamily();
-        bool hasAccessOldAcc = false;
-        if (txIsFamily && oldAccFamily) {
-            auto familyCheck = co_await db->execSqlCoro(
-                R"(
-                /*tx_update_old_acc_family*/
-                SELECT 1 FROM family_members fm1
-                JOIN family_members fm2 ON fm1.id_family = fm2.id_family
-                WHERE fm1.id_user = $1::int8 AND fm2.id_user = $2::int8
-                )",
-                static_cast<int64_t>(*userIdOpt),
-                static_cast<int64_t>(oldAccount.getValueOfIdUser())
-            );
-            hasAccessOldAcc = !familyCheck.empty();
-        } else if (!txIsFamily && !oldAccFamily) {
-            hasAccessOldAcc = (oldAccount.getValueOfIdUser() == static_cast<int32_t>(*userIdOpt));
-        }
-        if (!hasAccessOldAcc) {
+        // Старый и новый счета запрашиваются одновременно, сразу с проверкой доступа
+        auto [oldAccountOpt, newAccountOpt] = co_await coro::when_all(
+            db::findVisible<Account>(db, oldAccountId, *userIdOpt),
+            db::findVisible<Account>(db, newAccountId, *userIdOpt));
+        // Личной транзакции доступны только личные счета, семейной — только семейные
+        auto hasAccess = [txIsFamily](const std::optional<Account> &acc) {
+            return acc && (acc->getIsFamily() && *acc->getIsFamily()) == txIsFamily;
+        };
+
+        // Проверяем старый счет
+        if (!hasAccess(oldAccountOpt)) {
             auto resp = drogon::HttpResponse::newHttpResponse();
             resp->setStatusCode(drogon::k403Forbidden);
             resp->setBody("Account does not belong to user or family");
             co_return resp;
         }
 
-        auto revertBalance = [&](double balance) {
-            if (oldType == "income") {
-                return balance - oldAmount;
-            } else {
-                return balance + oldAmount;
-            }
-        };
-
-        double oldAccBalance = 0.0;
-        try {
-            oldAccBalance = std::stod(oldAccount.getValueOfBalance());
-        } catch (...) {
-            oldAccBalance = 0.0;
-        }
-        oldAccBalance = revertBalance(oldAccBalance);
-        {
-            std::ostringstream oss;
-            oss.setf(std::ios::fixed);
-            oss.precision(2);
-            oss << oldAccBalance;
-            oldAccount.setBalance(oss.str());
-        }
-
         // Проверяем новый счет
-        auto newAccount = co_await accMapper.findByPrimaryKey(newAccountId);
-        bool newAccFamily = newAccount.getIsFamily() && *newAccount.getIsFamily();
-        bool hasAccessNewAcc = false;
-        if (txIsFamily && newAccFamily) {
-            auto familyCheck = co_await db->execSqlCoro(
-                R"(
-                /*tx_update_new_acc_family*/
-                SELECT 1 FROM family_members fm1
-                JOIN family_members fm2 ON fm1.id_family = fm2.id_family
-                WHERE fm1.id_user = $1::int8 AND fm2.id_user = $2::int8
-                )",
-                static_cast<int64_t>(*userIdOpt),
-                static_cast<int64_t>(newAccount.getValueOfIdUser())
-            );
-            hasAccessNewAcc = !familyCheck.empty();
-        } else if (!txIsFamily && !newAccFamily) {
-            hasAccessNewAcc = (newAccount.getValueOfIdUser() == static_cast<int32_t>(*userIdOpt));
-        }
-
-        if (!hasAccessNewAcc) {
+        if (!hasAccess(newAccountOpt)) {
             auto resp = drogon::HttpResponse::newHttpResponse();
             resp->setStatusCode(drogon::k403Forbidden);
             resp->setBody("Account does not belong to user or family");
             co_return resp;
         }
 
-        if (newAccFamily != txIsFamily) {
+        db::TxScope tx(db, co_await db->newTransactionCoro());
+        // Транзакция не изменилась с момента чтения: иначе её старая сумма откатывалась бы дважды
+        auto locked = co_await db::exec(tx.client(), db::stmt::lockTransaction, transactionId);
+        if (locked.empty()) {
             auto resp = drogon::HttpResponse::newHttpResponse();
-            resp->setStatusCode(drogon::k403Forbidden);
-            resp->setBody("Account scope mismatch");
+            resp->setStatusCode(drogon::k404NotFound);
+            resp->setBody("Transaction not found");
             co_return resp;
         }
-
-        // Применяем новое изменение баланса
-        double newAccBalance = 0.0;
-        try {
-            newAccBalance = std::stod(newAccount.getValueOfBalance());
-        } catch (...) {
-            newAccBalance = 0.0;
-        }
-        if (oldAccountId == newAccountId) {
-            // если один и тот же счет, берём уже откатанный баланс
-            newAccBalance = oldAccBalance;
-        }
-
-        if (newType == "income") {
-            newAccBalance += newAmount;
-        } else {
-            newAccBalance -= newAmount;
-            if (newAccBalance < 0) {
-                auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k400BadRequest);
-                resp->setBody("Insufficient funds");
-                co_return resp;
-            }
-        }
-
-        {
-            std::ostringstream oss;
-            oss.setf(std::ios::fixed);
-            oss.precision(2);
-            oss << newAccBalance;
-            newAccount.setBalance(oss.str());
+        if (locked[0]["id_account"].as<int32_t>() != oldAccountId ||
+            locked[0]["amount"].as<std::string>() != existing.getValueOfAmount() ||
+            locked[0]["type"].as<std::string>() != existing.getValueOfType()) {
+            auto resp = drogon::HttpResponse::newHttpResponse();
+            resp->setStatusCode(drogon::k409Conflict);
+            resp->setBody("Transaction was changed concurrently");
+            co_return resp;
         }
 
-        // Сохраняем балансы
-        if (oldAccountId == newAccountId) {
-            co_await accMapper.update(newAccount);
-        } else {
-            co_await accMapper.update(oldAccount);
-            co_await accMapper.update(newAccount);
+        // Откат старой суммы и новая сумма — приращения балансов (db/Balances.h): запись
+        // по тому же счёту из других запросов не затирается, расход не уводит баланс в минус
+        const double revert = oldType == "income" ? -oldAmount : oldAmount;
+        const double apply = newType == "income" ? newAmount : -newAmount;
+        std::vector<db::BalanceChange> changes{{oldAccountId, revert},
+                                               {newAccountId, apply, newType != "income"}};
+        auto overdrawn = co_await db::applyBalanceChanges(tx.client(), std::move(changes));
+        if (overdrawn) {
+            auto resp = drogon::HttpResponse::newHttpResponse();
+            resp->setStatusCode(drogon::k400BadRequest);
+            resp->setBody("Insufficient funds");
+            co_return resp;
         }
 
         // Обновляем транзакцию
@@ -623,7 +472,8 @@ Task<HttpResponsePtr> TransactionsController::UpdateTransaction(
             existing.setIsFamily(false);
         }
 
-        co_await trMapper.update(existing);
+        co_await tx.mapper<Transactions>().update(existing);
+        co_await tx.commit();
 
         auto resp = drogon::HttpResponse::newHttpJsonResponse(existing.toJson());
         resp->setStatusCode(drogon::k200OK);
@@ -661,11 +511,17 @@ Task<HttpResponsePtr> TransactionsController::DeleteTransaction(
 
         bool isFamilyRequest = req->getParameter("family") == "true";
 
-        auto db = drogon::app().getFastDbClient();
-        drogon::orm::CoroMapper<Transactions> trMapper(db);
-        drogon::orm::CoroMapper<Account> accMapper(db);
+        auto db = db::getDbClient(req);
 
-        auto tr = co_await trMapper.findByPrimaryKey(transactionId);
+        // Транзакция выбирается вместе с проверкой принадлежности пользователю / семье
+        auto trOpt = co_await db::findVisible<Transactions>(db, transactionId, *userIdOpt);
+        if (!trOpt) {
+            auto resp = drogon::HttpResponse::newHttpResponse();
+            resp->setStatusCode(drogon::k403Forbidden);
+            resp->setBody("Transaction does not belong to user or family");
+            co_return resp;
+        }
+        const Transactions &tr = *trOpt;
         const bool txIsFamily = tr.getIsFamily() && *tr.getIsFamily();
         if (txIsFamily != isFamilyRequest) {
             auto resp = drogon::HttpResponse::newHttpResponse();
@@ -674,52 +530,10 @@ Task<HttpResponsePtr> TransactionsController::DeleteTransaction(
             co_return resp;
         }
 
-        if (txIsFamily) {
-            auto familyCheck = co_await db->execSqlCoro(
-                R"(
-                /*tx_delete_family_scope*/
-                SELECT 1 FROM family_members fm1
-                JOIN family_members fm2 ON fm1.id_family = fm2.id_family
-                WHERE fm1.id_user = $1::int8 AND fm2.id_user = $2::int8
-                )",
-                static_cast<int64_t>(*userIdOpt),
-                static_cast<int64_t>(tr.getValueOfIdUser())
-            );
-            if (familyCheck.empty()) {
-                auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k403Forbidden);
-                resp->setBody("Transaction is not available for this family");
-                co_return resp;
-            }
-        } else {
-            if (tr.getValueOfIdUser() != static_cast<int32_t>(*userIdOpt)) {
-                auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k403Forbidden);
-                resp->setBody("Transaction does not belong to user");
-                co_return resp;
-            }
-        }
-
         // Получаем счет и проверяем доступ
-        auto account = co_await accMapper.findByPrimaryKey(tr.getValueOfIdAccount());
-        bool accIsFamily = account.getIsFamily() && *account.getIsFamily();
-        bool hasAccessAcc = false;
-        if (txIsFamily && accIsFamily) {
-            auto familyCheck = co_await db->execSqlCoro(
-                R"(
-                /*tx_delete_acc_family*/
-                SELECT 1 FROM family_members fm1
-                JOIN family_members fm2 ON fm1.id_family = fm2.id_family
-                WHERE fm1.id_user = $1::int8 AND fm2.id_user = $2::int8
-                )",
-                static_cast<int64_t>(*userIdOpt),
-                static_cast<int64_t>(account.getValueOfIdUser())
-            );
-            hasAccessAcc = !familyCheck.empty();
-        } else if (!txIsFamily && !accIsFamily) {
-            hasAccessAcc = (account.getValueOfIdUser() == static_cast<int32_t>(*userIdOpt));
-        }
-        if (!hasAccessAcc) {
+        auto accountOpt = co_await db::findVisible<Account>(db, tr.getValueOfIdAccount(), *userIdOpt);
+        const bool accIsFamily = accountOpt && accountOpt->getIsFamily() && *accountOpt->getIsFamily();
+        if (!accountOpt || accIsFamily != txIsFamily) {
             auto resp = drogon::HttpResponse::newHttpResponse();
             resp->setStatusCode(drogon::k403Forbidden);
             resp->setBody("Account does not belong to user or family");
@@ -739,27 +553,28 @@ Task<HttpResponsePtr> TransactionsController::DeleteTransaction(
             co_return resp;
         }
 
-        double balance = 0.0;
-        try {
-            balance = std::stod(account.getValueOfBalance());
-        } catch (...) {
-            balance = 0.0;
+        // Откат баланса (приращением, db/Balances.h) и удаление — в одной транзакции БД;
+        // транзакция не изменилась с момента чтения, иначе откатывалась бы не та сумма
+        db::TxScope tx(db, co_await db->newTransactionCoro());
+        auto locked = co_await db::exec(tx.client(), db::stmt::lockTransaction, transactionId);
+        if (locked.empty()) {
+            auto resp = drogon::HttpResponse::newHttpResponse();
+            resp->setStatusCode(drogon::k404NotFound);
+            resp->setBody("Transaction not found");
+            co_return resp;
         }
-
-        if (type == "income") {
-            balance -= amount;
-        } else {
-            balance += amount;
+        if (locked[0]["id_account"].as<int32_t>() != tr.getValueOfIdAccount() ||
+            locked[0]["amount"].as<std::string>() != tr.getValueOfAmount() ||
+            locked[0]["type"].as<std::string>() != tr.getValueOfType()) {
+            auto resp = drogon::HttpResponse::newHttpResponse();
+            resp->setStatusCode(drogon::k409Conflict);
+            resp->setBody("Transaction was changed concurrently");
+            co_return resp;
         }
-
-        std::ostringstream oss;
-        oss.setf(std::ios::fixed);
-        oss.precision(2);
-        oss << balance;
-        account.setBalance(oss.str());
-        co_await accMapper.update(account);
-
-        co_await trMapper.deleteByPrimaryKey(transactionId);
+        std::vector<db::BalanceChange> changes{{tr.getValueOfIdAccount(), type == "income" ? -amount : amount}};
+        co_await db::applyBalanceChanges(tx.client(), std::move(changes));
+        co_await tx.mapper<Transactions>().deleteByPrimaryKey(transactionId);
+        co_await tx.commit();
 
         auto resp = drogon::HttpResponse::newHttpResponse();
         resp->setStatusCode(drogon::k204NoContent);
@@ -4,6 +4,14 @@
 #include <jsoncpp/json/json.h>
 #include <drogon/HttpAppFramework.h>
 #include "utils/JwtUtils.h"
+#include "db/DataBase.h"
+#include "db/Balances.h"
+#include "db/FamilyActors.h"
+#include "db/Statements.h"
+#include "db/Transaction.h"
+#include "utils/Profiling.h"
+#include "utils/CoroUtils.h"
+#include "utils/AmountUtils.h"
 
 using namespace finance;
 using namespace drogon_model::financial_manager;
@@ -11,21 +19,8 @@ using drogon::HttpRequestPtr;
 using drogon::HttpResponsePtr;
 using drogon::Task;
 
-static double parseAmount(const std::string &s) {
-    try {
-        return std::stod(s);
-    } catch (...) {
-        return 0.0;
-    }
-}
-
-static std::string amountToString(double v) {
-    std::ostringstream oss;
-    oss.setf(std::ios::fixed);
-    oss.precision(2);
-    oss << v;
-    return oss.str();
-}
+using amount_utils::parseAmount;
+using amount_utils::amountToString;
 
 Task<HttpResponsePtr> TransferController::CreateTransfer(HttpRequestPtr req) {
     try {
@@ -64,90 +59,54 @@ Task<HttpResponsePtr> TransferController::CreateTransfer(HttpRequestPtr req) {
             co_return resp;
         }
 
-        auto db = drogon::app().getFastDbClient();
-        drogon::orm::CoroMapper<Account> accMapper(db);
-        drogon::orm::CoroMapper<Transfer> trMapper(db);
+        auto db = db::getDbClient(req);
 
         // Семейный режим задаётся параметром family=true
         bool isFamily = req->getParameter("family") == "true";
+
+        // Семейный перевод: членство в семье и семейные счета проверяет актор семьи
+        // (db/FamilyActors.h), и до COMMIT перевод держит очередь записи семьи: семейные
+        // переводы пишутся по одному
+        db::FamilyAccess access;
         if (isFamily) {
-            // Проверяем, что пользователь состоит в семье
-            auto familyCheck = co_await db->execSqlCoro(
-                "SELECT id_family FROM family_members WHERE id_user = $1",
-                *userIdOpt
-            );
-            if (familyCheck.empty()) {
+            access = co_await db::checkFamilyWrite(db, *userIdOpt, {fromId, toId},
+                                                   "Accounts do not belong to user or family", true);
+            if (!access.ok()) {
                 auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k400BadRequest);
-                resp->setBody("User is not a member of any family");
+                resp->setStatusCode(access.status);
+                resp->setBody(access.error);
                 co_return resp;
             }
         }
 
-        auto fromAcc = co_await accMapper.findByPrimaryKey(fromId);
-        auto toAcc = co_await accMapper.findByPrimaryKey(toId);
+        // Оба счёта запрашиваются одновременно; чужие счета не выбираются
+        auto [fromAccOpt, toAccOpt] = co_await coro::when_all(db::findVisible<Account>(db, fromId, *userIdOpt),
+                                                              db::findVisible<Account>(db, toId, *userIdOpt));
 
-        // Проверяем права доступа к счетам
-        bool hasAccessFrom = false;
-        bool hasAccessTo = false;
-        
-        bool fromAccIsFamily = fromAcc.getIsFamily() && *fromAcc.getIsFamily();
-        bool toAccIsFamily = toAcc.getIsFamily() && *toAcc.getIsFamily();
-        
-        if (isFamily && fromAccIsFamily) {
-            auto familyCheck = co_await db->execSqlCoro(
-                R"(
-                /*transfer_family_from_v2*/
-                SELECT 1 FROM family_members fm1
-                JOIN family_members fm2 ON fm1.id_family = fm2.id_family
-                WHERE fm1.id_user = $1::int8 AND fm2.id_user = $2::int8
-                )", static_cast<int64_t>(*userIdOpt), static_cast<int64_t>(fromAcc.getValueOfIdUser())
-            );
-            hasAccessFrom = !familyCheck.empty();
-        } else if (!isFamily && !fromAccIsFamily) {
-            hasAccessFrom = (fromAcc.getValueOfIdUser() == static_cast<int32_t>(*userIdOpt));
-        }
-        
-        if (isFamily && toAccIsFamily) {
-            auto familyCheck = co_await db->execSqlCoro(
-                R"(
-                /*transfer_family_to_v2*/
-                SELECT 1 FROM family_members fm1
-                JOIN family_members fm2 ON fm1.id_family = fm2.id_family
-                WHERE fm1.id_user = $1::int8 AND fm2.id_user = $2::int8
-                )", static_cast<int64_t>(*userIdOpt), static_cast<int64_t>(toAcc.getValueOfIdUser())
-            );
-            hasAccessTo = !familyCheck.empty();
-        } else if (!isFamily && !toAccIsFamily) {
-            hasAccessTo = (toAcc.getValueOfIdUser() == static_cast<int32_t>(*userIdOpt));
-        }
-
-        if (!hasAccessFrom || !hasAccessTo) {
+        // Проверяем права доступа к счетам: личному переводу доступны только личные счета,
+        // семейному — только семейные
+        auto hasAccess = [isFamily](const std::optional<Account> &acc) {
+            return acc && (acc->getIsFamily() && *acc->getIsFamily()) == isFamily;
+        };
+        if (!hasAccess(fromAccOpt) || !hasAccess(toAccOpt)) {
             auto resp = drogon::HttpResponse::newHttpResponse();
             resp->setStatusCode(drogon::k403Forbidden);
             resp->setBody("Accounts do not belong to user or family");
             co_return resp;
         }
 
-        double fromBal = parseAmount(fromAcc.getValueOfBalance());
-        double toBal = parseAmount(toAcc.getValueOfBalance());
-
-        if (fromBal < amount) {
+        // Балансы меняются приращением внутри транзакции (db/Balances.h): одновременная запись
+        // по тем же счетам не затирается, а баланс счёта-источника не уходит в минус
+        db::TxScope tx(db, co_await db->newTransactionCoro());
+        std::vector<db::BalanceChange> changes{{fromId, -amount, true}, {toId, amount}};
+        auto overdrawn = co_await db::applyBalanceChanges(tx.client(), std::move(changes));
+        if (overdrawn) {
             auto resp = drogon::HttpResponse::newHttpResponse();
             resp->setStatusCode(drogon::k400BadRequest);
             resp->setBody("Insufficient funds");
             co_return resp;
         }
 
-        fromBal -= amount;
-        toBal += amount;
-        fromAcc.setBalance(amountToString(fromBal));
-        toAcc.setBalance(amountToString(toBal));
-
-        // Обновляем счета и записываем перевод
-        co_await accMapper.update(fromAcc);
-        co_await accMapper.update(toAcc);
-
         Transfer tr;
         tr.setIdUser(static_cast<int32_t>(*userIdOpt));
         tr.setAccountFrom(fromId);
@@ -159,7 +118,8 @@ Task<HttpResponsePtr> TransferController::CreateTransfer(HttpRequestPtr req) {
             tr.setIsFamily(false);
         }
 
-        auto inserted = co_await trMapper.insert(tr);
+        auto inserted = co_await tx.mapper<Transfer>().insert(tr);
+        co_await tx.commit();
 
         auto resp = drogon::HttpResponse::newHttpJsonResponse(inserted.toJson());
         resp->setStatusCode(drogon::k201Created);
@@ -180,7 +140,7 @@ Task<HttpResponsePtr> TransferController::CreateTransfer(HttpRequestPtr req) {
 
 Task<HttpResponsePtr> TransferController::GetTransfers(HttpRequestPtr req) {
     try {
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getReadDbClient(req);
 
         auto userIdOpt = jwt_utils::getUserIdFromRequest(req);
         if (!userIdOpt) {
@@ -197,19 +157,7 @@ Task<HttpResponsePtr> TransferController::GetTransfers(HttpRequestPtr req) {
         
         if (isFamily) {
             // Получаем только семейные переводы всех членов семьи
-            auto familyTransfers = co_await db->execSqlCoro(
-                R"(
-                /*family_transfers_v2*/
-                SELECT t.*
-                FROM transfer t
-                JOIN family_members fm ON fm.id_user = t.id_user
-                WHERE fm.id_family IN (
-                    SELECT fm2.id_family FROM family_members fm2 WHERE fm2.id_user = $1
-                )
-                AND t.is_family = TRUE
-                ORDER BY t.created_at DESC
-                )", *userIdOpt
-            );
+            auto familyTransfers = co_await db::exec(db, db::stmt::familyTransfers, *userIdOpt);
             for (const auto &row : familyTransfers) {
                 Transfer t(row);
                 auto trJson = t.toJson();
@@ -235,7 +183,7 @@ Task<HttpResponsePtr> TransferController::GetTransfers(HttpRequestPtr req) {
             }
         }
 
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(arr);
+        auto resp = profiling::jsonResponse(req, arr);
         resp->setStatusCode(drogon::k200OK);
         co_return resp;
     } catch (const std::exception &e) {
@@ -292,11 +240,17 @@ Task<HttpResponsePtr> TransferController::UpdateTransfer(HttpRequestPtr req, int
             co_return resp;
         }
 
-        auto db = drogon::app().getFastDbClient();
-        drogon::orm::CoroMapper<Account> accMapper(db);
-        drogon::orm::CoroMapper<Transfer> trMapper(db);
+        auto db = db::getDbClient(req);
 
-        auto existing = co_await trMapper.findByPrimaryKey(transferId);
+        // Перевод выбирается вместе с проверкой принадлежности пользователю / семье
+        auto existingOpt = co_await db::findVisible<Transfer>(db, transferId, *userIdOpt);
+        if (!existingOpt) {
+            auto resp = drogon::HttpResponse::newHttpResponse();
+            resp->setStatusCode(drogon::k403Forbidden);
+            resp->setBody("Transfer does not belong to user or family");
+            co_return resp;
+        }
+        Transfer &existing = *existingOpt;
         const bool trFamily = existing.getIsFamily() && *existing.getIsFamily();
         if (trFamily != isFamily) {
             auto resp = drogon::HttpResponse::newHttpResponse();
@@ -305,140 +259,76 @@ Task<HttpResponsePtr> TransferController::UpdateTransfer(HttpRequestPtr req, int
             co_return resp;
         }
 
-        if (trFamily) {
-            auto familyCheck = co_await db->execSqlCoro(
-                R"(
-                /*transfer_update_scope*/
-                SELECT 1 FROM family_members fm1
-                JOIN family_members fm2 ON fm1.id_family = fm2.id_family
-                WHERE fm1.id_user = $1::int8 AND fm2.id_user = $2::int8
-                )", static_cast<int64_t>(*userIdOpt), static_cast<int64_t>(existing.getValueOfIdUser())
-            );
-            if (familyCheck.empty()) {
-                auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k403Forbidden);
-                resp->setBody("Transfer is not available for this family");
-                co_return resp;
-            }
-        } else {
-            if (existing.getValueOfIdUser() != static_cast<int32_t>(*userIdOpt)) {
-                auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k403Forbidden);
-                resp->setBody("Transfer does not belong to user");
-                co_return resp;
-            }
-        }
-
         // Счета из старого перевода
         int32_t oldFromId = existing.getValueOfAccountFrom();
         int32_t oldToId = existing.getValueOfAccountTo();
         double oldAmount = parseAmount(existing.getValueOfAmount());
 
-        auto oldFromAcc = co_await accMapper.findByPrimaryKey(oldFromId);
-        auto oldToAcc = co_await accMapper.findByPrimaryKey(oldToId);
-
-        auto checkAccAccess = [&](const Account &acc) -> drogon::Task<bool> {
-            bool accIsFamily = acc.getIsFamily() && *acc.getIsFamily();
-            if (trFamily && accIsFamily) {
-                auto familyCheck = co_await db->execSqlCoro(
-                    R"(
-                    /*transfer_update_acc_access*/
-                    SELECT 1 FROM family_members fm1
-                    JOIN family_members fm2 ON fm1.id_family = fm2.id_family
-                    WHERE fm1.id_user = $1::int8 AND fm2.id_user = $2::int8
-                    )", static_cast<int64_t>(*userIdOpt), static_cast<int64_t>(acc.getValueOfIdUser())
-                );
-                co_return !familyCheck.empty();
-            } else if (!trFamily && !accIsFamily) {
-                co_return acc.getValueOfIdUser() == static_cast<int32_t>(*userIdOpt);
-            }
-            co_return false;
+        // Старые и новые счета запрашиваются одновременно, сразу с проверкой доступа
+        auto [oldFromOpt, oldToOpt, newFromOpt, newToOpt] = co_await coro::when_all(
+            db::findVisible<Account>(db, oldFromId, *userIdOpt),
+            db::findVisible<Account>(db, oldToId, *userIdOpt),
+            db::findVisible<Account>(db, newFromId, *userIdOpt),
+            db::findVisible<Account>(db, newToId, *userIdOpt));
+
+        // Личному переводу доступны только личные счета, семейному — только семейные
+        auto hasAccess = [trFamily](const std::optional<Account> &acc) {
+            return acc && (acc->getIsFamily() && *acc->getIsFamily()) == trFamily;
         };
 
-        if (!(co_await checkAccAccess(oldFromAcc))) {
+        if (!hasAccess(oldFromOpt)) {
             auto resp = drogon::HttpResponse::newHttpResponse();
             resp->setStatusCode(drogon::k403Forbidden);
             resp->setBody("Source account not accessible");
             co_return resp;
         }
-        if (!(co_await checkAccAccess(oldToAcc))) {
+        if (!hasAccess(oldToOpt)) {
             auto resp = drogon::HttpResponse::newHttpResponse();
             resp->setStatusCode(drogon::k403Forbidden);
             resp->setBody("Target account not accessible");
             co_return resp;
         }
 
-        // Откатываем старый перевод
-        double oldFromBal = parseAmount(oldFromAcc.getValueOfBalance());
-        double oldToBal = parseAmount(oldToAcc.getValueOfBalance());
-        oldFromBal += oldAmount;
-        oldToBal -= oldAmount;
-        if (oldToBal < 0) {
-            auto resp = drogon::HttpResponse::newHttpResponse();
-            resp->setStatusCode(drogon::k400BadRequest);
-            resp->setBody("Cannot revert transfer: negative balance");
-            co_return resp;
-        }
-        oldFromAcc.setBalance(amountToString(oldFromBal));
-        oldToAcc.setBalance(amountToString(oldToBal));
-
         // Проверяем новые счета
-        auto newFromAcc = co_await accMapper.findByPrimaryKey(newFromId);
-        auto newToAcc = co_await accMapper.findByPrimaryKey(newToId);
-
-        if (!(co_await checkAccAccess(newFromAcc))) {
+        if (!hasAccess(newFromOpt)) {
             auto resp = drogon::HttpResponse::newHttpResponse();
             resp->setStatusCode(drogon::k403Forbidden);
             resp->setBody("Source account not accessible");
             co_return resp;
         }
-        if (!(co_await checkAccAccess(newToAcc))) {
+        if (!hasAccess(newToOpt)) {
             auto resp = drogon::HttpResponse::newHttpResponse();
             resp->setStatusCode(drogon::k403Forbidden);
             resp->setBody("Target account not accessible");
             co_return resp;
         }
 
-        bool fromFamily = newFromAcc.getIsFamily() && *newFromAcc.getIsFamily();
-        bool toFamily = newToAcc.getIsFamily() && *newToAcc.getIsFamily();
-        if (fromFamily != trFamily || toFamily != trFamily) {
+        db::TxScope tx(db, co_await db->newTransactionCoro());
+        // Перевод не изменился с момента чтения: иначе старый перевод откатывался бы дважды
+        auto locked = co_await db::exec(tx.client(), db::stmt::lockTransfer, transferId);
+        if (locked.empty()) {
             auto resp = drogon::HttpResponse::newHttpResponse();
-            resp->setStatusCode(drogon::k403Forbidden);
-            resp->setBody("Accounts scope mismatch");
+            resp->setStatusCode(drogon::k404NotFound);
+            resp->setBody("Transfer not found");
             co_return resp;
         }
-
-        // Применяем новый перевод
-        double newFromBal = (newFromId == oldFromId) ? oldFromBal : parseAmount(newFromAcc.getValueOfBalance());
-        double newToBal = (newToId == oldToId) ? oldToBal : parseAmount(newToAcc.getValueOfBalance());
-
-        newFromBal -= newAmount;
-        if (newFromBal < 0) {
+        if (locked[0]["account_from"].as<int32_t>() != oldFromId || locked[0]["account_to"].as<int32_t>() != oldToId ||
+            locked[0]["amount"].as<std::string>() != existing.getValueOfAmount()) {
             auto resp = drogon::HttpResponse::newHttpResponse();
-            resp->setStatusCode(drogon::k400BadRequest);
-            resp->setBody("Insufficient funds");
+            resp->setStatusCode(drogon::k409Conflict);
+            resp->setBody("Transfer was changed concurrently");
             co_return resp;
         }
-        newToBal += newAmount;
-
-        newFromAcc.setBalance(amountToString(newFromBal));
-        newToAcc.setBalance(amountToString(newToBal));
-
-        // Сохраняем счета
-        if (newFromId == oldFromId) {
-            co_await accMapper.update(newFromAcc);
-        } else {
-            co_await accMapper.update(oldFromAcc);
-            co_await accMapper.update(newFromAcc);
-        }
 
-        if (newToId == oldToId) {
-            if (newToId != newFromId) {
-                co_await accMapper.update(newToAcc);
-            }
-        } else {
-            co_await accMapper.update(oldToAcc);
-            co_await accMapper.update(newToAcc);
+        // Откат старого перевода и новый перевод — приращения балансов (db/Balances.h)
+        std::vector<db::BalanceChange> changes{
+            {oldFromId, oldAmount}, {oldToId, -oldAmount, true}, {newFromId, -newAmount, true}, {newToId, newAmount}};
+        auto overdrawn = co_await db::applyBalanceChanges(tx.client(), std::move(changes));
+        if (overdrawn) {
+            auto resp = drogon::HttpResponse::newHttpResponse();
+            resp->setStatusCode(drogon::k400BadRequest);
+            resp->setBody(*overdrawn == newFromId ? "Insufficient funds" : "Cannot revert transfer: negative balance");
+            co_return resp;
         }
 
         // Обновляем перевод
@@ -448,7 +338,8 @@ Task<HttpResponsePtr> TransferController::UpdateTransfer(HttpRequestPtr req, int
         existing.setAmount(amountToString(newAmount));
         existing.setIsFamily(trFamily);
 
-        co_await trMapper.update(existing);
+        co_await tx.mapper<Transfer>().update(existing);
+        co_await tx.commit();
 
         auto resp = drogon::HttpResponse::newHttpJsonResponse(existing.toJson());
         resp->setStatusCode(drogon::k200OK);
@@ -479,11 +370,17 @@ Task<HttpResponsePtr> TransferController::DeleteTransfer(HttpRequestPtr req, int
 
         bool isFamily = req->getParameter("family") == "true";
 
-        auto db = drogon::app().getFastDbClient();
-        drogon::orm::CoroMapper<Account> accMapper(db);
-        drogon::orm::CoroMapper<Transfer> trMapper(db);
+        auto db = db::getDbClient(req);
 
-        auto tr = co_await trMapper.findByPrimaryKey(transferId);
+        // Перевод выбирается вместе с проверкой принадлежности пользователю / семье
+        auto trOpt = co_await db::findVisible<Transfer>(db, transferId, *userIdOpt);
+        if (!trOpt) {
+            auto resp = drogon::HttpResponse::newHttpResponse();
+            resp->setStatusCode(drogon::k403Forbidden);
+            resp->setBody("Transfer does not belong to user or family");
+            co_return resp;
+        }
+        const Transfer &tr = *trOpt;
         const bool trFamily = tr.getIsFamily() && *tr.getIsFamily();
         if (trFamily != isFamily) {
             auto resp = drogon::HttpResponse::newHttpResponse();
@@ -492,87 +389,56 @@ Task<HttpResponsePtr> TransferController::DeleteTransfer(HttpRequestPtr req, int
             co_return resp;
         }
 
-        if (trFamily) {
-            auto familyCheck = co_await db->execSqlCoro(
-                R"(
-                /*transfer_delete_scope*/
-                SELECT 1 FROM family_members fm1
-                JOIN family_members fm2 ON fm1.id_family = fm2.id_family
-                WHERE fm1.id_user = $1::int8 AND fm2.id_user = $2::int8
-                )", static_cast<int64_t>(*userIdOpt), static_cast<int64_t>(tr.getValueOfIdUser())
-            );
-            if (familyCheck.empty()) {
-                auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k403Forbidden);
-                resp->setBody("Transfer is not available for this family");
-                co_return resp;
-            }
-        } else {
-            if (tr.getValueOfIdUser() != static_cast<int32_t>(*userIdOpt)) {
-                auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setStatusCode(drogon::k403Forbidden);
-                resp->setBody("Transfer does not belong to user");
-                co_return resp;
-            }
-        }
-
         int32_t fromId = tr.getValueOfAccountFrom();
         int32_t toId = tr.getValueOfAccountTo();
         double amount = parseAmount(tr.getValueOfAmount());
 
-        auto fromAcc = co_await accMapper.findByPrimaryKey(fromId);
-        auto toAcc = co_await accMapper.findByPrimaryKey(toId);
-
-        auto checkAccAccess = [&](const Account &acc) -> drogon::Task<bool> {
-            bool accIsFamily = acc.getIsFamily() && *acc.getIsFamily();
-            if (trFamily && accIsFamily) {
-                auto familyCheck = co_await db->execSqlCoro(
-                    R"(
-                    /*transfer_delete_acc*/
-                    SELECT 1 FROM family_members fm1
-                    JOIN family_members fm2 ON fm1.id_family = fm2.id_family
-                    WHERE fm1.id_user = $1::int8 AND fm2.id_user = $2::int8
-                    )", static_cast<int64_t>(*userIdOpt), static_cast<int64_t>(acc.getValueOfIdUser())
-                );
-                co_return !familyCheck.empty();
-            } else if (!trFamily && !accIsFamily) {
-                co_return acc.getValueOfIdUser() == static_cast<int32_t>(*userIdOpt);
-            }
-            co_return false;
-        };
+        auto [fromOpt, toOpt] = co_await coro::when_all(db::findVisible<Account>(db, fromId, *userIdOpt),
+                                                        db::findVisible<Account>(db, toId, *userIdOpt));
 
-        if (!(co_await checkAccAccess(fromAcc))) {
+        // Личному переводу доступны только личные счета, семейному — только семейные
+        auto hasAccess = [trFamily](const std::optional<Account> &acc) {
+            return acc && (acc->getIsFamily() && *acc->getIsFamily()) == trFamily;
+        };
+        if (!hasAccess(fromOpt)) {
             auto resp = drogon::HttpResponse::newHttpResponse();
             resp->setStatusCode(drogon::k403Forbidden);
             resp->setBody("Source account not accessible");
             co_return resp;
         }
-        if (!(co_await checkAccAccess(toAcc))) {
+        if (!hasAccess(toOpt)) {
             auto resp = drogon::HttpResponse::newHttpResponse();
             resp->setStatusCode(drogon::k403Forbidden);
             resp->setBody("Target account not accessible");
             co_return resp;
         }
-
-        double fromBal = parseAmount(fromAcc.getValueOfBalance());
-        double toBal = parseAmount(toAcc.getValueOfBalance());
-
-        fromBal += amount;
-        toBal -= amount;
-        if (toBal < 0) {
+        // Откат балансов и удаление перевода — в одной транзакции БД; перевод не изменился
+        // с момента чтения, иначе откатывались бы не те суммы
+        db::TxScope tx(db, co_await db->newTransactionCoro());
+        auto locked = co_await db::exec(tx.client(), db::stmt::lockTransfer, transferId);
+        if (locked.empty()) {
+            auto resp = drogon::HttpResponse::newHttpResponse();
+            resp->setStatusCode(drogon::k404NotFound);
+            resp->setBody("Transfer not found");
+            co_return resp;
+        }
+        if (locked[0]["account_from"].as<int32_t>() != fromId || locked[0]["account_to"].as<int32_t>() != toId ||
+            locked[0]["amount"].as<std::string>() != tr.getValueOfAmount()) {
+            auto resp = drogon::HttpResponse::newHttpResponse();
+            resp->setStatusCode(drogon::k409Conflict);
+            resp->setBody("Transfer was changed concurrently");
+            co_return resp;
+        }
+        std::vector<db::BalanceChange> changes{{fromId, amount}, {toId, -amount, true}};
+        auto overdrawn = co_await db::applyBalanceChanges(tx.client(), std::move(changes));
+        if (overdrawn) {
             auto resp = drogon::HttpResponse::newHttpResponse();
             resp->setStatusCode(drogon::k400BadRequest);
             resp->setBody("Cannot revert transfer: negative balance");
             co_return resp;
         }
-
-        fromAcc.setBalance(amountToString(fromBal));
-        toAcc.setBalance(amountToString(toBal));
-
-        co_await accMapper.update(fromAcc);
-        co_await accMapper.update(toAcc);
-
-        co_await trMapper.deleteByPrimaryKey(transferId);
+        co_await tx.mapper<Transfer>().deleteByPrimaryKey(transferId);
+        co_await tx.commit();
 
         auto resp = drogon::HttpResponse::newHttpResponse();
         resp->setStatusCode(drogon::k204NoContent);
@@ -6,6 +6,14 @@
 #include <drogon/HttpViewData.h>
 #include "utils/PasswordUtils.h"
 #include "utils/JwtUtils.h"
+#include "db/DataBase.h"
+#include "db/FamilyActors.h"
+#include "db/Statements.h"
+#include "db/Transaction.h"
+#include "utils/PageShell.h"
+#include "utils/PageCache.h"
+#include "utils/PageRender.h"
+#include "StaticAssets.h"
 #include "models/FamilyMembers.h"
 #include "models/FamilyInvite.h"
 
@@ -39,7 +47,7 @@ Task<HttpResponsePtr> UserController::Register(HttpRequestPtr req) {
         std::string email = (*json)["email"].asString();
         std::string password = (*json)["password"].asString();
 
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getDbClient(req);
         drogon::orm::CoroMapper<Users> mapper(db);
 
         // Проверяем, что такого email ещё нет
@@ -74,6 +82,7 @@ Task<HttpResponsePtr> UserController::Register(HttpRequestPtr req) {
 
         auto resp = drogon::HttpResponse::newHttpJsonResponse(result);
         resp->setStatusCode(drogon::k201Created);
+        resp->addHeader("Set-Cookie", "token=" + result["token"].asString() + "; Path=/; HttpOnly; SameSite=Lax; Max-Age=86400");
         co_return resp;
     } catch (const std::exception &e) {
         LOG_ERROR << "Register error: " << e.what();
@@ -104,7 +113,7 @@ Task<HttpResponsePtr> UserController::Login(HttpRequestPtr req) {
         std::string email = (*json)["email"].asString();
         std::string password = (*json)["password"].asString();
 
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getDbClient(req);
         drogon::orm::CoroMapper<Users> mapper(db);
 
         Users user;
@@ -135,6 +144,8 @@ Task<HttpResponsePtr> UserController::Login(HttpRequestPtr req) {
 
         auto resp = drogon::HttpResponse::newHttpJsonResponse(result);
         resp->setStatusCode(drogon::k200OK);
+        // Cookie нужна страницам, которые рендерят данные на сервере
+        resp->addHeader("Set-Cookie", "token=" + result["token"].asString() + "; Path=/; HttpOnly; SameSite=Lax; Max-Age=86400");
         co_return resp;
     } catch (const std::exception &e) {
         LOG_ERROR << "Login error: " << e.what();
@@ -155,7 +166,7 @@ Task<HttpResponsePtr> UserController::GetProfile(HttpRequestPtr req) {
             co_return resp;
         }
 
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getDbClient(req);
         drogon::orm::CoroMapper<Users> mapper(db);
         auto user = co_await mapper.findByPrimaryKey(static_cast<int32_t>(*userIdOpt));
 
@@ -214,7 +225,7 @@ Task<HttpResponsePtr> UserController::UpdateProfile(HttpRequestPtr req) {
             co_return resp;
         }
 
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getDbClient(req);
         drogon::orm::CoroMapper<Users> mapper(db);
         auto user = co_await mapper.findByPrimaryKey(static_cast<int32_t>(*userIdOpt));
 
@@ -262,9 +273,11 @@ Task<HttpResponsePtr> UserController::DeleteAccount(HttpRequestPtr req) {
             co_return resp;
         }
 
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getDbClient(req);
         drogon::orm::CoroMapper<Users> mapper(db);
         co_await mapper.deleteByPrimaryKey(static_cast<int32_t>(*userIdOpt));
+        // Удалённый пользователь больше не член своей семьи
+        db::familyChanged();
 
         auto resp = drogon::HttpResponse::newHttpResponse();
         resp->setStatusCode(drogon::k204NoContent);
@@ -306,9 +319,9 @@ Task<HttpResponsePtr> UserController::CreateFamily(HttpRequestPtr req) {
             co_return resp;
         }
         int64_t idUser = *IdUserOpt;
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getDbClient(req);
         //проверяем, есть ли пользователь уже в какой - то семье
-        auto memberCheck = co_await db->execSqlCoro("SELECT 1 FROM family_members WHERE id_user = $1", idUser);
+        auto memberCheck = co_await db::exec(db, db::stmt::familyOfUser, idUser);
         if (!memberCheck.empty()) {
             auto resp = drogon::HttpResponse::newHttpResponse();
             resp->setStatusCode(drogon::k400BadRequest);
@@ -316,18 +329,21 @@ Task<HttpResponsePtr> UserController::CreateFamily(HttpRequestPtr req) {
             co_return resp;
         }
         std::string name = (*json)["name"].asString();
-        drogon::orm::CoroMapper<Families> mapper(db);
+        // Семья и членство владельца создаются вместе
+        db::TxScope tx(db, co_await db->newTransactionCoro());
 
         Families family;
         family.setName(name);
         family.setIdOwner(idUser);
-        auto inserted = co_await mapper.insert(family);
+        auto inserted = co_await tx.mapper<Families>().insert(family);
 
-        drogon::orm::CoroMapper<FamilyMembers> membersMapper(db);
         FamilyMembers member;
         member.setIdFamily(inserted.getValueOfId());
         member.setIdUser(idUser);
-        co_await membersMapper.insert(member);
+        co_await tx.mapper<FamilyMembers>().insert(member);
+        co_await tx.commit();
+        // Акторы семей (db/FamilyActors.h) перечитают состав семей
+        db::familyChanged();
 
         Json::Value res;
         res["id"] = inserted.getValueOfId();
@@ -356,7 +372,7 @@ Task<HttpResponsePtr> UserController::InviteToFamily(HttpRequestPtr req, int64_t
             resp->setBody("Unauthorized");
             co_return resp;
         }
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getDbClient(req);
 
         // family_members хранит id_family/id_user как bigint -> используем int64
         int64_t id_family_i64 = id_family;
@@ -430,18 +446,18 @@ Task<HttpResponsePtr> UserController::JoinFamily(HttpRequestPtr req) {
     
     // Пробуем получить данные из JSON
     auto json = req->getJsonObject();
-    LOG_INFO << "[JoinFamily] request received, content-type=" << req->getHeader("Content-Type");
+    LOG_DEBUG << "[JoinFamily] request received, content-type=" << req->getHeader("Content-Type");
     if (json && json->isMember("token") && json->isMember("email") && json->isMember("password")) {
         token = (*json)["token"].asString();
         email = (*json)["email"].asString();
         password = (*json)["password"].asString();
-        LOG_INFO << "[JoinFamily] got JSON payload token=" << token << " email=" << email;
+        LOG_DEBUG << "[JoinFamily] got JSON payload token=" << token << " email=" << email;
     } else {
         // Пробуем получить данные из form-data
         token = req->getParameter("token");
         email = req->getParameter("email");
         password = req->getParameter("password");
-        LOG_INFO << "[JoinFamily] got form-data token=" << token << " email=" << email;
+        LOG_DEBUG << "[JoinFamily] got form-data token=" << token << " email=" << email;
         
         if (token.empty() || email.empty() || password.empty()) {
         auto resp = drogon::HttpResponse::newHttpResponse();
@@ -451,8 +467,8 @@ Task<HttpResponsePtr> UserController::JoinFamily(HttpRequestPtr req) {
         }
     }
 
-    auto db = drogon::app().getFastDbClient();
-    LOG_INFO << "[JoinFamily] fetching invite for token=" << token;
+    auto db = db::getDbClient(req);
+    LOG_DEBUG << "[JoinFamily] fetching invite for token=" << token;
     auto invite = co_await db->execSqlCoro("SELECT id_family, email, used_at from family_invite WHERE token = $1", token);
     if (invite.empty()) {
         auto resp = drogon::HttpResponse::newHttpResponse();
@@ -472,7 +488,7 @@ Task<HttpResponsePtr> UserController::JoinFamily(HttpRequestPtr req) {
         resp->setBody("Email mismatch");
         co_return resp;
     }
-    LOG_INFO << "[JoinFamily] fetching user by email=" << email;
+    LOG_DEBUG << "[JoinFamily] fetching user by email=" << email;
     auto user = co_await db->execSqlCoro("SELECT id, hashed_password from users WHERE email = $1", email);
     if (user.empty()) {
         auto resp = drogon::HttpResponse::newHttpResponse();
@@ -487,12 +503,10 @@ Task<HttpResponsePtr> UserController::JoinFamily(HttpRequestPtr req) {
         co_return resp;
     }
     int64_t user_id = user[0]["id"].as<int64_t>();
-    LOG_INFO << "[JoinFamily] user_id=" << user_id << " invite id_family=" << invite[0]["id_family"].as<int64_t>();
+    LOG_DEBUG << "[JoinFamily] user_id=" << user_id << " invite id_family=" << invite[0]["id_family"].as<int64_t>();
     
     // Проверяем, что пользователь не состоит уже в другой семье
-    auto existingMember = co_await db->execSqlCoro(
-        "SELECT id_family FROM family_members WHERE id_user = $1", user_id
-    );
+    auto existingMember = co_await db::exec(db, db::stmt::familyOfUser, user_id);
     if (!existingMember.empty()) {
         auto resp = drogon::HttpResponse::newHttpResponse();
         resp->setStatusCode(drogon::k400BadRequest);
@@ -500,11 +514,24 @@ Task<HttpResponsePtr> UserController::JoinFamily(HttpRequestPtr req) {
         co_return resp;
     }
     
-    LOG_INFO << "[JoinFamily] inserting into family_members";
-    co_await db->execSqlCoro("INSERT into family_members(id_family, id_user) VALUES ($1, $2)", 
+    // Членство и отметка об использовании приглашения — в одной транзакции: приглашение
+    // помечается только если ещё не использовано, так что два параллельных запроса с одним
+    // токеном не добавят двух участников
+    db::TxScope tx(db, co_await db->newTransactionCoro());
+    LOG_DEBUG << "[JoinFamily] marking invite used";
+    auto claimed = co_await tx.client()->execSqlCoro(
+        "UPDATE family_invite SET used_at = NOW() WHERE token = $1 AND used_at IS NULL", token);
+    if (claimed.affectedRows() == 0) {
+        auto resp = drogon::HttpResponse::newHttpResponse();
+        resp->setStatusCode(drogon::k400BadRequest);
+        resp->setBody("Invatation was already used");
+        co_return resp;
+    }
+    LOG_DEBUG << "[JoinFamily] inserting into family_members";
+    co_await tx.client()->execSqlCoro("INSERT into family_members(id_family, id_user) VALUES ($1, $2)",
         invite[0]["id_family"].as<int64_t>(), user_id);
-    LOG_INFO << "[JoinFamily] marking invite used";
-    co_await db->execSqlCoro("UPDATE family_invite SET used_at = NOW() WHERE token = $1", token);
+    co_await tx.commit();
+    db::familyChanged();
     std::string jwt = jwt_utils::createToken(user_id, email);
 
     // Если это form-data запрос, перенаправляем на страницу успеха
@@ -522,25 +549,30 @@ Task<HttpResponsePtr> UserController::JoinFamily(HttpRequestPtr req) {
     co_return resp;
 }
 
+// Страницы авторизации не зависят от запроса: view рендерится один раз и кешируется
+static std::string renderView(const std::string &name) {
+    drogon::HttpViewData data;
+    auto resp = drogon::HttpResponse::newHttpViewResponse(name, data);
+    return std::string(resp->getBody());
+}
+
 void UserController::ShowRegisterPage(const drogon::HttpRequestPtr& req,
                                       std::function<void(const drogon::HttpResponsePtr&)> &&callback) {
-    drogon::HttpViewData data;
-    auto resp = drogon::HttpResponse::newHttpViewResponse("auth_register.csp", data);
-    callback(resp);
+    static const pages::CachedPage page([](bool) { return renderView("auth_register.csp"); });
+    callback(page.get(req));
 }
 
 void UserController::ShowLoginPage(const drogon::HttpRequestPtr& req,
                                    std::function<void(const drogon::HttpResponsePtr&)> &&callback) {
-    drogon::HttpViewData data;
-    auto resp = drogon::HttpResponse::newHttpViewResponse("auth_login.csp", data);
-    callback(resp);
+    static const pages::CachedPage page([](bool) { return renderView("auth_login.csp"); });
+    callback(page.get(req));
 }
 
 void UserController::ShowLogoutPage(const drogon::HttpRequestPtr& req,
                                     std::function<void(const drogon::HttpResponsePtr&)> &&callback) {
-    drogon::HttpViewData data;
-    auto resp = drogon::HttpResponse::newHttpViewResponse("logout.csp", data);
-    callback(resp);
+    static const pages::CachedPage page([](bool) { return renderView("logout.csp"); },
+                                        {{"Set-Cookie", "token=; Path=/; HttpOnly; SameSite=Lax; Max-Age=0"}});
+    callback(page.get(req));
 }
 
 Task<HttpResponsePtr> UserController::GetFamily(HttpRequestPtr req) {
@@ -553,7 +585,7 @@ Task<HttpResponsePtr> UserController::GetFamily(HttpRequestPtr req) {
             co_return resp;
         }
 
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getDbClient(req);
         auto family = co_await db->execSqlCoro(
             R"(
             SELECT f.id, f.name, f.id_owner, f.created_at
@@ -599,7 +631,7 @@ Task<HttpResponsePtr> UserController::GetFamilyMembers(HttpRequestPtr req, int64
             co_return resp;
         }
 
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getDbClient(req);
         
         // Проверяем, что пользователь является членом семьи
         auto memberCheck = co_await db->execSqlCoro(
@@ -658,7 +690,7 @@ Task<HttpResponsePtr> UserController::LeaveFamily(HttpRequestPtr req, int64_t id
             co_return resp;
         }
 
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getDbClient(req);
         
         // Проверяем, что пользователь является членом семьи
         auto memberCheck = co_await db->execSqlCoro(
@@ -690,6 +722,7 @@ Task<HttpResponsePtr> UserController::LeaveFamily(HttpRequestPtr req, int64_t id
             "DELETE FROM family_members WHERE id_family = $1 AND id_user = $2",
             id_family, *userIdOpt
         );
+        db::familyChanged();
 
         auto resp = drogon::HttpResponse::newHttpResponse();
         resp->setStatusCode(drogon::k200OK);
@@ -714,7 +747,7 @@ Task<HttpResponsePtr> UserController::RemoveFamilyMember(HttpRequestPtr req, int
             co_return resp;
         }
 
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getDbClient(req);
         
         // Проверяем, что запрашивающий является владельцем семьи
         auto family = co_await db->execSqlCoro(
@@ -755,6 +788,7 @@ Task<HttpResponsePtr> UserController::RemoveFamilyMember(HttpRequestPtr req, int
             resp->setBody("User is not a member of this family");
             co_return resp;
         }
+        db::familyChanged();
 
         auto resp = drogon::HttpResponse::newHttpResponse();
         resp->setStatusCode(drogon::k200OK);
@@ -779,7 +813,7 @@ Task<HttpResponsePtr> UserController::GetFamilyInvites(HttpRequestPtr req) {
             co_return resp;
         }
 
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getDbClient(req);
         
         // Получаем email пользователя
         auto user = co_await db->execSqlCoro(
@@ -846,7 +880,7 @@ void UserController::ShowJoinFamily(const drogon::HttpRequestPtr& req,
         return;
     }
 
-    auto db = drogon::app().getFastDbClient();
+    auto db = db::getDbClient(req);
     db->execSqlAsync(
         "SELECT id_family, email, used_at FROM family_invite WHERE token = $1",
         [token, callback](const drogon::orm::Result &invite) {
@@ -864,49 +898,8 @@ void UserController::ShowJoinFamily(const drogon::HttpRequestPtr& req,
                 email = invite[0]["email"].as<std::string>();
             }
 
-            std::string html = R"(<!DOCTYPE html>
-<html>
-<head>
-    <meta charset="UTF-8">
-    <title>Присоединиться к семейному аккаунту</title>
-    <style>
-        body {
-            font-family: Arial, sans-serif;
-            max-width: 500px;
-            margin: 50px auto;
-            padding: 20px;
-        }
-        h1 { color: #333; }
-        .error {
-            color: red;
-            background-color: #ffe6e6;
-            padding: 10px;
-            border-radius: 5px;
-            margin-bottom: 20px;
-        }
-        form { display: flex; flex-direction: column; gap: 15px; }
-        input {
-            padding: 10px;
-            border: 1px solid #ddd;
-            border-radius: 5px;
-            font-size: 16px;
-        }
-        button {
-            padding: 10px 20px;
-            background-color: #4CAF50;
-            color: white;
-            border: none;
-            border-radius: 5px;
-            cursor: pointer;
-            font-size: 16px;
-        }
-        button:hover { background-color: #45a049; }
-        p { margin-top: 20px; }
-        a { color: #4CAF50; text-decoration: none; }
-        a:hover { text-decoration: underline; }
-    </style>
-</head>
-<body>
+            std::string html = pages::head("Присоединиться к семейному аккаунту", {assets::css_join_family_css});
+            html += R"(<body>
     <h1>Присоединиться к семейному аккаунту</h1>
 )";
 
@@ -953,7 +946,7 @@ void UserController::ShowCreateFamilyPage(const drogon::HttpRequestPtr& req,
     // Проверяем, не состоит ли уже пользователь в семье
     auto userIdOpt = jwt_utils::getUserIdFromRequest(req);
     if (userIdOpt) {
-        auto db = drogon::app().getFastDbClient();
+        auto db = db::getDbClient(req);
         auto family = db->execSqlSync(
             "SELECT 1 FROM family_members WHERE id_user = $1", *userIdOpt
         );
@@ -963,103 +956,15 @@ void UserController::ShowCreateFamilyPage(const drogon::HttpRequestPtr& req,
         }
     }
     
-    std::string html = R"(<!DOCTYPE html>
-<html>
-<head>
-    <meta charset="UTF-8">
-    <title>Создать семейный аккаунт</title>
-    <link rel="stylesheet" href="https://unpkg.com/sakura.css/css/sakura.css" />
-    <style>
-        .error {
-            color: red;
-            background-color: #ffe6e6;
-            padding: 10px;
-            border-radius: 5px;
-            margin-bottom: 20px;
-        }
-        form {
-            max-width: 500px;
-            margin: 20px 0;
-        }
-        input {
-            width: 100%;
-            padding: 10px;
-            margin: 10px 0;
-            border: 1px solid #ddd;
-            border-radius: 5px;
-        }
-        button {
-            padding: 10px 20px;
-            background-color: #4CAF50;
-            color: white;
-            border: none;
-            border-radius: 5px;
-            cursor: pointer;
-            font-size: 16px;
-        }
-        button:hover {
-            background-color: #45a049;
-        }
-    </style>
-</head>
-<body>
-    <h1>Создать семейный аккаунт</h1>
-)";
-    
-    if (hasError) {
-        html += "    <div class=\"error\">" + errorMessage + "</div>\n";
+    if (!hasError) {
+        static const pages::CachedPage page([](bool) { return pages::renderCreateFamilyPage({}); });
+        callback(page.get(req));
+        return;
     }
-    
-    html += R"(    <form id="createFamilyForm">
-        <label for="name">Название семьи:</label>
-        <input type="text" id="name" name="name" required placeholder="Например: Семья Ивановых">
-        <button type="submit">Создать семью</button>
-    </form>
-    
-    <p><a href="/home">Вернуться на главную</a></p>
-    
-    <script>
-        document.getElementById("createFamilyForm").addEventListener("submit", async function(e) {
-            e.preventDefault();
-            
-            const name = document.getElementById("name").value;
-            const token = localStorage.getItem("authToken") || localStorage.getItem("token") || getCookie("token");
-            
-            try {
-                const response = await fetch("/api/family", {
-                    method: "POST",
-                    headers: {
-                        "Content-Type": "application/json",
-                        "Authorization": "Bearer " + token
-                    },
-                    body: JSON.stringify({ name: name })
-                });
-                
-                if (response.ok) {
-                    alert("Семья успешно создана!");
-                    window.location.href = "/home";
-                } else {
-                    const error = await response.text();
-                    alert("Ошибка: " + error);
-                }
-            } catch (error) {
-                alert("Ошибка при создании семьи: " + error.message);
-            }
-        });
-        
-        function getCookie(name) {
-            const value = "; " + document.cookie;
-            const parts = value.split("; " + name + "=");
-            if (parts.length === 2) return parts.pop().split(";").shift();
-        }
-    </script>
-</body>
-</html>
-)";
-    
     auto resp = drogon::HttpResponse::newHttpResponse();
-    resp->setBody(html);
+    resp->setBody(pages::renderCreateFamilyPage(errorMessage));
     resp->setContentTypeCode(drogon::CT_TEXT_HTML);
+    resp->addHeader("Cache-Control", "private, no-store");
     callback(resp);
 }
 
@@ -1073,7 +978,7 @@ void UserController::ShowFamilyMembersPage(const drogon::HttpRequestPtr& req,
         callback(resp);
         return;
     }
-    auto db = drogon::app().getFastDbClient();
+    auto db = db::getDbClient(req);
     db->execSqlAsync(
         R"(
         SELECT f.id, f.name, f.id_owner
@@ -1082,40 +987,8 @@ void UserController::ShowFamilyMembersPage(const drogon::HttpRequestPtr& req,
         WHERE fm.id_user = $1
         )",
         [callback, userIdOpt](const drogon::orm::Result &family) {
-            std::string html = R"(<!DOCTYPE html>
-<html>
-<head>
-    <meta charset="UTF-8">
-    <title>Члены семьи</title>
-    <link rel="stylesheet" href="https://unpkg.com/sakura.css/css/sakura.css" />
-    <style>
-        .error {
-            color: red;
-            background-color: #ffe6e6;
-            padding: 10px;
-            border-radius: 5px;
-            margin-bottom: 20px;
-        }
-        .member-list { margin: 20px 0; }
-        .member-item {
-            padding: 15px;
-            border: 1px solid #ddd;
-            border-radius: 5px;
-            margin: 10px 0;
-            background-color: #f9f9f9;
-        }
-        .owner-badge {
-            background-color: #ff9800;
-            color: white;
-            padding: 3px 8px;
-            border-radius: 3px;
-            font-size: 12px;
-            margin-left: 10px;
-        }
-    </style>
-</head>
-<body>
-)";
+            std::string html = pages::head("Члены семьи", {assets::css_sakura_css, assets::css_family_css});
+            html += "<body>\n";
 
             if (family.empty()) {
                 html += "    <h1>Члены семьи</h1>\n";
@@ -1128,75 +1001,10 @@ void UserController::ShowFamilyMembersPage(const drogon::HttpRequestPtr& req,
                 (void)isOwner; // пока не используется в HTML
                 
                 html += "    <h1>Члены семьи: " + familyName + "</h1>\n";
-                html += "    <div id=\"membersContainer\">\n";
+                html += "    <div id=\"membersContainer\" data-family-id=\"" + std::to_string(familyId) + "\">\n";
                 html += "        <p>Загрузка списка членов...</p>\n";
                 html += "    </div>\n";
-                
-                html += R"(
-    <script>
-        async function loadMembers() {
-            const token = localStorage.getItem("authToken") || localStorage.getItem("token") || getCookie("token");
-            const familyId = )" + std::to_string(familyId) + R"(;
-            
-            try {
-                const response = await fetch("/api/family/" + familyId + "/members", {
-                    headers: {
-                        "Authorization": "Bearer " + token
-                    }
-                });
-                
-                if (response.ok) {
-                    const members = await response.json();
-                    displayMembers(members);
-                } else {
-                    document.getElementById("membersContainer").innerHTML = 
-                        "<div class=\"error\">Ошибка при загрузке списка членов</div>";
-                }
-            } catch (error) {
-                document.getElementById("membersContainer").innerHTML = 
-                    "<div class=\"error\">Ошибка: " + error.message + "</div>";
-            }
-        }
-        
-        function displayMembers(members) {
-            const container = document.getElementById("membersContainer");
-            
-            if (members.length === 0) {
-                container.innerHTML = "<p>В семье пока нет других членов.</p>";
-                return;
-            }
-            
-            let html = "<div class=\"member-list\">";
-            members.forEach(member => {
-                html += "<div class=\"member-item\">";
-                html += "<strong>" + escapeHtml(member.name) + "</strong>";
-                if (member.is_owner) {
-                    html += "<span class=\"owner-badge\">Владелец</span>";
-                }
-                html += "<p>Email: " + escapeHtml(member.email) + "</p>";
-                html += "<p>Присоединился: " + new Date(member.joined_at).toLocaleDateString("ru-RU") + "</p>";
-                html += "</div>";
-            });
-            html += "</div>";
-            
-            container.innerHTML = html;
-        }
-        
-        function escapeHtml(text) {
-            const div = document.createElement("div");
-            div.textContent = text;
-            return div.innerHTML;
-        }
-        
-        function getCookie(name) {
-            const value = "; " + document.cookie;
-            const parts = value.split("; " + name + "=");
-            if (parts.length === 2) return parts.pop().split(";").shift();
-        }
-        
-        loadMembers();
-    </script>
-)";
+                html += pages::script(assets::js_family_members_js);
             }
             
             html += R"(
@@ -1223,50 +1031,8 @@ void UserController::ShowFamilyMembersPage(const drogon::HttpRequestPtr& req,
 
 void UserController::ShowInviteFamilyPage(const drogon::HttpRequestPtr& req,
                                          std::function<void(const drogon::HttpResponsePtr&)> &&callback) {
-    std::string html = R"HTML(<!DOCTYPE html>
-<html>
-<head>
-    <meta charset="UTF-8">
-    <title>Пригласить в семью</title>
-    <link rel="stylesheet" href="https://unpkg.com/sakura.css/css/sakura.css" />
-    <style>
-        .error {
-            color: red;
-            background-color: #ffe6e6;
-            padding: 10px;
-            border-radius: 5px;
-            margin-bottom: 20px;
-        }
-        .loading {
-            color: #666;
-            font-style: italic;
-        }
-        form {
-            max-width: 500px;
-            margin: 20px 0;
-        }
-        input {
-            width: 100%;
-            padding: 10px;
-            margin: 10px 0;
-            border: 1px solid #ddd;
-            border-radius: 5px;
-        }
-        button {
-            padding: 10px 20px;
-            background-color: #4CAF50;
-            color: white;
-            border: none;
-            border-radius: 5px;
-            cursor: pointer;
-            font-size: 16px;
-        }
-        button:hover {
-            background-color: #45a049;
-        }
-    </style>
-</head>
-<body>
+    std::string html = pages::head("Пригласить в семью", {assets::css_sakura_css, assets::css_family_css});
+    html += R"HTML(<body>
     <h1>Пригласить в семью</h1>
     <div id="loadingMessage" class="loading">Загрузка...</div>
     <div id="errorMessage" class="error" style="display: none;"></div>
@@ -1278,88 +1044,9 @@ void UserController::ShowInviteFamilyPage(const drogon::HttpRequestPtr& req,
         </form>
     </div>
     
-    <script>
-        const token = localStorage.getItem("authToken") || localStorage.getItem("token");
-        if (!token) {
-            document.getElementById("loadingMessage").style.display = "none";
-            document.getElementById("errorMessage").textContent = "Вы не авторизованы. Пожалуйста, войдите в систему.";
-            document.getElementById("errorMessage").style.display = "block";
-            setTimeout(() => {
-                window.location.href = "/auth/login";
-            }, 2000);
-        } else {
-            loadFamilyInfo();
-        }
-        
-        async function loadFamilyInfo() {
-            try {
-                const response = await fetch("/api/family", {
-                    headers: {
-                        "Authorization": "Bearer " + token
-                    }
-                });
-                
-                if (!response.ok) {
-                    if (response.status === 401) {
-                        document.getElementById("loadingMessage").style.display = "none";
-                        document.getElementById("errorMessage").textContent = "Ошибка авторизации. Пожалуйста, войдите в систему.";
-                        document.getElementById("errorMessage").style.display = "block";
-                        setTimeout(() => {
-                            window.location.href = "/auth/login";
-                        }, 2000);
-                        return;
-                    }
-                    const error = await response.text();
-                    throw new Error(error);
-                }
-                
-                const family = await response.json();
-                if (!family || !family.id) {
-                    document.getElementById("loadingMessage").style.display = "none";
-                    document.getElementById("errorMessage").textContent = "Вы не состоите в семье";
-                    document.getElementById("errorMessage").style.display = "block";
-                    return;
-                }
-                
-                document.getElementById("loadingMessage").style.display = "none";
-                document.getElementById("inviteFormContainer").style.display = "block";
-                document.querySelector("h1").textContent = "Пригласить в семью: " + family.name;
-                
-                document.getElementById("inviteForm").addEventListener("submit", async function(e) {
-                    e.preventDefault();
-                    
-                    const email = document.getElementById("email").value;
-                    
-                    try {
-                        const inviteResponse = await fetch("/api/family/" + family.id + "/invite", {
-                            method: "POST",
-                            headers: {
-                                "Content-Type": "application/json",
-                                "Authorization": "Bearer " + token
-                            },
-                            body: JSON.stringify({ email: email })
-                        });
-                        
-                        if (inviteResponse.ok) {
-                            const result = await inviteResponse.json();
-                            alert("Приглашение успешно отправлено на " + email + "!\\nСсылка: " + result.join_url);
-                            document.getElementById("email").value = "";
-                        } else {
-                            const error = await inviteResponse.text();
-                            alert("Ошибка: " + error);
-                        }
-                    } catch (error) {
-                        alert("Ошибка при отправке приглашения: " + error.message);
-                    }
-                });
-            } catch (error) {
-                document.getElementById("loadingMessage").style.display = "none";
-                document.getElementById("errorMessage").textContent = "Ошибка: " + error.message;
-                document.getElementById("errorMessage").style.display = "block";
-            }
-        }
-    </script>
-    <p><a href="/home">Вернуться на главную</a></p>
+)HTML";
+    html += pages::script(assets::js_invite_family_js);
+    html += R"HTML(    <p><a href="/home">Вернуться на главную</a></p>
 </body>
 </html>
 )HTML";
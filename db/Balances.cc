@@ -0,0 +1,38 @@
+#include "Balances.h"
+#include <algorithm>
+#include "Statements.h"
+#include "utils/AmountUtils.h"
+
+namespace db {
+
+drogon::Task<std::optional<int32_t>> applyBalanceChanges(drogon::orm::DbClientPtr client,
+                                                         std::vector<BalanceChange> changes) {
+    std::sort(changes.begin(), changes.end(),
+              [](const BalanceChange &a, const BalanceChange &b) { return a.idAccount < b.idAccount; });
+    for (size_t i = 0; i < changes.size();) {
+        BalanceChange change = changes[i];
+        for (++i; i < changes.size() && changes[i].idAccount == change.idAccount; ++i) {
+            change.delta += changes[i].delta;
+            change.checkNonNegative = change.checkNonNegative || changes[i].checkNonNegative;
+        }
+        if (change.delta == 0) {
+            continue;
+        }
+        const auto delta = amount_utils::amountToString(change.delta);
+        // Пустой RETURNING — счёт удалён или (для проверяемого расхода) не хватает средств
+        bool applied = false;
+        if (change.checkNonNegative && change.delta < 0) {
+            auto rows = co_await exec(client, stmt::accountAddBalanceChecked, change.idAccount, delta);
+            applied = !rows.empty();
+        } else {
+            auto rows = co_await exec(client, stmt::accountAddBalance, change.idAccount, delta);
+            applied = !rows.empty();
+        }
+        if (!applied) {
+            co_return change.idAccount;
+        }
+    }
+    co_return std::nullopt;
+}
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include <drogon/orm/DbClient.h>
+#include <drogon/utils/coroutine.h>
+
+// Изменение балансов счетов внутри транзакции записи (db::TxScope). Баланс меняется
+// приращением к текущему значению строки (stmt::accountAddBalance), а не записью значения,
+// прочитанного до транзакции: одновременные записи по тому же счёту — пакеты
+// db/GroupCommit.h, другие переводы и правки — не теряются. Строки счетов блокируются
+// в порядке id, поэтому встречные переводы между двумя счетами не ждут друг друга по кругу.
+namespace db {
+
+struct BalanceChange {
+    int32_t idAccount = 0;
+    double delta = 0;
+    // Баланс не должен уйти в минус (расход, перевод со счёта)
+    bool checkNonNegative = false;
+};
+
+// Применяет изменения; изменения одного счёта складываются, счёт с нулевой суммой
+// не трогается. Возвращает счёт, баланс которого ушёл бы в минус или который уже удалён
+// (UPDATE не вернул строку), — обработчик отвечает 400, и TxScope откатывает транзакцию
+drogon::Task<std::optional<int32_t>> applyBalanceChanges(drogon::orm::DbClientPtr client,
+                                                         std::vector<BalanceChange> changes);
+
+}
@@ -0,0 +1,61 @@
+#include "ChangeLog.h"
+#include <drogon/HttpAppFramework.h>
+#include <trantor/utils/Logger.h>
+#include "DataBase.h"
+
+namespace db {
+
+static ChangeLogOptions g_options;
+
+const ChangeLogOptions &loadChangeLogOptions() {
+    const auto &cfg = drogon::app().getCustomConfig()["sync"];
+    if (cfg.isObject()) {
+        g_options.retentionDays = cfg.get("retention_days", 0.0).asDouble();
+        g_options.cleanupIntervalSec = cfg.get("cleanup_interval_sec", 3600.0).asDouble();
+    }
+    return g_options;
+}
+
+const ChangeLogOptions &changeLogOptions() {
+    return g_options;
+}
+
+drogon::Task<int64_t> changeLogHorizon(drogon::orm::DbClientPtr client) {
+    if (g_options.retentionDays <= 0) {
+        co_return 0;
+    }
+    auto rows = co_await client->execSqlCoro(
+        "/*change_log_horizon_v1*/ SELECT pruned_before FROM change_log_horizon");
+    co_return rows.empty() ? 0 : rows[0]["pruned_before"].as<int64_t>();
+}
+
+void scheduleChangeLogCleanup() {
+    if (g_options.retentionDays <= 0) {
+        return;
+    }
+    // Граница — txid новее всех удаляемых записей. Удаление и сдвиг границы — один запрос,
+    // поэтому клиент не увидит удалённый хвост журнала без 410
+    drogon::app().getLoop()->runEvery(g_options.cleanupIntervalSec, [] {
+        getDbClient()->execSqlAsync(
+            R"(
+            /*change_log_cleanup_v1*/
+            WITH cut AS (
+                SELECT max(txid) + 1 AS upto FROM change_log
+                WHERE changed_at < NOW() - make_interval(secs => $1::float8)
+            ),
+            removed AS (
+                DELETE FROM change_log WHERE txid < (SELECT upto FROM cut)
+            )
+            UPDATE change_log_horizon
+            SET pruned_before = GREATEST(pruned_before, (SELECT upto FROM cut))
+            WHERE (SELECT upto FROM cut) IS NOT NULL
+            )",
+            [](const drogon::orm::Result &) {},
+            [](const drogon::orm::DrogonDbException &e) {
+                LOG_ERROR << "Change log cleanup error: " << e.base().what();
+            },
+            g_options.retentionDays * 86400);
+    });
+}
+
+}
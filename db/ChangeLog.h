@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <drogon/utils/coroutine.h>
+#include <drogon/orm/DbClient.h>
+
+// Очистка журнала изменений для GET /sync (db/migrations/001_change_log.sql). Записи старше
+// retention_days удаляются, а граница удаления (txid) сохраняется в change_log_horizon
+// (db/migrations/003_change_log_horizon.sql). Курсор клиента старше границы означает, что
+// часть изменений уже потеряна: /sync отвечает 410, и клиент загружает коллекции заново.
+namespace db {
+
+struct ChangeLogOptions {
+    // Сколько хранятся записи журнала, дни. 0 — без очистки (миграция 003 не нужна)
+    double retentionDays = 0;
+    // Период очистки, с
+    double cleanupIntervalSec = 3600;
+};
+
+// custom_config.sync из config.json. Вызывать после loadConfigFile
+const ChangeLogOptions &loadChangeLogOptions();
+
+// Настройки, прочитанные loadChangeLogOptions()
+const ChangeLogOptions &changeLogOptions();
+
+// Граница очистки: курсоры меньше неё устарели. 0, если очистка выключена
+drogon::Task<int64_t> changeLogHorizon(drogon::orm::DbClientPtr client);
+
+// Периодически удаляет старые записи и сдвигает границу. Вызывать до app().run()
+void scheduleChangeLogCleanup();
+
+}
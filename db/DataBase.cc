@@ -0,0 +1,94 @@
+#include "DataBase.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <sys/mman.h>
+#include "utils/JwtUtils.h"
+
+namespace db {
+
+static ReplicaOptions g_replicaOptions;
+
+const ReplicaOptions &loadReplicaOptions() {
+    const auto &cfg = drogon::app().getCustomConfig()["read_replica"];
+    if (cfg.isObject()) {
+        g_replicaOptions.client = cfg.get("client", "").asString();
+        g_replicaOptions.lagWindowMs = cfg.get("lag_window_ms", 5000.0).asDouble();
+    }
+    if (const char *env = std::getenv("FM_READ_REPLICA")) {
+        g_replicaOptions.client = env;
+    }
+    return g_replicaOptions;
+}
+
+const ReplicaOptions &replicaOptions() {
+    return g_replicaOptions;
+}
+
+// Время последней записи (мс от эпохи) по полосам пользователей и по всем сразу.
+// Совпадение полос даёт лишнее чтение из основной базы, но не устаревшие данные
+struct WriteMarks {
+    std::array<std::atomic<int64_t>, 4096> byUser{};
+    std::atomic<int64_t> any{0};
+};
+
+// Как эпохи списков (db/ListQueries.cc): общая анонимная память, созданная до fork(),
+// чтобы запись в одном рабочем процессе видели все
+static WriteMarks *createMarks() {
+    void *mem = mmap(nullptr, sizeof(WriteMarks), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        return new WriteMarks();
+    }
+    return new (mem) WriteMarks();
+}
+
+static WriteMarks *const marks = createMarks();
+
+static const std::string kWriteCookie = "fm_rw";
+
+static int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+static std::atomic<int64_t> &userMark(int64_t userId) {
+    return marks->byUser[static_cast<uint64_t>(userId) % marks->byUser.size()];
+}
+
+static bool withinWindow(int64_t writtenMs) {
+    return writtenMs > 0 && static_cast<double>(nowMs() - writtenMs) < g_replicaOptions.lagWindowMs;
+}
+
+void noteWrite(int64_t userId, const drogon::HttpResponsePtr &resp) {
+    if (g_replicaOptions.client.empty()) {
+        return;
+    }
+    const int64_t now = nowMs();
+    userMark(userId).store(now, std::memory_order_release);
+    marks->any.store(now, std::memory_order_release);
+
+    drogon::Cookie cookie(kWriteCookie, std::to_string(now));
+    cookie.setPath("/");
+    cookie.setHttpOnly(true);
+    cookie.setExpiresDate(trantor::Date::now().after(g_replicaOptions.lagWindowMs / 1000.0));
+    resp->addCookie(std::move(cookie));
+}
+
+bool readsFromPrimary(const drogon::HttpRequestPtr &req) {
+    const auto &cookie = req->getCookie(kWriteCookie);
+    if (!cookie.empty() && withinWindow(std::atoll(cookie.c_str()))) {
+        return true;
+    }
+    auto userId = jwt_utils::getUserIdFromRequest(req);
+    return userId && withinWindow(userMark(*userId).load(std::memory_order_acquire));
+}
+
+bool mayBeStale(const drogon::orm::DbClientPtr &client) {
+    auto metered = std::dynamic_pointer_cast<MeteredDbClient>(client);
+    return metered && metered->isReplica() && withinWindow(marks->any.load(std::memory_order_acquire));
+}
+
+}
@@ -1,12 +1,92 @@
 #pragma once
 #include <drogon/orm/DbClient.h>
 #include <drogon/drogon.h>
+#include "db/MeteredDbClient.h"
+#include "utils/Metrics.h"
+#include "utils/Profiling.h"
+#include <string>
 
 namespace db {
 
-inline drogon::orm::DbClientPtr getDbClient() {
-    static auto client = drogon::app().getFastDbClient("default");
+// Чтение с реплики. Клиент реплики — отдельная запись в db_clients (например, "replica"),
+// его имя — в custom_config.read_replica.client (или FM_READ_REPLICA). Пусто — все запросы
+// идут в основную базу
+struct ReplicaOptions {
+    std::string client;
+    // Сколько после записи пользователя его чтения идут в основную базу (read-your-writes).
+    // Должно быть больше обычного отставания реплики
+    double lagWindowMs = 5000;
+};
+
+// Вызывать после loadConfigFile
+const ReplicaOptions &loadReplicaOptions();
+
+const ReplicaOptions &replicaOptions();
+
+// Запоминает запись пользователя: отметка в общей памяти процессов (по ней решает
+// getReadDbClient) и cookie fm_rw с временем записи — для других серверов за балансировщиком.
+// Вызывается после успешного изменяющего запроса (см. main.cc)
+void noteWrite(int64_t userId, const drogon::HttpResponsePtr &resp);
+
+// Автор запроса что-то менял в пределах lagWindowMs: читать нужно из основной базы
+bool readsFromPrimary(const drogon::HttpRequestPtr &req);
+
+// Данные, прочитанные через client, могут не содержать недавних записей других
+// пользователей: это реплика, а запись была в пределах lagWindowMs. Такие данные
+// не кладутся в кеш списков (db/ListQueries.h)
+bool mayBeStale(const drogon::orm::DbClientPtr &client);
+
+namespace detail {
+inline drogon::orm::DbClientPtr &overrideClient() {
+    static drogon::orm::DbClientPtr client;
     return client;
 }
 
-}
\ No newline at end of file
+inline drogon::orm::DbClientPtr baseClient() {
+    if (const auto &client = detail::overrideClient()) {
+        return client;
+    }
+    return drogon::app().getFastDbClient();
+}
+}
+
+// Клиент БД для текущего запроса: быстрый клиент IO-потока, в котором выполняется обработчик.
+// Не кешируется в static: у каждого event loop свой клиент. Запросы через него попадают
+// в метрики по тегам (db/MeteredDbClient.h)
+inline drogon::orm::DbClientPtr getDbClient() {
+    return std::make_shared<MeteredDbClient>(detail::baseClient(), nullptr);
+}
+
+// То же, но запросы к БД дополнительно засчитываются HTTP-запросу req
+// (fm_http_db_queries_per_request и fm_http_db_rows_per_request) и его профилю
+// и проверяют срок запроса (utils/Deadline.h)
+inline drogon::orm::DbClientPtr getDbClient(const drogon::HttpRequestPtr &req) {
+    return std::make_shared<MeteredDbClient>(detail::baseClient(),
+                                             metrics::requestDbStats(req),
+                                             profiling::requestTrace(req),
+                                             false,
+                                             deadline::requestDeadline(req));
+}
+
+// Клиент для чтения в обработчиках GET: быстрый клиент реплики, если она настроена и автор
+// запроса недавно ничего не менял, иначе — тот же, что getDbClient(req). Не использовать
+// для запросов, после которых в том же обработчике идёт запись
+inline drogon::orm::DbClientPtr getReadDbClient(const drogon::HttpRequestPtr &req) {
+    const auto &replica = replicaOptions().client;
+    if (replica.empty() || detail::overrideClient() || readsFromPrimary(req)) {
+        return getDbClient(req);
+    }
+    return std::make_shared<MeteredDbClient>(drogon::app().getFastDbClient(replica),
+                                             metrics::requestDbStats(req),
+                                             profiling::requestTrace(req),
+                                             true,
+                                             deadline::requestDeadline(req));
+}
+
+// Подменяет клиент для всех обработчиков (например, на db::FakeDbClient в бенчмарках).
+// Вызывается до начала обработки запросов; nullptr возвращает обычное поведение
+inline void setDbClientOverride(drogon::orm::DbClientPtr client) {
+    detail::overrideClient() = std::move(client);
+}
+
+}
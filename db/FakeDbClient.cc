@@ -0,0 +1,846 @@
+#include "FakeDbClient.h"
+#include <drogon/orm/Exception.h>
+#include <drogon/orm/Result.h>
+#include <drogon/orm/ResultImpl.h>
+#include <trantor/net/EventLoop.h>
+#include <trantor/net/EventLoopThread.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <regex>
+#include <sstream>
+#include <jsoncpp/json/json.h>
+#include "models/Account.h"
+#include "models/Budgets.h"
+#include "models/Category.h"
+#include "models/Families.h"
+#include "models/FamilyInvite.h"
+#include "models/FamilyMembers.h"
+#include "models/Transactions.h"
+#include "models/Transfer.h"
+#include "models/Users.h"
+#include "utils/AmountUtils.h"
+
+using namespace drogon_model::financial_manager;
+
+namespace db {
+
+// Разобранный запрос; разбирается один раз на текст SQL
+struct FakeDbClient::Statement {
+    enum class Kind { Custom, Select, Insert, Update, Delete };
+    struct Condition {
+        std::string column;
+        size_t param = 0;  // 0 — сравнение с literal
+        std::string literal;
+    };
+
+    Kind kind = Kind::Custom;
+    const Handler *handler = nullptr;
+    std::string table;
+    std::vector<std::string> columns;  // SELECT: пусто означает *
+    std::vector<Condition> where;
+    std::string orderBy;
+    bool descending = false;
+    std::vector<std::pair<std::string, size_t>> assignments;  // INSERT/UPDATE: колонка -> $n (0 — default)
+    bool returning = false;
+};
+
+// Result поверх строк в памяти; значения уже в текстовом виде, как у libpq
+class FakeResult : public drogon::orm::ResultImpl {
+public:
+    explicit FakeResult(FakeDbClient::Rows rows) : rows_(std::move(rows)) {}
+
+    SizeType size() const noexcept override {
+        return rows_.rows.size();
+    }
+    RowSizeType columns() const noexcept override {
+        return rows_.columns.size();
+    }
+    const char *columnName(RowSizeType number) const override {
+        return rows_.columns.at(number).c_str();
+    }
+    SizeType affectedRows() const noexcept override {
+        return rows_.affectedRows;
+    }
+    RowSizeType columnNumber(const char colName[]) const override {
+        for (RowSizeType i = 0; i < rows_.columns.size(); ++i) {
+            if (rows_.columns[i] == colName) {
+                return i;
+            }
+        }
+        throw drogon::orm::RangeError(std::string("there is no column named ") + colName);
+    }
+    const char *getValue(SizeType row, RowSizeType column) const override {
+        const auto &v = rows_.rows.at(row).at(column);
+        return v ? v->c_str() : nullptr;
+    }
+    bool isNull(SizeType row, RowSizeType column) const override {
+        return !rows_.rows.at(row).at(column).has_value();
+    }
+    FieldSizeType getLength(SizeType row, RowSizeType column) const override {
+        const auto &v = rows_.rows.at(row).at(column);
+        return v ? v->size() : 0;
+    }
+
+private:
+    FakeDbClient::Rows rows_;
+};
+
+// Транзакция поверх того же клиента: запросы выполняются сразу, rollback изменений не откатывает
+class FakeTransaction : public drogon::orm::Transaction, public std::enable_shared_from_this<FakeTransaction> {
+public:
+    FakeTransaction(std::shared_ptr<FakeDbClient> client, std::function<void(bool)> commitCallback)
+        : client_(std::move(client)), commitCallback_(std::move(commitCallback)) {
+        type_ = drogon::orm::ClientType::PostgreSQL;
+        connectionInfo_ = client_->connectionInfo();
+    }
+    ~FakeTransaction() override {
+        if (commitCallback_) {
+            commitCallback_(!rolledBack_);
+        }
+    }
+
+    void execSql(const char *sql,
+                 size_t sqlLength,
+                 size_t paraNum,
+                 std::vector<const char *> &&parameters,
+                 std::vector<int> &&length,
+                 std::vector<int> &&format,
+                 drogon::orm::ResultCallback &&rcb,
+                 std::function<void(const std::exception_ptr &)> &&exceptCallback) override {
+        client_->execSql(sql, sqlLength, paraNum, std::move(parameters), std::move(length), std::move(format),
+                         std::move(rcb), std::move(exceptCallback));
+    }
+    std::shared_ptr<drogon::orm::Transaction> newTransaction(const std::function<void(bool)> &) noexcept(false) override {
+        return shared_from_this();
+    }
+    void newTransactionAsync(
+        const std::function<void(const std::shared_ptr<drogon::orm::Transaction> &)> &callback) override {
+        callback(shared_from_this());
+    }
+    bool hasAvailableConnections() const noexcept override {
+        return true;
+    }
+    void setTimeout(double) override {}
+    void closeAll() override {}
+    void rollback() override {
+        rolledBack_ = true;
+    }
+    void setCommitCallback(const std::function<void(bool)> &commitCallback) override {
+        commitCallback_ = commitCallback;
+    }
+
+private:
+    std::shared_ptr<FakeDbClient> client_;
+    std::function<void(bool)> commitCallback_;
+    bool rolledBack_ = false;
+};
+
+static std::string unquote(std::string name) {
+    name.erase(std::remove(name.begin(), name.end(), '"'), name.end());
+    auto dot = name.rfind('.');
+    return dot == std::string::npos ? name : name.substr(dot + 1);
+}
+
+static std::string trim(const std::string &s) {
+    auto begin = s.find_first_not_of(' ');
+    auto end = s.find_last_not_of(' ');
+    return begin == std::string::npos ? std::string() : s.substr(begin, end - begin + 1);
+}
+
+static std::vector<std::string> split(const std::string &s, char sep) {
+    std::vector<std::string> parts;
+    size_t pos = 0;
+    while (true) {
+        size_t next = s.find(sep, pos);
+        parts.push_back(trim(s.substr(pos, next == std::string::npos ? std::string::npos : next - pos)));
+        if (next == std::string::npos) {
+            return parts;
+        }
+        pos = next + 1;
+    }
+}
+
+// Текст без комментариев, пробелы схлопнуты; tag — имя из первого /*tag*/
+static std::string normalize(const std::string &sql, std::string *tag = nullptr) {
+    std::string out;
+    bool space = false;
+    for (size_t i = 0; i < sql.size(); ++i) {
+        if (sql.compare(i, 2, "/*") == 0) {
+            size_t end = sql.find("*/", i + 2);
+            if (end == std::string::npos) {
+                break;
+            }
+            if (tag && tag->empty()) {
+                *tag = trim(sql.substr(i + 2, end - i - 2));
+            }
+            i = end + 1;
+            space = true;
+            continue;
+        }
+        if (std::isspace(static_cast<unsigned char>(sql[i]))) {
+            space = true;
+            continue;
+        }
+        if (space && !out.empty()) {
+            out += ' ';
+        }
+        space = false;
+        out += sql[i];
+    }
+    while (!out.empty() && out.back() == ';') {
+        out.pop_back();
+    }
+    return trim(out);
+}
+
+static bool isNumber(const std::string &s) {
+    if (s.empty()) {
+        return false;
+    }
+    char *end = nullptr;
+    std::strtod(s.c_str(), &end);
+    return end == s.c_str() + s.size();
+}
+
+// Сравнение так, как его видит Postgres для значений одного типа: bool и числа — по значению
+static bool sameValue(const FakeDbClient::Value &a, const std::string &b) {
+    if (!a) {
+        return false;
+    }
+    auto canon = [](const std::string &v) -> std::string {
+        if (v == "t" || v == "true" || v == "TRUE") return "t";
+        if (v == "f" || v == "false" || v == "FALSE") return "f";
+        return v;
+    };
+    if (isNumber(*a) && isNumber(b)) {
+        return std::stod(*a) == std::stod(b);
+    }
+    return canon(*a) == canon(b);
+}
+
+// Параметры в том виде, как их передаёт SqlBinder для PostgreSQL: целые и bool — в бинарном
+// формате (сетевой порядок байт), остальное — текстом
+static FakeDbClient::Value decodeParam(const char *data, int length, int format) {
+    if (!data) {
+        return std::nullopt;
+    }
+    if (format == 0) {
+        return length > 0 ? std::string(data, static_cast<size_t>(length)) : std::string(data);
+    }
+    if (length == 1) {
+        return std::string(data[0] ? "t" : "f");
+    }
+    int64_t v = 0;
+    for (int i = 0; i < length; ++i) {
+        v = (v << 8) | static_cast<unsigned char>(data[i]);
+    }
+    if (length == 2) {
+        v = static_cast<int16_t>(v);
+    } else if (length == 4) {
+        v = static_cast<int32_t>(v);
+    }
+    return std::to_string(v);
+}
+
+static std::string now() {
+    std::time_t t = std::time(nullptr);
+    std::tm tm{};
+    localtime_r(&t, &tm);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm);
+    return buf;
+}
+
+FakeDbClient::FakeDbClient() {
+    type_ = drogon::orm::ClientType::PostgreSQL;
+    connectionInfo_ = "fake";
+}
+
+FakeDbClient::~FakeDbClient() = default;
+
+void FakeDbClient::addTable(const std::string &name,
+                            std::vector<std::string> columns,
+                            std::map<std::string, std::string> defaults) {
+    std::lock_guard lock(mutex_);
+    Table t;
+    for (size_t i = 0; i < columns.size(); ++i) {
+        t.index[columns[i]] = i;
+    }
+    t.columns = std::move(columns);
+    t.defaults = std::move(defaults);
+    tables_[unquote(name)] = std::move(t);
+}
+
+// Ключи Idempotency-Key (db/Idempotency.h). expires_at хранится секундами Unix-времени
+static double unixNow() {
+    return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static void addIdempotencyHandlers(FakeDbClient &client) {
+    using Rows = FakeDbClient::Rows;
+    using Params = FakeDbClient::Params;
+    client.addTable("idempotency_keys",
+                    {"id_user", "idem_key", "request_hash", "status", "content_type", "body", "expires_at"});
+    const auto keyOf = [](const Params &params) {
+        return std::map<std::string, std::string>{{"id_user", params.at(0).value_or("")},
+                                                  {"idem_key", params.at(1).value_or("")}};
+    };
+    const auto expiresAt = [](const Rows &rows) {
+        const auto col = std::find(rows.columns.begin(), rows.columns.end(), "expires_at");
+        return std::stod(rows.rows.front()[static_cast<size_t>(col - rows.columns.begin())].value_or("0"));
+    };
+    client.onQuery("idempotency_claim_v1", [keyOf, expiresAt](FakeDbClient &db, const Params &params) {
+        Rows out{{"id_user"}, {}, 0};
+        auto existing = db.select("idempotency_keys", keyOf(params));
+        if (!existing.rows.empty()) {
+            if (expiresAt(existing) >= unixNow()) {
+                return out;
+            }
+            db.remove("idempotency_keys", keyOf(params));
+        }
+        auto values = keyOf(params);
+        values["request_hash"] = params.at(2).value_or("");
+        values["expires_at"] = std::to_string(unixNow() + std::stod(params.at(3).value_or("0")));
+        db.insert("idempotency_keys", values);
+        out.rows.push_back({params.at(0)});
+        out.affectedRows = 1;
+        return out;
+    });
+    client.onQuery("idempotency_lookup_v1", [keyOf, expiresAt](FakeDbClient &db, const Params &params) {
+        Rows out{{"request_hash", "status", "content_type", "body", "expired"}, {}, 0};
+        auto existing = db.select("idempotency_keys", keyOf(params));
+        if (existing.rows.empty()) {
+            return out;
+        }
+        const auto &row = existing.rows.front();
+        out.rows.push_back({row[2], row[3], row[4], row[5], expiresAt(existing) < unixNow() ? "t" : "f"});
+        return out;
+    });
+    client.onQuery("idempotency_store_v1", [keyOf](FakeDbClient &db, const Params &params) {
+        Rows out;
+        out.affectedRows = db.update(
+            "idempotency_keys", keyOf(params),
+            {{"status", params.at(2).value_or("")},
+             {"content_type", params.at(3).value_or("")},
+             {"body", params.at(4).value_or("")},
+             {"expires_at", std::to_string(unixNow() + std::stod(params.at(5).value_or("0")))}});
+        return out;
+    });
+    client.onQuery("idempotency_release_v1", [keyOf](FakeDbClient &db, const Params &params) {
+        Rows out;
+        auto existing = db.select("idempotency_keys", keyOf(params));
+        if (!existing.rows.empty() && !existing.rows.front()[3]) {
+            out.affectedRows = db.remove("idempotency_keys", keyOf(params));
+        }
+        return out;
+    });
+}
+
+void FakeDbClient::addAppSchema() {
+    addTable<Users>();
+    addTable<Families>();
+    addTable<FamilyMembers>();
+    addTable<FamilyInvite>();
+    addTable<Account>({{"balance", "0.00"}, {"is_family", "f"}});
+    addTable<Category>({{"is_family", "f"}});
+    addTable<Transactions>({{"is_family", "f"}});
+    addTable<Transfer>({{"is_family", "f"}});
+    addTable<Budgets>({{"is_family", "f"}});
+
+    // Выборка строки с проверкой доступа (db::findVisible в db/Statements.h)
+    for (const auto *name : {&Account::tableName, &Category::tableName, &Transactions::tableName,
+                             &Transfer::tableName, &Budgets::tableName}) {
+        const std::string tableName = unquote(*name);
+        onQuery("visible_" + tableName + "_v1", [tableName](FakeDbClient &db, const Params &params) {
+            auto out = db.select(tableName, {{"id", params.at(0).value_or("")}});
+            if (out.rows.empty() || !params.at(1)) {
+                out.rows.clear();
+                return out;
+            }
+            const auto &row = out.rows.front();
+            const auto column = [&](const std::string &col) -> const Value & {
+                auto it = std::find(out.columns.begin(), out.columns.end(), col);
+                return row[static_cast<size_t>(it - out.columns.begin())];
+            };
+            const auto &owner = column("id_user");
+            bool visible = false;
+            if (sameValue(column("is_family"), "t")) {
+                // Владелец — член семьи пользователя
+                for (const auto &member : db.select("family_members", {{"id_user", *params[1]}}).rows) {
+                    if (owner && member[1] &&
+                        !db.select("family_members", {{"id_user", *owner}, {"id_family", *member[1]}}).rows.empty()) {
+                        visible = true;
+                    }
+                }
+            } else {
+                visible = sameValue(owner, *params[1]);
+            }
+            if (!visible) {
+                out.rows.clear();
+            }
+            return out;
+        });
+    }
+
+    // Состав семьи и её семейные счета для актора семьи (db/FamilyActors.h)
+    onQuery("family_actor_load_v1", [](FakeDbClient &db, const Params &params) {
+        Rows out{{"id_user", "id_account"}, {}, 0};
+        for (const auto &member : db.select("family_members", {{"id_family", params.at(0).value_or("")}}).rows) {
+            const auto &idUser = member[2];
+            auto accounts = db.select("account", {{"id_user", idUser.value_or("")}, {"is_family", "t"}});
+            if (accounts.rows.empty()) {
+                out.rows.push_back({idUser, std::nullopt});
+            }
+            for (const auto &account : accounts.rows) {
+                out.rows.push_back({idUser, account[0]});
+            }
+        }
+        return out;
+    });
+
+    // Приращение баланса счёта (db/Balances.h)
+    for (const bool checked : {false, true}) {
+        onQuery(checked ? "account_add_balance_checked_v1" : "account_add_balance_v1",
+                [checked](FakeDbClient &db, const Params &params) {
+                    Rows out{{"balance"}, {}, 0};
+                    const auto id = params.at(0).value_or("");
+                    auto account = db.select("account", {{"id", id}});
+                    if (account.rows.empty()) {
+                        return out;
+                    }
+                    auto col = std::find(account.columns.begin(), account.columns.end(), "balance");
+                    const auto &current = account.rows.front()[static_cast<size_t>(col - account.columns.begin())];
+                    const double next = amount_utils::parseAmount(current.value_or("0")) +
+                                        amount_utils::parseAmount(params.at(1).value_or("0"));
+                    if (checked && next < 0) {
+                        return out;
+                    }
+                    const auto balance = amount_utils::amountToString(next);
+                    out.affectedRows = db.update("account", {{"id", id}}, {{"balance", balance}});
+                    out.rows.push_back({balance});
+                    return out;
+                });
+    }
+
+    // Групповая запись транзакций по счёту (db/GroupCommit.h)
+    onQuery("group_commit_lock_v1", [](FakeDbClient &db, const Params &params) {
+        Rows out{{"balance", "id"}, {}, 0};
+        auto account = db.select("account", {{"id", params.at(0).value_or("")}});
+        if (account.rows.empty()) {
+            return out;
+        }
+        auto col = std::find(account.columns.begin(), account.columns.end(), "balance");
+        const auto balance = account.rows.front()[static_cast<size_t>(col - account.columns.begin())];
+        const int n = std::atoi(params.at(1).value_or("0").c_str());
+        for (int i = 0; i < n; ++i) {
+            out.rows.push_back({balance, std::to_string(db.reserveId("transactions"))});
+        }
+        return out;
+    });
+    onQuery("group_commit_balance_v1", [](FakeDbClient &db, const Params &params) {
+        Rows out;
+        out.affectedRows = db.update("account", {{"id", params.at(0).value_or("")}},
+                                     {{"balance", params.at(1).value_or("0.00")}});
+        return out;
+    });
+    onQuery("group_commit_insert_v1", [](FakeDbClient &db, const Params &params) {
+        Json::Value records;
+        Json::CharReaderBuilder reader;
+        std::istringstream in(params.at(0).value_or("[]"));
+        std::string errors;
+        if (!Json::parseFromStream(reader, in, &records, &errors)) {
+            throw drogon::orm::SqlError("FakeDbClient: invalid jsonb parameter: " + errors, "group_commit_insert_v1");
+        }
+        Rows out;
+        for (const auto &record : records) {
+            std::map<std::string, std::string> values;
+            for (const auto &name : record.getMemberNames()) {
+                const auto &v = record[name];
+                if (v.isBool()) {
+                    values[name] = v.asBool() ? "t" : "f";
+                } else if (!v.isNull()) {
+                    values[name] = v.asString();
+                }
+            }
+            const auto id = db.insert("transactions", values);
+            auto row = db.select("transactions", {{"id", std::to_string(id)}});
+            out.columns = std::move(row.columns);
+            out.rows.insert(out.rows.end(), row.rows.begin(), row.rows.end());
+        }
+        out.affectedRows = out.rows.size();
+        return out;
+    });
+
+    addIdempotencyHandlers(*this);
+}
+
+void FakeDbClient::onQuery(const std::string &key, Handler handler) {
+    std::lock_guard lock(mutex_);
+    handlers_[normalize(key)] = std::move(handler);
+    statements_.clear();
+}
+
+FakeDbClient::Table &FakeDbClient::table(const std::string &name) {
+    auto it = tables_.find(unquote(name));
+    if (it == tables_.end()) {
+        throw drogon::orm::SqlError("FakeDbClient: relation \"" + name + "\" does not exist", name);
+    }
+    return it->second;
+}
+
+const FakeDbClient::Table &FakeDbClient::table(const std::string &name) const {
+    return const_cast<FakeDbClient *>(this)->table(name);
+}
+
+std::vector<FakeDbClient::Value> FakeDbClient::newRow(Table &t) {
+    std::vector<Value> row(t.columns.size());
+    for (size_t i = 0; i < t.columns.size(); ++i) {
+        const auto &col = t.columns[i];
+        if (auto d = t.defaults.find(col); d != t.defaults.end()) {
+            row[i] = d->second;
+        } else if (col == "id") {
+            row[i] = std::to_string(t.nextId++);
+        } else if (col == "created_at" || col == "joined_at") {
+            row[i] = now();
+        }
+    }
+    return row;
+}
+
+int64_t FakeDbClient::insert(const std::string &name, const std::map<std::string, std::string> &values) {
+    std::lock_guard lock(mutex_);
+    auto &t = table(name);
+    auto row = newRow(t);
+    for (const auto &[col, value] : values) {
+        row[t.index.at(col)] = value;
+    }
+    int64_t id = 0;
+    if (auto idx = t.index.find("id"); idx != t.index.end() && row[idx->second]) {
+        id = std::stoll(*row[idx->second]);
+        t.nextId = std::max(t.nextId, id + 1);
+    }
+    t.rows.push_back(std::move(row));
+    return id;
+}
+
+FakeDbClient::Rows FakeDbClient::select(const std::string &name, const std::map<std::string, std::string> &equals) const {
+    std::lock_guard lock(mutex_);
+    const auto &t = table(name);
+    Rows out{t.columns, {}, 0};
+    for (const auto &row : t.rows) {
+        bool match = true;
+        for (const auto &[col, value] : equals) {
+            if (!sameValue(row[t.index.at(col)], value)) {
+                match = false;
+                break;
+            }
+        }
+        if (match) {
+            out.rows.push_back(row);
+        }
+    }
+    return out;
+}
+
+size_t FakeDbClient::update(const std::string &name,
+                           const std::map<std::string, std::string> &equals,
+                           const std::map<std::string, std::string> &values) {
+    std::lock_guard lock(mutex_);
+    auto &t = table(name);
+    size_t n = 0;
+    for (auto &row : t.rows) {
+        bool match = true;
+        for (const auto &[col, value] : equals) {
+            if (!sameValue(row[t.index.at(col)], value)) {
+                match = false;
+                break;
+            }
+        }
+        if (match) {
+            for (const auto &[col, value] : values) {
+                row[t.index.at(col)] = value;
+            }
+            ++n;
+        }
+    }
+    return n;
+}
+
+size_t FakeDbClient::remove(const std::string &name, const std::map<std::string, std::string> &equals) {
+    std::lock_guard lock(mutex_);
+    auto &t = table(name);
+    const auto before = t.rows.size();
+    std::erase_if(t.rows, [&](const std::vector<Value> &row) {
+        for (const auto &[col, value] : equals) {
+            if (!sameValue(row[t.index.at(col)], value)) {
+                return false;
+            }
+        }
+        return true;
+    });
+    return before - t.rows.size();
+}
+
+int64_t FakeDbClient::reserveId(const std::string &name) {
+    std::lock_guard lock(mutex_);
+    return table(name).nextId++;
+}
+
+size_t FakeDbClient::statementCount() const {
+    std::lock_guard lock(mutex_);
+    return statementCount_;
+}
+
+const FakeDbClient::Statement &FakeDbClient::prepare(const std::string &sql) {
+    if (auto it = statements_.find(sql); it != statements_.end()) {
+        return *it->second;
+    }
+    auto st = std::make_shared<Statement>();
+    std::string tag;
+    const auto text = normalize(sql, &tag);
+
+    static const std::regex selectRe(
+        R"(^select (.+?) from ("?\w+"?)(?: \w+)?(?: where (.+?))?(?: order by ([\w."]+)(?: (asc|desc))?)?(?: limit 1)?(?: for update)?$)",
+        std::regex::icase);
+    static const std::regex conditionRe(
+        R"(^([\w."]+) = (?:\$(\d+)(?:::\w+)?|'([^']*)'|(true|false|-?\d+))$)", std::regex::icase);
+    static const std::regex andRe(" and ", std::regex::icase);
+    static const std::regex insertRe(
+        R"(^insert into ("?\w+"?) ?\(([^)]*)\) values ?\((.*)\)( returning \*)?$)", std::regex::icase);
+    static const std::regex updateRe(R"(^update ("?\w+"?) set (.+) where ([\w"]+) = \$(\d+)$)", std::regex::icase);
+    static const std::regex assignRe(R"(^([\w"]+) ?= ?\$(\d+)$)");
+    static const std::regex deleteRe(R"(^delete from ("?\w+"?) where ([\w"]+) = \$(\d+)$)", std::regex::icase);
+
+    std::smatch m;
+    if (auto h = handlers_.find(tag); !tag.empty() && h != handlers_.end()) {
+        st->handler = &h->second;
+    } else if (auto h2 = handlers_.find(text); h2 != handlers_.end()) {
+        st->handler = &h2->second;
+    } else if (std::regex_match(text, m, selectRe)) {
+        st->kind = Statement::Kind::Select;
+        st->table = unquote(m[2]);
+        for (const auto &col : split(m[1], ',')) {
+            if (col != "*" && col.find(".*") == std::string::npos) {
+                st->columns.push_back(unquote(col));
+            }
+        }
+        if (m[3].matched) {
+            const std::string where = m[3];
+            for (std::sregex_token_iterator it(where.begin(), where.end(), andRe, -1), end; it != end; ++it) {
+                std::smatch c;
+                const std::string cond = trim(*it);
+                if (!std::regex_match(cond, c, conditionRe)) {
+                    throw drogon::orm::SqlError("FakeDbClient: unsupported condition " + cond, sql);
+                }
+                Statement::Condition condition{unquote(c[1]), 0, {}};
+                if (c[2].matched) {
+                    condition.param = std::stoul(c[2]);
+                } else {
+                    condition.literal = c[3].matched ? c[3].str() : c[4].str();
+                }
+                st->where.push_back(std::move(condition));
+            }
+        }
+        if (m[4].matched) {
+            st->orderBy = unquote(m[4]);
+            st->descending = m[5].matched && (m[5] == "desc" || m[5] == "DESC");
+        }
+    } else if (std::regex_match(text, m, insertRe)) {
+        st->kind = Statement::Kind::Insert;
+        st->table = unquote(m[1]);
+        auto columns = split(m[2], ',');
+        auto values = split(m[3], ',');
+        if (columns.size() != values.size()) {
+            throw drogon::orm::SqlError("FakeDbClient: column/value count mismatch", sql);
+        }
+        for (size_t i = 0; i < columns.size(); ++i) {
+            size_t param = values[i].size() > 1 && values[i][0] == '$' ? std::stoul(values[i].substr(1)) : 0;
+            st->assignments.emplace_back(unquote(columns[i]), param);
+        }
+        st->returning = m[4].matched;
+    } else if (std::regex_match(text, m, updateRe)) {
+        st->kind = Statement::Kind::Update;
+        st->table = unquote(m[1]);
+        for (const auto &item : split(m[2], ',')) {
+            std::smatch a;
+            if (!std::regex_match(item, a, assignRe)) {
+                throw drogon::orm::SqlError("FakeDbClient: unsupported assignment " + item, sql);
+            }
+            st->assignments.emplace_back(unquote(a[1]), std::stoul(a[2]));
+        }
+        st->where.push_back({unquote(m[3]), std::stoul(m[4]), {}});
+    } else if (std::regex_match(text, m, deleteRe)) {
+        st->kind = Statement::Kind::Delete;
+        st->table = unquote(m[1]);
+        st->where.push_back({unquote(m[2]), std::stoul(m[3]), {}});
+    } else {
+        throw drogon::orm::SqlError("FakeDbClient: unsupported statement " + (tag.empty() ? text : tag), sql);
+    }
+    return *(statements_[sql] = std::move(st));
+}
+
+FakeDbClient::Rows FakeDbClient::run(const std::string &sql, const Params &params) {
+    std::lock_guard lock(mutex_);
+    ++statementCount_;
+    const auto &st = prepare(sql);
+    if (st.handler) {
+        return (*st.handler)(*this, params);
+    }
+
+    auto param = [&](size_t n) -> const Value & {
+        if (n == 0 || n > params.size()) {
+            throw drogon::orm::SqlError("FakeDbClient: missing parameter $" + std::to_string(n), sql);
+        }
+        return params[n - 1];
+    };
+    auto &t = table(st.table);
+    auto matches = [&](const std::vector<Value> &row) {
+        for (const auto &c : st.where) {
+            const auto &expected = c.param ? param(c.param) : Value(c.literal);
+            if (!expected || !sameValue(row[t.index.at(c.column)], *expected)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    Rows out;
+    switch (st.kind) {
+        case Statement::Kind::Select: {
+            std::vector<size_t> projection;
+            if (st.columns.empty()) {
+                out.columns = t.columns;
+                for (size_t i = 0; i < t.columns.size(); ++i) {
+                    projection.push_back(i);
+                }
+            } else {
+                for (const auto &col : st.columns) {
+                    if (auto idx = t.index.find(col); idx != t.index.end()) {
+                        projection.push_back(idx->second);
+                        out.columns.push_back(col);
+                    } else if (isNumber(col)) {
+                        projection.push_back(SIZE_MAX);
+                        out.columns.push_back("?column?");
+                    } else {
+                        throw drogon::orm::SqlError("FakeDbClient: column \"" + col + "\" does not exist", sql);
+                    }
+                }
+            }
+            std::vector<const std::vector<Value> *> found;
+            for (const auto &row : t.rows) {
+                if (matches(row)) {
+                    found.push_back(&row);
+                }
+            }
+            if (!st.orderBy.empty()) {
+                size_t col = t.index.at(st.orderBy);
+                std::stable_sort(found.begin(), found.end(), [&](auto *a, auto *b) {
+                    const auto &x = (*a)[col];
+                    const auto &y = (*b)[col];
+                    bool less = x && y && isNumber(*x) && isNumber(*y) ? std::stod(*x) < std::stod(*y) : x < y;
+                    bool greater = x && y && isNumber(*x) && isNumber(*y) ? std::stod(*y) < std::stod(*x) : y < x;
+                    return st.descending ? greater : less;
+                });
+            }
+            for (const auto *row : found) {
+                std::vector<Value> projected;
+                for (size_t i = 0; i < projection.size(); ++i) {
+                    projected.push_back(projection[i] == SIZE_MAX ? Value(st.columns[i]) : (*row)[projection[i]]);
+                }
+                out.rows.push_back(std::move(projected));
+            }
+            break;
+        }
+        case Statement::Kind::Insert: {
+            auto row = newRow(t);
+            for (const auto &[col, n] : st.assignments) {
+                if (n > 0) {
+                    row[t.index.at(col)] = param(n);
+                }
+            }
+            if (auto idx = t.index.find("id"); idx != t.index.end() && row[idx->second]) {
+                t.nextId = std::max<int64_t>(t.nextId, std::stoll(*row[idx->second]) + 1);
+            }
+            t.rows.push_back(row);
+            out.affectedRows = 1;
+            if (st.returning) {
+                out.columns = t.columns;
+                out.rows.push_back(std::move(row));
+            }
+            break;
+        }
+        case Statement::Kind::Update:
+            for (auto &row : t.rows) {
+                if (!matches(row)) {
+                    continue;
+                }
+                for (const auto &[col, n] : st.assignments) {
+                    row[t.index.at(col)] = param(n);
+                }
+                ++out.affectedRows;
+            }
+            break;
+        case Statement::Kind::Delete: {
+            auto before = t.rows.size();
+            t.rows.erase(std::remove_if(t.rows.begin(), t.rows.end(), matches), t.rows.end());
+            out.affectedRows = before - t.rows.size();
+            break;
+        }
+        case Statement::Kind::Custom:
+            break;
+    }
+    return out;
+}
+
+// Результат всегда приходит асинхронно, как от настоящего клиента: в цикл текущего
+// IO-потока или, если вызов не из event loop, в собственный поток клиента
+void FakeDbClient::deliver(std::function<void()> callback) {
+    if (auto *loop = trantor::EventLoop::getEventLoopOfCurrentThread()) {
+        loop->queueInLoop(std::move(callback));
+        return;
+    }
+    std::lock_guard lock(mutex_);
+    if (!loopThread_) {
+        loopThread_ = std::make_unique<trantor::EventLoopThread>("FakeDbClient");
+        loopThread_->run();
+    }
+    loopThread_->getLoop()->queueInLoop(std::move(callback));
+}
+
+void FakeDbClient::execSql(const char *sql,
+                           size_t sqlLength,
+                           size_t paraNum,
+                           std::vector<const char *> &&parameters,
+                           std::vector<int> &&length,
+                           std::vector<int> &&format,
+                           drogon::orm::ResultCallback &&rcb,
+                           std::function<void(const std::exception_ptr &)> &&exceptCallback) {
+    Params params;
+    for (size_t i = 0; i < paraNum; ++i) {
+        params.push_back(decodeParam(parameters[i], i < length.size() ? length[i] : 0,
+                                     i < format.size() ? format[i] : 0));
+    }
+    try {
+        drogon::orm::Result result(std::make_shared<FakeResult>(run(std::string(sql, sqlLength), params)));
+        deliver([rcb = std::move(rcb), result = std::move(result)] { rcb(result); });
+    } catch (...) {
+        deliver([exceptCallback = std::move(exceptCallback), e = std::current_exception()] { exceptCallback(e); });
+    }
+}
+
+std::shared_ptr<drogon::orm::Transaction> FakeDbClient::newTransaction(
+    const std::function<void(bool)> &commitCallback) noexcept(false) {
+    return std::make_shared<FakeTransaction>(shared_from_this(), commitCallback);
+}
+
+void FakeDbClient::newTransactionAsync(
+    const std::function<void(const std::shared_ptr<drogon::orm::Transaction> &)> &callback) {
+    auto trans = newTransaction();
+    deliver([callback, trans] { callback(trans); });
+}
+
+}
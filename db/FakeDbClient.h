@@ -0,0 +1,123 @@
+#pragma once
+#include <drogon/orm/DbClient.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace trantor {
+class EventLoopThread;
+}
+
+// DbClient без PostgreSQL: таблицы в памяти, значения хранятся текстом, как их отдаёт Postgres.
+// Понимает запросы, которые генерируют CoroMapper и модели (поиск, вставка, обновление
+// и удаление по ключу), и простые SELECT по одной таблице: столбцы или *, условия
+// "col = $n" / "col = TRUE|FALSE" через AND, ORDER BY по одному столбцу.
+// Остальные запросы (JOIN-ы, агрегаты) подключаются через onQuery по тегу /*tag*/
+// или по тексту запроса. Неизвестный запрос завершается SqlError.
+// Подставляется через db::setDbClientOverride (db/DataBase.h) — в бенчмарках контроллеров
+// и тестах, где нужна логика обработчиков без задержек сети и БД.
+namespace db {
+
+class FakeDbClient : public drogon::orm::DbClient, public std::enable_shared_from_this<FakeDbClient> {
+public:
+    using Value = std::optional<std::string>;
+    using Params = std::vector<Value>;
+
+    struct Rows {
+        std::vector<std::string> columns;
+        std::vector<std::vector<Value>> rows;
+        unsigned long long affectedRows = 0;
+    };
+
+    using Handler = std::function<Rows(FakeDbClient &, const Params &)>;
+
+    FakeDbClient();
+    ~FakeDbClient() override;
+
+    // Таблица с колонками модели. Значения по умолчанию — для "default" в INSERT;
+    // id заполняется счётчиком, created_at и joined_at — текущим временем
+    template <typename Model>
+    void addTable(std::map<std::string, std::string> defaults = {}) {
+        std::vector<std::string> columns;
+        for (size_t i = 0; i < Model::getColumnNumber(); ++i) {
+            columns.push_back(Model::getColumnName(i));
+        }
+        addTable(Model::tableName, std::move(columns), std::move(defaults));
+    }
+    void addTable(const std::string &name,
+                  std::vector<std::string> columns,
+                  std::map<std::string, std::string> defaults = {});
+
+    // Все таблицы приложения с умолчаниями схемы и обработчики выборки с проверкой доступа
+    // (db::findVisible)
+    void addAppSchema();
+
+    // Обработчик для запроса с тегом /*key*/ или с текстом key (сравнивается без комментариев
+    // и с точностью до пробелов). Вызывается под блокировкой клиента: можно пользоваться select/insert
+    void onQuery(const std::string &key, Handler handler);
+
+    // Добавляет строку, недостающие колонки — как для "default". Возвращает id
+    int64_t insert(const std::string &table, const std::map<std::string, std::string> &values);
+    // Строки таблицы, у которых колонки равны заданным значениям
+    Rows select(const std::string &table, const std::map<std::string, std::string> &equals = {}) const;
+    // Меняет колонки values у строк, совпавших с equals. Возвращает число строк
+    size_t update(const std::string &table,
+                  const std::map<std::string, std::string> &equals,
+                  const std::map<std::string, std::string> &values);
+    // Удаляет строки, совпавшие с equals. Возвращает число строк
+    size_t remove(const std::string &table, const std::map<std::string, std::string> &equals);
+    // Следующий id таблицы, как nextval у последовательности
+    int64_t reserveId(const std::string &table);
+
+    void execSql(const char *sql,
+                 size_t sqlLength,
+                 size_t paraNum,
+                 std::vector<const char *> &&parameters,
+                 std::vector<int> &&length,
+                 std::vector<int> &&format,
+                 drogon::orm::ResultCallback &&rcb,
+                 std::function<void(const std::exception_ptr &)> &&exceptCallback) override;
+    std::shared_ptr<drogon::orm::Transaction> newTransaction(
+        const std::function<void(bool)> &commitCallback = std::function<void(bool)>()) noexcept(false) override;
+    void newTransactionAsync(
+        const std::function<void(const std::shared_ptr<drogon::orm::Transaction> &)> &callback) override;
+    bool hasAvailableConnections() const noexcept override {
+        return true;
+    }
+    void setTimeout(double) override {}
+    void closeAll() override {}
+
+    // Сколько запросов выполнено (для проверок в тестах)
+    size_t statementCount() const;
+
+private:
+    struct Table {
+        std::vector<std::string> columns;
+        std::unordered_map<std::string, size_t> index;
+        std::map<std::string, std::string> defaults;
+        std::vector<std::vector<Value>> rows;
+        int64_t nextId = 1;
+    };
+    struct Statement;
+
+    Rows run(const std::string &sql, const Params &params);
+    const Statement &prepare(const std::string &sql);
+    Table &table(const std::string &name);
+    const Table &table(const std::string &name) const;
+    std::vector<Value> newRow(Table &t);
+    void deliver(std::function<void()> callback);
+
+    mutable std::recursive_mutex mutex_;
+    std::map<std::string, Table> tables_;
+    std::unordered_map<std::string, Handler> handlers_;
+    std::unordered_map<std::string, std::shared_ptr<Statement>> statements_;
+    size_t statementCount_ = 0;
+    std::unique_ptr<trantor::EventLoopThread> loopThread_;
+};
+
+}
@@ -0,0 +1,304 @@
+#include "FamilyActors.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <deque>
+#include <new>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <sys/mman.h>
+#include <drogon/HttpAppFramework.h>
+#include <trantor/net/EventLoop.h>
+#include "Statements.h"
+#include "utils/LoopCache.h"
+#include "utils/Metrics.h"
+
+namespace db {
+
+using Clock = std::chrono::steady_clock;
+
+static FamilyActorOptions g_options;
+
+const FamilyActorOptions &loadFamilyActorOptions() {
+    const auto &cfg = drogon::app().getCustomConfig()["family_actors"];
+    if (cfg.isObject()) {
+        g_options.idleSec = cfg.get("idle_sec", 300.0).asDouble();
+        g_options.refreshSec = cfg.get("refresh_sec", 30.0).asDouble();
+        g_options.cacheEntries = std::max(1u, cfg.get("cache_entries", 4096).asUInt());
+    }
+    return g_options;
+}
+
+static metrics::Counter &loadCounter() {
+    static metrics::Counter c("fm_family_actor_loads_total",
+                              "Family state loads from the database (per IO thread cache misses)",
+                              {"reason"});
+    return c;
+}
+
+// Эпоха составов семей. Лежит в общей анонимной памяти, созданной до fork(), как эпохи
+// списков в ListQueries.cc: familyChanged в одном процессе устаревает акторы во всех
+static std::atomic<uint64_t> *createEpoch() {
+    void *mem = mmap(nullptr, sizeof(std::atomic<uint64_t>), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        return new std::atomic<uint64_t>(0);
+    }
+    return new (mem) std::atomic<uint64_t>(0);
+}
+
+static std::atomic<uint64_t> *const g_epoch = createEpoch();
+
+static uint64_t currentEpoch() {
+    return g_epoch->load(std::memory_order_acquire);
+}
+
+void familyChanged() {
+    g_epoch->fetch_add(1, std::memory_order_acq_rel);
+}
+
+static bool expired(Clock::time_point since, double sec) {
+    return Clock::now() - since > std::chrono::duration<double>(sec);
+}
+
+// Состав семьи и её семейные счета, прочитанные из БД. После чтения не меняется,
+// поэтому кеш IO-потока отдаёт его без копирования и блокировок
+struct FamilyState {
+    std::unordered_set<int64_t> members;
+    std::unordered_set<int32_t> accounts;
+};
+
+// Актор семьи — очередь её записи. Живёт в карте потока loop и меняется только в нём
+struct FamilyActor {
+    int64_t idFamily = 0;
+    trantor::EventLoop *loop = nullptr;
+    Clock::time_point lastUsed = Clock::now();
+    bool writerBusy = false;
+    std::deque<std::coroutine_handle<>> writers;
+};
+
+using UserFamilyCache = cache::LoopCache<int64_t, int64_t>;
+using FamilyStateCache = cache::LoopCache<int64_t, std::shared_ptr<const FamilyState>>;
+
+static UserFamilyCache::Clock::duration refreshTtl() {
+    return std::chrono::duration_cast<UserFamilyCache::Clock::duration>(
+        std::chrono::duration<double>(g_options.refreshSec));
+}
+
+// Семья пользователя (0 — не состоит) в шарде IO-потока; тег — эпоха составов
+static UserFamilyCache &userFamilies() {
+    static UserFamilyCache cache(g_options.cacheEntries, refreshTtl());
+    return cache;
+}
+
+// Состояние семьи в шарде IO-потока; тег — эпоха составов
+static FamilyStateCache &familyStates() {
+    static FamilyStateCache cache(g_options.cacheEntries, refreshTtl());
+    return cache;
+}
+
+// Акторы, закреплённые за потоком: карта своя у каждого потока, обращения к ней — только из него
+static std::unordered_map<int64_t, std::shared_ptr<FamilyActor>> &localActors() {
+    thread_local std::unordered_map<int64_t, std::shared_ptr<FamilyActor>> actors;
+    return actors;
+}
+
+// Семья закреплена за IO-потоком по id; вне работающего сервера (микробенчмарки) — за циклом
+// потока, первым к ней обратившегося
+static trantor::EventLoop *loopFor(int64_t idFamily) {
+    auto &app = drogon::app();
+    if (app.isRunning() && app.getThreadNum() > 0) {
+        return app.getIOLoop(static_cast<size_t>(idFamily) % app.getThreadNum());
+    }
+    return trantor::EventLoop::getEventLoopOfCurrentThread();
+}
+
+// Вызывается в потоке актора
+static std::shared_ptr<FamilyActor> localActor(int64_t idFamily) {
+    auto &actor = localActors()[idFamily];
+    if (!actor) {
+        actor = std::make_shared<FamilyActor>();
+        actor->idFamily = idFamily;
+        actor->loop = trantor::EventLoop::getEventLoopOfCurrentThread();
+    }
+    actor->lastUsed = Clock::now();
+    return actor;
+}
+
+namespace {
+
+// Возобновляется из FamilyWriter::release уже владельцем очереди
+struct WriterWaiter {
+    FamilyActor *actor;
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> h) {
+        actor->writers.push_back(h);
+    }
+
+    void await_resume() const noexcept {}
+};
+
+}
+
+// Состояние семьи из кеша потока или из БД через клиент запроса. Одновременные промахи
+// читают его независимо; дальше поток берёт его из кеша до смены эпохи или refreshSec
+static drogon::Task<std::shared_ptr<const FamilyState>> familyState(drogon::orm::DbClientPtr db,
+                                                                    int64_t idFamily) {
+    const uint64_t epoch = currentEpoch();
+    if (const auto *state = familyStates().find(idFamily, epoch)) {
+        co_return *state;
+    }
+    loadCounter().add({"miss"});
+    // Эпоха — до запроса: изменение, завершившееся во время него, вызовет ещё одно чтение
+    auto rows = co_await db->execSqlCoro(
+        R"(
+        /*family_actor_load_v1*/
+        SELECT fm.id_user, a.id AS id_account
+        FROM family_members fm
+        LEFT JOIN account a ON a.id_user = fm.id_user AND a.is_family = TRUE
+        WHERE fm.id_family = $1::int8
+        )", idFamily);
+    auto state = std::make_shared<FamilyState>();
+    for (const auto &row : rows) {
+        state->members.insert(row["id_user"].as<int64_t>());
+        if (!row["id_account"].isNull()) {
+            state->accounts.insert(row["id_account"].as<int32_t>());
+        }
+    }
+    for (const auto member : state->members) {
+        userFamilies().put(member, idFamily, epoch);
+    }
+    std::shared_ptr<const FamilyState> result = std::move(state);
+    familyStates().put(idFamily, result, epoch);
+    co_return result;
+}
+
+FamilyWriter::FamilyWriter(std::shared_ptr<FamilyActor> actor) : actor_(std::move(actor)) {}
+
+FamilyWriter &FamilyWriter::operator=(FamilyWriter &&other) noexcept {
+    if (this != &other) {
+        release();
+        actor_ = std::move(other.actor_);
+    }
+    return *this;
+}
+
+FamilyWriter::~FamilyWriter() {
+    release();
+}
+
+// Передаёт очередь следующей ждущей записи в потоке актора
+void FamilyWriter::release() {
+    if (!actor_) {
+        return;
+    }
+    auto actor = std::move(actor_);
+    auto *loop = actor->loop;
+    auto handOver = [actor = std::move(actor)] {
+        if (actor->writers.empty()) {
+            actor->writerBusy = false;
+            return;
+        }
+        auto next = actor->writers.front();
+        actor->writers.pop_front();
+        next.resume();
+    };
+    if (loop) {
+        loop->queueInLoop(std::move(handOver));
+    } else {
+        handOver();
+    }
+}
+
+drogon::Task<FamilyAccess> checkFamilyWrite(drogon::orm::DbClientPtr db,
+                                            int64_t userId,
+                                            std::vector<int32_t> accountIds,
+                                            std::string accountsError,
+                                            bool exclusive) {
+    FamilyAccess access;
+
+    std::optional<int64_t> idFamily;
+    if (const auto *cached = userFamilies().find(userId, currentEpoch())) {
+        idFamily = *cached;
+    } else {
+        const uint64_t epoch = currentEpoch();
+        auto rows = co_await exec(db, stmt::familyOfUser, userId);
+        idFamily = rows.empty() ? 0 : rows[0]["id_family"].as<int64_t>();
+        userFamilies().put(userId, *idFamily, epoch);
+    }
+    if (*idFamily == 0) {
+        access.status = drogon::k400BadRequest;
+        access.error = "User is not a member of any family";
+        co_return access;
+    }
+    access.idFamily = *idFamily;
+
+    // Проверки — в потоке запроса по состоянию из его кеша, без переходов между потоками
+    auto state = co_await familyState(db, *idFamily);
+    if (!state->members.contains(userId)) {
+        // Пользователь вышел из семьи на другом сервере
+        userFamilies().erase(userId);
+        access.status = drogon::k400BadRequest;
+        access.error = "User is not a member of any family";
+        co_return access;
+    }
+    if (!std::all_of(accountIds.begin(), accountIds.end(),
+                     [&](int32_t id) { return state->accounts.contains(id); })) {
+        access.status = drogon::k403Forbidden;
+        access.error = std::move(accountsError);
+        co_return access;
+    }
+    if (!exclusive) {
+        co_return access;
+    }
+
+    // Очередь записи — в потоке актора семьи; обработчик возвращается в свой поток
+    auto *origin = trantor::EventLoop::getEventLoopOfCurrentThread();
+    auto *home = loopFor(*idFamily);
+    if (home) {
+        co_await drogon::switchThreadCoro(home);
+    }
+    auto actor = localActor(*idFamily);
+    if (actor->writerBusy) {
+        co_await WriterWaiter{actor.get()};
+    } else {
+        actor->writerBusy = true;
+    }
+    access.writer = FamilyWriter(std::move(actor));
+    if (origin) {
+        co_await drogon::switchThreadCoro(origin);
+    }
+    co_return access;
+}
+
+// Удаляет простаивающие акторы потока; вызывается в нём же
+static void evictIdle() {
+    auto &actors = localActors();
+    for (auto it = actors.begin(); it != actors.end();) {
+        const auto &actor = it->second;
+        // use_count() == 1: очередь никто не держит, а новую ссылку дают только из этой карты
+        if (actor.use_count() == 1 && expired(actor->lastUsed, g_options.idleSec)) {
+            it = actors.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void scheduleFamilyActorEviction() {
+    drogon::app().registerBeginningAdvice([] {
+        auto &app = drogon::app();
+        const double interval = std::max(1.0, g_options.idleSec / 2);
+        for (size_t i = 0; i < app.getThreadNum(); ++i) {
+            app.getIOLoop(i)->runEvery(interval, [] { evictIdle(); });
+        }
+    });
+}
+
+}
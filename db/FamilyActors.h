@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <drogon/HttpResponse.h>
+#include <drogon/orm/DbClient.h>
+#include <drogon/utils/coroutine.h>
+
+// Проверки семейных записей без запросов к БД: состав семьи и её семейные счета читаются
+// одним запросом и кешируются в шарде каждого IO-потока (utils/LoopCache.h). Проверка идёт
+// в потоке запроса и не берёт блокировок; запросы familyOfUser и findVisible к БД не нужны.
+// Актор семьи — её очередь записи: он закреплён за одним IO-потоком, и только записи,
+// запросившие очередь, переходят в этот поток и обратно.
+//
+// Балансы в кеш не попадают: рабочие процессы prefork-режима и другие серверы меняют их
+// в обход него, поэтому источником баланса остаётся строка account под блокировкой
+// (db/GroupCommit.h пишет транзакции по счёту пакетами). Состав семьи и счета меняются
+// редко: такие запросы вызывают familyChanged, и кеши всех процессов перечитывают
+// состояние из БД при следующем обращении, как и через refreshSec. Очередь без обращений
+// дольше idleSec удаляется.
+namespace db {
+
+struct FamilyActorOptions {
+    // Сколько актор живёт без обращений, с
+    double idleSec = 300;
+    // Как часто перечитываются состав семьи и счета, с (изменения с других серверов)
+    double refreshSec = 30;
+    // Записей в кеше одного IO-потока (семьи и пользователи — отдельно)
+    size_t cacheEntries = 4096;
+};
+
+// custom_config.family_actors из config.json. Вызывать после loadConfigFile
+const FamilyActorOptions &loadFamilyActorOptions();
+
+// Удаляет очереди записи, простаивающие дольше idleSec. Вызывать до app().run()
+void scheduleFamilyActorEviction();
+
+// Состав семьи или её семейные счета изменились: созданы или удалены семья, член семьи,
+// пользователь или семейный счёт. Действует на все процессы prefork-режима
+void familyChanged();
+
+struct FamilyActor;
+
+// Очередь записи семьи: пока объект жив, другие записи той же семьи, запросившие очередь,
+// ждут. Освобождается деструктором
+class FamilyWriter {
+public:
+    FamilyWriter() = default;
+    explicit FamilyWriter(std::shared_ptr<FamilyActor> actor);
+    FamilyWriter(FamilyWriter &&other) noexcept = default;
+    FamilyWriter &operator=(FamilyWriter &&other) noexcept;
+    FamilyWriter(const FamilyWriter &) = delete;
+    FamilyWriter &operator=(const FamilyWriter &) = delete;
+    ~FamilyWriter();
+
+private:
+    void release();
+
+    std::shared_ptr<FamilyActor> actor_;
+};
+
+struct FamilyAccess {
+    // k200OK — пользователь состоит в семье и все счета семейные; иначе ответ обработчика
+    drogon::HttpStatusCode status = drogon::k200OK;
+    std::string error;
+    int64_t idFamily = 0;
+    // Занят, если запрошен exclusive
+    FamilyWriter writer;
+
+    bool ok() const {
+        return status == drogon::k200OK;
+    }
+};
+
+// Проверяет, что userId состоит в семье (иначе 400) и что accountIds — семейные счета его
+// семьи (иначе 403, текст — accountsError); db — клиент запроса, через него при промахе
+// кеша читается состояние семьи.
+// С exclusive ещё и занимает очередь записи семьи: переводы между семейными счетами идут
+// по одному и не блокируют строки счетов друг у друга в разном порядке
+drogon::Task<FamilyAccess> checkFamilyWrite(drogon::orm::DbClientPtr db,
+                                            int64_t userId,
+                                            std::vector<int32_t> accountIds,
+                                            std::string accountsError,
+                                            bool exclusive = false);
+
+}
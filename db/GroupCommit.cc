@@ -0,0 +1,298 @@
+#include "GroupCommit.h"
+#include <algorithm>
+#include <array>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <drogon/HttpAppFramework.h>
+#include <jsoncpp/json/json.h>
+#include <trantor/net/EventLoop.h>
+#include "DataBase.h"
+#include "Transaction.h"
+#include "utils/AmountUtils.h"
+#include "utils/Metrics.h"
+
+using drogon_model::financial_manager::Transactions;
+
+namespace db {
+
+static GroupCommitOptions g_options;
+
+const GroupCommitOptions &loadGroupCommitOptions() {
+    const auto &cfg = drogon::app().getCustomConfig()["group_commit"];
+    if (cfg.isObject()) {
+        g_options.windowMs = cfg.get("window_ms", 0.0).asDouble();
+        g_options.maxBatch = std::max(1u, cfg.get("max_batch", 64).asUInt());
+    }
+    return g_options;
+}
+
+static metrics::Histogram &batchHistogram() {
+    static metrics::Histogram h("fm_db_group_commit_batch_size",
+                                "Transactions written to one account in one DB transaction",
+                                {},
+                                {1, 2, 4, 8, 16, 32, 64, 128});
+    return h;
+}
+
+namespace {
+
+// Запись в очереди счёта и корутина обработчика, которая ждёт её результата
+struct Waiter {
+    NewTransaction tx;
+    drogon::HttpRequestPtr req;
+    NewTransactionResult result;
+    std::exception_ptr error;
+    trantor::EventLoop *loop = nullptr;
+    std::coroutine_handle<> handle;
+};
+
+using Batch = std::vector<std::shared_ptr<Waiter>>;
+
+struct AccountQueue {
+    Batch pending;
+    // Пакет пишется: следующий уйдёт после его COMMIT
+    bool inFlight = false;
+    // Ждём windowMs, пока соберутся записи
+    bool timerArmed = false;
+};
+
+}
+
+// Очереди по счетам, разбитые на шарды по id счёта: записи разных счетов почти не делят
+// блокировку, а записи одного счёта из разных IO-потоков по-прежнему попадают в общий пакет
+struct alignas(64) QueueShard {
+    std::mutex mutex;
+    std::unordered_map<int32_t, AccountQueue> queues;
+};
+
+static constexpr size_t kQueueShards = 64;
+static std::array<QueueShard, kQueueShards> g_shards;
+
+static QueueShard &shardFor(int32_t idAccount) {
+    return g_shards[static_cast<uint32_t>(idAccount) % kQueueShards];
+}
+
+static void flush(int32_t idAccount);
+
+// Будит ожидающих в их event loop и отправляет то, что накопилось за время записи пакета
+static void complete(int32_t idAccount, const Batch &batch) {
+    for (const auto &waiter : batch) {
+        if (waiter->loop) {
+            waiter->loop->queueInLoop([waiter] { waiter->handle.resume(); });
+        } else {
+            waiter->handle.resume();
+        }
+    }
+    bool next = false;
+    {
+        auto &shard = shardFor(idAccount);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.queues.find(idAccount);
+        if (it == shard.queues.end()) {
+            return;
+        }
+        it->second.inFlight = false;
+        if (!it->second.pending.empty()) {
+            next = !it->second.timerArmed;
+        } else if (!it->second.timerArmed) {
+            shard.queues.erase(it);
+        }
+    }
+    if (next) {
+        flush(idAccount);
+    }
+}
+
+static void reject(Waiter &waiter, drogon::HttpStatusCode status, std::string error) {
+    waiter.result.status = status;
+    waiter.result.error = std::move(error);
+}
+
+// Клиент пакета: его запросы засчитываются HTTP-запросу первой записи (счётчики запросов
+// и профиль), остальные записи ждут тот же пакет. Срок запроса (utils/Deadline.h) к пакету
+// намеренно не применяется: пакет общий, и истёкший срок одной записи не должен откатывать
+// остальные. Поэтому клиент — без deadline, в отличие от getDbClient(req)
+static drogon::orm::DbClientPtr batchClient(const drogon::HttpRequestPtr &req) {
+    if (!req) {
+        return getDbClient();
+    }
+    return std::make_shared<MeteredDbClient>(detail::baseClient(),
+                                             metrics::requestDbStats(req),
+                                             profiling::requestTrace(req));
+}
+
+static drogon::AsyncTask writeBatch(int32_t idAccount, Batch batch) {
+    batchHistogram().observe({}, static_cast<double>(batch.size()));
+    try {
+        auto db = batchClient(batch.front()->req);
+        TxScope tx(db, co_await db->newTransactionCoro());
+
+        // Блокировка строки счёта до COMMIT и id для всех записей пакета: id раздаются
+        // заранее, чтобы сопоставить строки из RETURNING с записями без опоры на их порядок
+        auto locked = co_await tx.client()->execSqlCoro(
+            R"(
+            /*group_commit_lock_v1*/
+            SELECT a.balance, s.id
+            FROM account a
+            CROSS JOIN LATERAL (
+                SELECT nextval(pg_get_serial_sequence('transactions', 'id')) AS id
+                FROM generate_series(1, $2::int4)
+            ) s
+            WHERE a.id = $1::int4
+            FOR UPDATE OF a
+            )", idAccount, static_cast<int32_t>(batch.size()));
+        if (locked.empty()) {
+            for (const auto &waiter : batch) {
+                reject(*waiter, drogon::k403Forbidden, "Account does not belong to user or family");
+            }
+        } else {
+            // Записи применяются по порядку: расход, уводящий баланс в минус, отклоняется,
+            // остальные записи пакета это не задевает
+            double balance = amount_utils::parseAmount(locked[0]["balance"].as<std::string>());
+            std::unordered_map<int64_t, Waiter *> byId;
+            Json::Value records(Json::arrayValue);
+            for (size_t i = 0; i < batch.size(); ++i) {
+                auto &waiter = *batch[i];
+                const double next = waiter.tx.type == "income" ? balance + waiter.tx.amountValue
+                                                               : balance - waiter.tx.amountValue;
+                if (waiter.tx.type != "income" && next < 0) {
+                    reject(waiter, drogon::k400BadRequest, "Insufficient funds");
+                    continue;
+                }
+                balance = next;
+                const int64_t id = locked[static_cast<drogon::orm::Result::SizeType>(i)]["id"].as<int64_t>();
+                byId[id] = &waiter;
+                Json::Value record;
+                record["id"] = Json::Int64(id);
+                record["id_user"] = waiter.tx.idUser;
+                record["id_account"] = idAccount;
+                record["id_category"] = waiter.tx.idCategory > 0 ? Json::Value(waiter.tx.idCategory) : Json::Value();
+                record["amount"] = waiter.tx.amount;
+                record["type"] = waiter.tx.type;
+                record["description"] =
+                    waiter.tx.description.empty() ? Json::Value() : Json::Value(waiter.tx.description);
+                record["is_family"] = waiter.tx.isFamily;
+                records.append(record);
+            }
+            if (!records.empty()) {
+                co_await tx.client()->execSqlCoro(
+                    "/*group_commit_balance_v1*/ UPDATE account SET balance = $2::numeric WHERE id = $1::int4",
+                    idAccount, amount_utils::amountToString(balance));
+                Json::StreamWriterBuilder writer;
+                writer["indentation"] = "";
+                // jsonb_populate_recordset приводит поля к типам колонок transactions, включая enum type
+                auto inserted = co_await tx.client()->execSqlCoro(
+                    R"(
+                    /*group_commit_insert_v1*/
+                    INSERT INTO transactions (id, id_user, id_account, id_category, amount, type, description, is_family)
+                    SELECT id, id_user, id_account, id_category, amount, type, description, is_family
+                    FROM jsonb_populate_recordset(NULL::transactions, $1::jsonb)
+                    RETURNING *
+                    )", Json::writeString(writer, records));
+                for (const auto &row : inserted) {
+                    Transactions tr(row);
+                    if (auto it = byId.find(tr.getValueOfId()); it != byId.end()) {
+                        it->second->result.inserted = std::move(tr);
+                    }
+                }
+                // Ответы — только после COMMIT
+                co_await tx.commit();
+            }
+        }
+    } catch (...) {
+        auto error = std::current_exception();
+        for (const auto &waiter : batch) {
+            waiter->result.inserted.reset();
+            waiter->error = error;
+        }
+    }
+    // Без записи транзакция уже откатана TxScope
+    complete(idAccount, batch);
+}
+
+// Забирает из очереди счёта до maxBatch записей, если пакет по нему ещё не пишется
+static void flush(int32_t idAccount) {
+    Batch batch;
+    {
+        auto &shard = shardFor(idAccount);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.queues.find(idAccount);
+        if (it == shard.queues.end()) {
+            return;
+        }
+        auto &queue = it->second;
+        queue.timerArmed = false;
+        if (queue.inFlight || queue.pending.empty()) {
+            return;
+        }
+        const size_t n = std::min(queue.pending.size(), g_options.maxBatch);
+        batch.assign(queue.pending.begin(), queue.pending.begin() + static_cast<std::ptrdiff_t>(n));
+        queue.pending.erase(queue.pending.begin(), queue.pending.begin() + static_cast<std::ptrdiff_t>(n));
+        queue.inFlight = true;
+    }
+    writeBatch(idAccount, std::move(batch));
+}
+
+static void enqueue(const std::shared_ptr<Waiter> &waiter) {
+    const int32_t idAccount = waiter->tx.idAccount;
+    bool now = false;
+    bool arm = false;
+    {
+        auto &shard = shardFor(idAccount);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto &queue = shard.queues[idAccount];
+        queue.pending.push_back(waiter);
+        if (!queue.inFlight) {
+            if (g_options.windowMs > 0 && waiter->loop && queue.pending.size() < g_options.maxBatch) {
+                arm = !queue.timerArmed;
+                queue.timerArmed = true;
+            } else {
+                now = true;
+            }
+        }
+    }
+    if (arm) {
+        waiter->loop->runAfter(g_options.windowMs / 1000, [idAccount] { flush(idAccount); });
+    } else if (now) {
+        flush(idAccount);
+    }
+}
+
+namespace {
+
+struct EnqueueAwaiter {
+    std::shared_ptr<Waiter> waiter;
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> h) {
+        waiter->handle = h;
+        waiter->loop = trantor::EventLoop::getEventLoopOfCurrentThread();
+        enqueue(waiter);
+    }
+
+    NewTransactionResult await_resume() {
+        if (waiter->error) {
+            std::rethrow_exception(waiter->error);
+        }
+        return std::move(waiter->result);
+    }
+};
+
+}
+
+drogon::Task<NewTransactionResult> addTransaction(NewTransaction tx, drogon::HttpRequestPtr req) {
+    auto waiter = std::make_shared<Waiter>();
+    waiter->tx = std::move(tx);
+    waiter->req = std::move(req);
+    co_return co_await EnqueueAwaiter{std::move(waiter)};
+}
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <drogon/HttpRequest.h>
+#include <drogon/HttpResponse.h>
+#include <drogon/utils/coroutine.h>
+#include "models/Transactions.h"
+
+// Групповая запись транзакций по одному счёту. Каждая новая транзакция меняет баланс
+// своего счёта, и на общем семейном счёте одновременные записи всех членов семьи по очереди
+// ждут блокировки одной строки account. Поэтому записи собираются в очередь по счёту:
+// пока пакет пишется, новые записи ждут, а потом уходят следующим пакетом — одна транзакция
+// БД с блокировкой строки счёта, одним UPDATE баланса и одним многострочным INSERT.
+// Каждый ожидающий получает свой результат после COMMIT пакета.
+namespace db {
+
+struct GroupCommitOptions {
+    // Сколько первая запись в пустой очереди ждёт других, мс; 0 — пакет уходит сразу,
+    // а следующий набирается, пока пишется текущий
+    double windowMs = 0;
+    // Записей в одном пакете, не больше
+    size_t maxBatch = 64;
+};
+
+// custom_config.group_commit из config.json. Вызывать после loadConfigFile
+const GroupCommitOptions &loadGroupCommitOptions();
+
+// Транзакция для записи: доступ к счёту и категории уже проверен обработчиком
+struct NewTransaction {
+    int32_t idUser = 0;
+    int32_t idAccount = 0;
+    // Сумма, приведённая amount_utils::amountToString, и её значение для баланса
+    std::string amount;
+    double amountValue = 0;
+    // income или expense
+    std::string type;
+    // 0 — без категории
+    int32_t idCategory = 0;
+    std::string description;
+    bool isFamily = false;
+};
+
+struct NewTransactionResult {
+    // Записанная строка; без неё — отказ с status и error
+    std::optional<drogon_model::financial_manager::Transactions> inserted;
+    drogon::HttpStatusCode status = drogon::k201Created;
+    std::string error;
+};
+
+// Записывает транзакцию и меняет баланс счёта в составе пакета. Расход, после которого
+// баланс стал бы отрицательным, отклоняется (400 Insufficient funds); удалённый счёт — 403.
+// Ошибка БД пробрасывается исключением всем записям пакета. Запросы пакета засчитываются
+// в метрики и профиль req первой записи пакета; срок запроса (utils/Deadline.h) к пакету
+// не применяется — пакет общий для нескольких HTTP-запросов
+drogon::Task<NewTransactionResult> addTransaction(NewTransaction tx, drogon::HttpRequestPtr req = nullptr);
+
+}
@@ -0,0 +1,405 @@
+#include "Idempotency.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <drogon/HttpAppFramework.h>
+#include <drogon/utils/Utilities.h>
+#include <drogon/utils/coroutine.h>
+#include <trantor/net/EventLoop.h>
+#include <trantor/utils/Logger.h>
+#include "DataBase.h"
+#include "utils/Deadline.h"
+#include "utils/JwtUtils.h"
+#include "utils/LoopCache.h"
+#include "utils/Metrics.h"
+
+namespace db {
+
+static IdempotencyOptions g_options;
+
+static const std::string kClaimKey = "idempotency.claim";
+
+// Между проверками строки, занятой запросом из другого процесса, с
+static constexpr double kPollIntervalSec = 0.05;
+
+const IdempotencyOptions &loadIdempotencyOptions() {
+    const auto &cfg = drogon::app().getCustomConfig()["idempotency"];
+    if (cfg.isObject()) {
+        const auto &routes = cfg["routes"];
+        if (routes.isArray()) {
+            for (const auto &route : routes) {
+                g_options.routes.insert(route.asString());
+            }
+        }
+        g_options.ttlSec = cfg.get("ttl_sec", 86400.0).asDouble();
+        g_options.lockSec = cfg.get("lock_sec", 60.0).asDouble();
+        g_options.waitMs = cfg.get("wait_ms", 2000.0).asDouble();
+        g_options.cacheEntries = std::max(1u, cfg.get("cache_entries", 4096).asUInt());
+    }
+    return g_options;
+}
+
+static metrics::Counter &outcomeCounter() {
+    static metrics::Counter c("fm_idempotency_total",
+                              "Requests with Idempotency-Key answered without running the handler",
+                              {"route", "result"});
+    return c;
+}
+
+namespace {
+
+struct StoredResponse {
+    std::string hash;
+    int status = 0;
+    int contentType = 0;
+    std::string body;
+};
+
+// Ключ, занятый запросом; лежит в атрибутах запроса до finishIdempotent
+struct Claim {
+    int64_t userId = 0;
+    std::string key;
+    std::string hash;
+    std::string route;
+    // userId:key — ключ кеша ответов и таблицы запросов в работе
+    std::string cacheKey;
+};
+
+// Дубль, ждущий ответа запроса из того же процесса. Отвечает ему либо этот запрос,
+// либо таймер ожидания — кто первый
+struct Waiter {
+    std::function<void(const drogon::HttpResponsePtr &)> callback;
+    std::string route;
+    std::atomic<bool> answered{false};
+
+    bool answer(const drogon::HttpResponsePtr &resp) {
+        if (answered.exchange(true)) {
+            return false;
+        }
+        callback(resp);
+        return true;
+    }
+};
+
+struct InFlight {
+    std::string hash;
+    std::chrono::steady_clock::time_point started;
+    std::vector<std::shared_ptr<Waiter>> waiters;
+};
+
+}
+
+// Запросы этого процесса, занявшие ключ и ещё не ответившие
+static std::mutex g_inFlightMutex;
+static std::unordered_map<std::string, InFlight> g_inFlight;
+
+using ResponseCache = cache::LoopCache<std::string, StoredResponse>;
+
+static ResponseCache &responseCache() {
+    static ResponseCache cache(g_options.cacheEntries,
+                               std::chrono::duration_cast<ResponseCache::Clock::duration>(
+                                   std::chrono::duration<double>(g_options.ttlSec)));
+    return cache;
+}
+
+// Строка запроса с параметрами в порядке сортировки: ?a=1&b=2 и ?b=2&a=1 — один и тот же запрос
+static std::string normalizedQuery(std::string_view query) {
+    std::vector<std::string_view> params;
+    while (!query.empty()) {
+        const auto end = query.find('&');
+        const auto param = query.substr(0, end);
+        if (!param.empty()) {
+            params.push_back(param);
+        }
+        query.remove_prefix(end == std::string_view::npos ? query.size() : end + 1);
+    }
+    std::sort(params.begin(), params.end());
+    std::string out;
+    for (const auto param : params) {
+        if (!out.empty()) {
+            out += '&';
+        }
+        out += param;
+    }
+    return out;
+}
+
+static drogon::HttpResponsePtr replay(const StoredResponse &stored) {
+    auto resp = drogon::HttpResponse::newHttpResponse();
+    resp->setStatusCode(static_cast<drogon::HttpStatusCode>(stored.status));
+    resp->setContentTypeCode(static_cast<drogon::ContentType>(stored.contentType));
+    resp->setBody(stored.body);
+    resp->addHeader("Idempotent-Replayed", "true");
+    return resp;
+}
+
+static drogon::HttpResponsePtr refuse(drogon::HttpStatusCode code, const char *body) {
+    auto resp = drogon::HttpResponse::newHttpResponse();
+    resp->setStatusCode(code);
+    resp->setBody(body);
+    if (code == drogon::k409Conflict || code == drogon::k503ServiceUnavailable) {
+        resp->addHeader("Retry-After", "1");
+    }
+    return resp;
+}
+
+static drogon::HttpResponsePtr mismatch(const Claim &claim) {
+    outcomeCounter().add({claim.route, "mismatch"});
+    return refuse(drogon::k422UnprocessableEntity, "Idempotency-Key was already used for a different request");
+}
+
+static drogon::HttpResponsePtr inProgress(const std::string &route) {
+    outcomeCounter().add({route, "conflict"});
+    return refuse(drogon::k409Conflict, "A request with this Idempotency-Key is still in progress");
+}
+
+static void answerStored(const StoredResponse &stored,
+                         const Claim &claim,
+                         const std::function<void(const drogon::HttpResponsePtr &)> &callback) {
+    if (stored.hash != claim.hash) {
+        callback(mismatch(claim));
+        return;
+    }
+    outcomeCounter().add({claim.route, "replayed"});
+    callback(replay(stored));
+}
+
+// Если ключ занят запросом этого процесса, дубль ждёт его ответа: true — callback
+// уже вызван или будет вызван позже
+static bool waitLocally(const Claim &claim, const std::function<void(const drogon::HttpResponsePtr &)> &callback) {
+    std::shared_ptr<Waiter> waiter;
+    {
+        std::lock_guard<std::mutex> lock(g_inFlightMutex);
+        auto it = g_inFlight.find(claim.cacheKey);
+        if (it == g_inFlight.end()) {
+            return false;
+        }
+        // Владелец так и не ответил (finishIdempotent не вызван): ключ проверяется через БД
+        if (std::chrono::steady_clock::now() - it->second.started >
+            std::chrono::duration<double>(g_options.lockSec)) {
+            g_inFlight.erase(it);
+            return false;
+        }
+        if (it->second.hash == claim.hash) {
+            waiter = std::make_shared<Waiter>();
+            waiter->callback = callback;
+            waiter->route = claim.route;
+            it->second.waiters.push_back(waiter);
+        }
+    }
+    if (!waiter) {
+        callback(mismatch(claim));
+        return true;
+    }
+    if (auto *loop = trantor::EventLoop::getEventLoopOfCurrentThread()) {
+        loop->runAfter(g_options.waitMs / 1000, [waiter] {
+            if (waiter->answered.load()) {
+                return;
+            }
+            waiter->answer(inProgress(waiter->route));
+        });
+    }
+    return true;
+}
+
+static drogon::AsyncTask claimKey(drogon::HttpRequestPtr req,
+                                  Claim claim,
+                                  std::function<void(const drogon::HttpResponsePtr &)> callback,
+                                  std::function<void()> chain) {
+    // Без req: запросы к таблице ключей не должны считаться записью обработчика
+    // и отменяться по сроку запроса (utils/Deadline.h)
+    auto db = getDbClient();
+    double waitMs = g_options.waitMs;
+    if (auto deadline = deadline::requestDeadline(req)) {
+        waitMs = std::min(waitMs, deadline->remainingMs());
+    }
+    const auto giveUp = std::chrono::steady_clock::now() +
+                        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            std::chrono::duration<double, std::milli>(waitMs));
+    bool claimed = false;
+    try {
+        bool tryClaim = true;
+        while (true) {
+            if (tryClaim) {
+                // Истёкшая строка (ответ устарел или владелец не ответил за lockSec) занимается заново
+                auto rows = co_await db->execSqlCoro(
+                    R"(
+                    /*idempotency_claim_v1*/
+                    INSERT INTO idempotency_keys (id_user, idem_key, request_hash, expires_at)
+                    VALUES ($1::int8, $2, $3, NOW() + make_interval(secs => $4::float8))
+                    ON CONFLICT (id_user, idem_key) DO UPDATE
+                    SET request_hash = EXCLUDED.request_hash, status = NULL, content_type = NULL,
+                        body = NULL, expires_at = EXCLUDED.expires_at
+                    WHERE idempotency_keys.expires_at < NOW()
+                    RETURNING id_user
+                    )", claim.userId, claim.key, claim.hash, g_options.lockSec);
+                if (!rows.empty()) {
+                    claimed = true;
+                    break;
+                }
+            }
+            auto rows = co_await db->execSqlCoro(
+                R"(
+                /*idempotency_lookup_v1*/
+                SELECT request_hash, status, content_type, body, expires_at < NOW() AS expired
+                FROM idempotency_keys
+                WHERE id_user = $1::int8 AND idem_key = $2
+                )", claim.userId, claim.key);
+            // Строку удалили или она истекла между запросами — занимаем снова
+            tryClaim = rows.empty() || rows[0]["expired"].as<bool>();
+            if (tryClaim) {
+                continue;
+            }
+            if (!rows[0]["status"].isNull()) {
+                StoredResponse stored;
+                stored.hash = rows[0]["request_hash"].as<std::string>();
+                stored.status = rows[0]["status"].as<int>();
+                stored.contentType = rows[0]["content_type"].as<int>();
+                stored.body = rows[0]["body"].as<std::string>();
+                answerStored(stored, claim, callback);
+                responseCache().put(claim.cacheKey, std::move(stored));
+                co_return;
+            }
+            if (rows[0]["request_hash"].as<std::string>() != claim.hash) {
+                callback(mismatch(claim));
+                co_return;
+            }
+            if (waitLocally(claim, callback)) {
+                co_return;
+            }
+            if (std::chrono::steady_clock::now() >= giveUp) {
+                callback(inProgress(claim.route));
+                co_return;
+            }
+            co_await drogon::sleepCoro(trantor::EventLoop::getEventLoopOfCurrentThread(), kPollIntervalSec);
+        }
+    } catch (const std::exception &e) {
+        LOG_ERROR << "Idempotency key error: " << e.what();
+        callback(refuse(drogon::k503ServiceUnavailable, "Idempotency-Key storage is unavailable"));
+        co_return;
+    }
+    if (claimed) {
+        {
+            std::lock_guard<std::mutex> lock(g_inFlightMutex);
+            g_inFlight.insert_or_assign(claim.cacheKey, InFlight{claim.hash, std::chrono::steady_clock::now(), {}});
+        }
+        req->attributes()->insert(kClaimKey, std::move(claim));
+        chain();
+    }
+}
+
+void beginIdempotent(const drogon::HttpRequestPtr &req,
+                     std::function<void(const drogon::HttpResponsePtr &)> callback,
+                     std::function<void()> chain) {
+    const auto &key = req->getHeader("Idempotency-Key");
+    if (key.empty()) {
+        chain();
+        return;
+    }
+    Claim claim;
+    claim.route = std::string(req->methodString()) + " " + std::string(req->matchedPathPattern());
+    if (!g_options.routes.contains(claim.route)) {
+        chain();
+        return;
+    }
+    // Без пользователя обработчик сам ответит 401
+    auto userId = jwt_utils::getUserIdFromRequest(req);
+    if (!userId) {
+        chain();
+        return;
+    }
+    if (key.size() > 255) {
+        callback(refuse(drogon::k400BadRequest, "Idempotency-Key is longer than 255 characters"));
+        return;
+    }
+    claim.userId = *userId;
+    claim.key = key;
+    // Параметры строки запроса (family=true) меняют смысл запроса так же, как тело
+    claim.hash = drogon::utils::getMd5(std::string(req->methodString()) + " " + req->path() + "?" +
+                                       normalizedQuery(req->query()) + "\n" + std::string(req->body()));
+    claim.cacheKey = std::to_string(*userId) + ":" + key;
+
+    if (const auto *stored = responseCache().find(claim.cacheKey)) {
+        answerStored(*stored, claim, callback);
+        return;
+    }
+    if (waitLocally(claim, callback)) {
+        return;
+    }
+    claimKey(req, std::move(claim), std::move(callback), std::move(chain));
+}
+
+void finishIdempotent(const drogon::HttpRequestPtr &req, const drogon::HttpResponsePtr &resp) {
+    const auto &attrs = req->attributes();
+    if (!attrs->find(kClaimKey)) {
+        return;
+    }
+    const auto claim = attrs->get<Claim>(kClaimKey);
+    attrs->erase(kClaimKey);
+
+    std::vector<std::shared_ptr<Waiter>> waiters;
+    {
+        std::lock_guard<std::mutex> lock(g_inFlightMutex);
+        auto it = g_inFlight.find(claim.cacheKey);
+        if (it != g_inFlight.end()) {
+            waiters = std::move(it->second.waiters);
+            g_inFlight.erase(it);
+        }
+    }
+
+    auto db = getDbClient();
+    auto logError = [](const drogon::orm::DrogonDbException &e) {
+        LOG_ERROR << "Idempotency key error: " << e.base().what();
+    };
+    const int status = static_cast<int>(resp->statusCode());
+    if (status >= 500) {
+        // Ошибку не запоминаем: повтор с тем же ключом выполнится заново
+        db->execSqlAsync(
+            "/*idempotency_release_v1*/ DELETE FROM idempotency_keys "
+            "WHERE id_user = $1::int8 AND idem_key = $2 AND status IS NULL",
+            [](const drogon::orm::Result &) {}, logError, claim.userId, claim.key);
+        for (const auto &waiter : waiters) {
+            waiter->answer(refuse(drogon::k409Conflict, "The request with this Idempotency-Key failed, retry it"));
+        }
+        return;
+    }
+
+    StoredResponse stored;
+    stored.hash = claim.hash;
+    stored.status = status;
+    stored.contentType = static_cast<int>(resp->contentType());
+    stored.body = std::string(resp->body());
+    db->execSqlAsync(
+        "/*idempotency_store_v1*/ UPDATE idempotency_keys "
+        "SET status = $3::int4, content_type = $4::int4, body = $5, "
+        "expires_at = NOW() + make_interval(secs => $6::float8) "
+        "WHERE id_user = $1::int8 AND idem_key = $2",
+        [](const drogon::orm::Result &) {}, logError, claim.userId, claim.key, stored.status,
+        stored.contentType, stored.body, g_options.ttlSec);
+    for (const auto &waiter : waiters) {
+        if (waiter->answer(replay(stored))) {
+            outcomeCounter().add({claim.route, "coalesced"});
+        }
+    }
+    responseCache().put(claim.cacheKey, std::move(stored));
+}
+
+void scheduleIdempotencyCleanup() {
+    // Истёкшие строки и так занимаются заново при повторе; удаление только держит таблицу небольшой
+    drogon::app().getLoop()->runEvery(600, [] {
+        getDbClient()->execSqlAsync(
+            "/*idempotency_cleanup_v1*/ DELETE FROM idempotency_keys WHERE expires_at < NOW()",
+            [](const drogon::orm::Result &) {},
+            [](const drogon::orm::DrogonDbException &e) {
+                LOG_ERROR << "Idempotency cleanup error: " << e.base().what();
+            });
+    });
+}
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <drogon/HttpRequest.h>
+#include <drogon/HttpResponse.h>
+
+// Заголовок Idempotency-Key для создающих запросов: повтор запроса с тем же ключом (клиент
+// не дождался ответа и отправил его снова) не выполняет обработчик второй раз, а получает
+// сохранённый ответ первого. Ключ действует в пределах пользователя и хранится в таблице
+// idempotency_keys (db/migrations/002_idempotency_keys.sql) вместе с хешем запроса и ответом;
+// недавние ответы дополнительно кешируются в шардах IO-потоков (utils/LoopCache.h).
+//
+// Первый запрос с ключом занимает его строкой в таблице; одновременный дубль ждёт его ответа
+// (в том же процессе — без обращений к БД, из другого процесса — перечитывая строку) и
+// получает 409, если не дождался. Тот же ключ с другим телом или путём — 422. Ответы 5xx не
+// сохраняются: ключ освобождается, и повтор выполняется заново.
+namespace db {
+
+struct IdempotencyOptions {
+    // Маршруты с поддержкой ключа: метод и шаблон пути, как ключи custom_config.deadlines.routes.
+    // По умолчанию пусто: включать после применения миграции 002_idempotency_keys.sql
+    std::unordered_set<std::string> routes;
+    // Сколько хранится ответ, с
+    double ttlSec = 86400;
+    // Сколько ключ занят незавершённым запросом; потом его может занять повтор
+    // (на случай падения процесса между записью и сохранением ответа)
+    double lockSec = 60;
+    // Сколько дубль ждёт ответа первого запроса, прежде чем получить 409, мс
+    double waitMs = 2000;
+    // Ответов в кеше одного IO-потока
+    size_t cacheEntries = 4096;
+};
+
+// custom_config.idempotency из config.json. Вызывать после loadConfigFile
+const IdempotencyOptions &loadIdempotencyOptions();
+
+// Pre-handling advice: отвечает сохранённым ответом, 409 или 422 через callback либо
+// занимает ключ и передаёт запрос дальше через chain
+void beginIdempotent(const drogon::HttpRequestPtr &req,
+                     std::function<void(const drogon::HttpResponsePtr &)> callback,
+                     std::function<void()> chain);
+
+// Post-handling advice: сохраняет ответ запроса, занявшего ключ, и отдаёт его ждущим дублям
+void finishIdempotent(const drogon::HttpRequestPtr &req, const drogon::HttpResponsePtr &resp);
+
+// Периодически удаляет из таблицы истёкшие ключи. Вызывать до app().run()
+void scheduleIdempotencyCleanup();
+
+}
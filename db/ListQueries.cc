@@ -0,0 +1,183 @@
+#include "ListQueries.h"
+#include "models/Account.h"
+#include "models/Category.h"
+#include "models/Transactions.h"
+#include "models/Transfer.h"
+#include "models/Budgets.h"
+#include "utils/LoopCache.h"
+#include "DataBase.h"
+#include "Statements.h"
+#include <array>
+#include <atomic>
+#include <new>
+#include <sys/mman.h>
+
+using namespace drogon_model::financial_manager;
+using drogon::Task;
+
+namespace db {
+
+// Модель -> JSON с явно выставленным is_family, как в контроллерах
+template <typename Model>
+static Json::Value toJsonArray(const drogon::orm::Result &rows) {
+    Json::Value arr(Json::arrayValue);
+    for (const auto &row : rows) {
+        Model m(row);
+        auto json = m.toJson();
+        auto isFamilyPtr = m.getIsFamily();
+        json["is_family"] = isFamilyPtr ? *isFamilyPtr : false;
+        arr.append(json);
+    }
+    return arr;
+}
+
+static Task<Json::Value> loadAccounts(drogon::orm::DbClientPtr db, int64_t userId, bool family) {
+    if (family) {
+        auto rows = co_await exec(db, stmt::familyAccounts, userId);
+        co_return toJsonArray<Account>(rows);
+    }
+    auto rows = co_await db->execSqlCoro(
+        R"(
+        /*list_personal_accounts_v1*/
+        SELECT id, id_user, account_type, account_name, balance, created_at, is_family
+        FROM account
+        WHERE id_user = $1::int8
+          AND is_family = FALSE
+        ORDER BY created_at DESC
+        )", userId);
+    co_return toJsonArray<Account>(rows);
+}
+
+static Task<Json::Value> loadCategories(drogon::orm::DbClientPtr db, int64_t userId, bool family) {
+    if (family) {
+        auto rows = co_await exec(db, stmt::familyCategories, userId);
+        co_return toJsonArray<Category>(rows);
+    }
+    auto rows = co_await db->execSqlCoro(
+        R"(
+        /*list_personal_categories_v1*/
+        SELECT id, id_user, name, type, is_family
+        FROM category
+        WHERE id_user = $1::int8
+          AND is_family = FALSE
+        )", userId);
+    co_return toJsonArray<Category>(rows);
+}
+
+// Эпохи для инвалидации кеша списков. Изменение данных пользователем увеличивает
+// эпоху его полосы и семейную эпоху (семейные списки собираются из данных всех членов
+// семьи, а семья пользователя здесь неизвестна). Читатель запоминает эпоху до запроса к БД,
+// поэтому запись, завершившаяся во время запроса, не оставит в кеше старые данные.
+struct ListEpochs {
+    std::array<std::atomic<uint64_t>, 64> personal{};
+    std::atomic<uint64_t> family{0};
+};
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "epochs must be usable from shared memory");
+
+// Эпохи лежат в общей анонимной памяти. Она создаётся при статической инициализации,
+// то есть до fork(), и видна всем рабочим процессам prefork-режима (см. utils/Prefork.h):
+// запись в одном процессе сбрасывает кеши во всех
+static ListEpochs *createEpochs() {
+    void *mem = mmap(nullptr, sizeof(ListEpochs), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        return new ListEpochs();
+    }
+    return new (mem) ListEpochs();
+}
+
+static ListEpochs *const epochs = createEpochs();
+
+static uint64_t listEpoch(int64_t userId, bool family) {
+    if (family) {
+        return epochs->family.load(std::memory_order_acquire);
+    }
+    return epochs->personal[static_cast<uint64_t>(userId) % epochs->personal.size()].load(std::memory_order_acquire);
+}
+
+void invalidateLists(int64_t userId) {
+    epochs->personal[static_cast<uint64_t>(userId) % epochs->personal.size()].fetch_add(1, std::memory_order_acq_rel);
+    epochs->family.fetch_add(1, std::memory_order_acq_rel);
+}
+
+// Счета и категории читаются почти каждой страницей и меняются редко — держим их
+// в шардах IO-потоков. Ключ: userId * 2 + family.
+using ListCache = cache::LoopCache<int64_t, Json::Value>;
+
+static Task<Json::Value> cachedList(ListCache &cache,
+                                    Task<Json::Value> (*load)(drogon::orm::DbClientPtr, int64_t, bool),
+                                    drogon::orm::DbClientPtr db, int64_t userId, bool family) {
+    const int64_t key = userId * 2 + (family ? 1 : 0);
+    const uint64_t epoch = listEpoch(userId, family);
+    if (const auto *hit = cache.find(key, epoch)) {
+        co_return *hit;
+    }
+    // Реплика сразу после чьей-то записи могла её ещё не получить: такой список
+    // отдаётся, но не кешируется
+    const bool stale = mayBeStale(db);
+    auto list = co_await load(std::move(db), userId, family);
+    if (!stale) {
+        cache.put(key, list, epoch);
+    }
+    co_return list;
+}
+
+Task<Json::Value> accountsJson(drogon::orm::DbClientPtr db, int64_t userId, bool family) {
+    static ListCache cache(1024, std::chrono::seconds(30));
+    co_return co_await cachedList(cache, &loadAccounts, std::move(db), userId, family);
+}
+
+Task<Json::Value> categoriesJson(drogon::orm::DbClientPtr db, int64_t userId, bool family) {
+    static ListCache cache(1024, std::chrono::seconds(30));
+    co_return co_await cachedList(cache, &loadCategories, std::move(db), userId, family);
+}
+
+Task<Json::Value> transactionsJson(drogon::orm::DbClientPtr db, int64_t userId, bool family) {
+    if (family) {
+        auto rows = co_await exec(db, stmt::familyTransactions, userId);
+        co_return toJsonArray<Transactions>(rows);
+    }
+    auto rows = co_await db->execSqlCoro(
+        R"(
+        /*list_personal_transactions_v1*/
+        SELECT * FROM transactions
+        WHERE id_user = $1::int8
+          AND is_family = FALSE
+        ORDER BY created_at DESC
+        )", userId);
+    co_return toJsonArray<Transactions>(rows);
+}
+
+Task<Json::Value> transfersJson(drogon::orm::DbClientPtr db, int64_t userId, bool family) {
+    if (family) {
+        auto rows = co_await exec(db, stmt::familyTransfers, userId);
+        co_return toJsonArray<Transfer>(rows);
+    }
+    auto rows = co_await db->execSqlCoro(
+        R"(
+        /*list_personal_transfers_v1*/
+        SELECT * FROM transfer
+        WHERE id_user = $1::int8
+          AND is_family = FALSE
+        ORDER BY created_at DESC
+        )", userId);
+    co_return toJsonArray<Transfer>(rows);
+}
+
+Task<Json::Value> budgetsJson(drogon::orm::DbClientPtr db, int64_t userId, bool family) {
+    if (family) {
+        auto rows = co_await exec(db, stmt::familyBudgets, userId);
+        co_return toJsonArray<Budgets>(rows);
+    }
+    auto rows = co_await db->execSqlCoro(
+        R"(
+        /*list_personal_budgets_v1*/
+        SELECT id, id_user, id_category, month, year, limit_amount, is_family, created_at
+        FROM budgets
+        WHERE id_user = $1::int8
+          AND is_family = FALSE
+        ORDER BY year DESC, month DESC
+        )", userId);
+    co_return toJsonArray<Budgets>(rows);
+}
+
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <drogon/orm/DbClient.h>
+#include <drogon/utils/coroutine.h>
+#include <jsoncpp/json/json.h>
+
+// Списки сущностей пользователя в том же JSON, что отдают GET /accounts, /categories,
+// /transactions, /transfers и /budgets. Используются для стартовых данных страниц.
+// Счета и категории кешируются в шардах IO-потоков (см. utils/LoopCache.h).
+namespace db {
+
+drogon::Task<Json::Value> accountsJson(drogon::orm::DbClientPtr db, int64_t userId, bool family);
+drogon::Task<Json::Value> categoriesJson(drogon::orm::DbClientPtr db, int64_t userId, bool family);
+drogon::Task<Json::Value> transactionsJson(drogon::orm::DbClientPtr db, int64_t userId, bool family);
+drogon::Task<Json::Value> transfersJson(drogon::orm::DbClientPtr db, int64_t userId, bool family);
+drogon::Task<Json::Value> budgetsJson(drogon::orm::DbClientPtr db, int64_t userId, bool family);
+
+// Сбрасывает закешированные списки пользователя и все семейные списки.
+// Вызывается после каждого успешного изменяющего запроса (см. main.cc)
+void invalidateLists(int64_t userId);
+
+}
@@ -0,0 +1,412 @@
+#include "MeteredDbClient.h"
+#include "PoolLoad.h"
+#include <drogon/orm/Exception.h>
+#include <drogon/orm/Result.h>
+#include <drogon/HttpAppFramework.h>
+#include <trantor/utils/Date.h>
+#include <trantor/utils/Logger.h>
+#include <jsoncpp/json/json.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <unordered_set>
+
+namespace db {
+
+static SlowQueryOptions g_slowOptions;
+
+const SlowQueryOptions &loadSlowQueryOptions() {
+    const auto &cfg = drogon::app().getCustomConfig()["slow_queries"];
+    if (cfg.isObject()) {
+        g_slowOptions.thresholdMs = cfg.get("threshold_ms", 0.0).asDouble();
+        g_slowOptions.explain = cfg.get("explain", false).asBool();
+        g_slowOptions.explainFile = cfg.get("explain_file", g_slowOptions.explainFile).asString();
+        g_slowOptions.explainIntervalSec = cfg.get("explain_interval_sec", 60.0).asDouble();
+    }
+    if (const char *env = std::getenv("FM_SLOW_QUERY_MS")) {
+        g_slowOptions.thresholdMs = std::atof(env);
+    }
+    return g_slowOptions;
+}
+
+static bool isTagChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// Запрос только читает: первое слово после комментариев — SELECT. Остальное
+// (INSERT/UPDATE/DELETE мапперов, WITH, которым тоже можно писать) считается записью
+static bool isReadOnly(std::string_view sql) {
+    size_t i = 0;
+    for (;;) {
+        while (i < sql.size() && std::isspace(static_cast<unsigned char>(sql[i]))) {
+            ++i;
+        }
+        if (sql.substr(i, 2) != "/*") {
+            break;
+        }
+        auto close = sql.find("*/", i + 2);
+        if (close == std::string_view::npos) {
+            return false;
+        }
+        i = close + 2;
+    }
+    constexpr std::string_view kSelect = "select";
+    if (sql.size() - i < kSelect.size()) {
+        return false;
+    }
+    for (size_t j = 0; j < kSelect.size(); ++j) {
+        if (std::tolower(static_cast<unsigned char>(sql[i + j])) != kSelect[j]) {
+            return false;
+        }
+    }
+    return sql.size() - i == kSelect.size() || !isTagChar(sql[i + kSelect.size()]);
+}
+
+static metrics::Counter &cancelledStatements() {
+    static metrics::Counter c("fm_db_statements_cancelled_total",
+                              "Statements not sent because the request deadline passed or the client disconnected",
+                              {"tag", "reason"});
+    return c;
+}
+
+std::string statementTag(std::string_view sql) {
+    if (auto open = sql.find("/*"); open != std::string_view::npos) {
+        auto close = sql.find("*/", open + 2);
+        if (close != std::string_view::npos) {
+            auto tag = sql.substr(open + 2, close - open - 2);
+            while (!tag.empty() && tag.front() == ' ') tag.remove_prefix(1);
+            while (!tag.empty() && tag.back() == ' ') tag.remove_suffix(1);
+            if (!tag.empty() && tag.size() <= 64 && std::all_of(tag.begin(), tag.end(), isTagChar)) {
+                return std::string(tag);
+            }
+        }
+    }
+
+    // Слова запроса в нижнем регистре: команда и таблица после FROM / INTO / UPDATE
+    std::string command;
+    std::string table;
+    std::string previous;
+    size_t i = 0;
+    while (i < sql.size() && table.empty()) {
+        while (i < sql.size() && !isTagChar(sql[i])) {
+            ++i;
+        }
+        std::string word;
+        while (i < sql.size() && isTagChar(sql[i])) {
+            word += static_cast<char>(std::tolower(static_cast<unsigned char>(sql[i++])));
+        }
+        if (word.empty()) {
+            break;
+        }
+        if (command.empty()) {
+            command = word;
+            if (command == "update") {
+                previous = word;
+                continue;
+            }
+        } else if (previous == "from" || previous == "into" || previous == "update") {
+            table = word;
+        }
+        previous = word;
+    }
+    if (command.empty()) {
+        return "unknown";
+    }
+    return table.empty() ? command : command + "_" + table;
+}
+
+// Передаёт уже собранный запрос клиенту client через публичный SqlBinder (как execSqlAsync):
+// текстовые параметры — строками, двоичные — теми же байтами (SqlBinder кодирует числа
+// в сетевом порядке при записи, так что повторно они не перекодируются), NULL — nullptr
+static void forwardSql(drogon::orm::DbClient &client,
+                       const char *sql,
+                       size_t sqlLength,
+                       size_t paraNum,
+                       const std::vector<const char *> &parameters,
+                       const std::vector<int> &length,
+                       const std::vector<int> &format,
+                       drogon::orm::ResultCallback &&rcb,
+                       std::function<void(const std::exception_ptr &)> &&exceptCallback) {
+    auto binder = client << std::string(sql, sqlLength);
+    for (size_t i = 0; i < paraNum; ++i) {
+        if (parameters[i] == nullptr) {
+            binder << nullptr;
+        } else if (format[i] == 0) {
+            binder << std::string(parameters[i]);
+        } else {
+            binder << std::vector<char>(parameters[i], parameters[i] + length[i]);
+        }
+    }
+    binder >> std::move(rcb);
+    binder >> std::move(exceptCallback);
+    binder.exec();
+}
+
+// Медленный запрос, отложенный до ответа БД: типы параметров (по формату и длине,
+// как их кодирует SqlBinder) и, если для тега ещё нужен план, копия текста и параметров
+struct SlowQuerySample {
+    std::string tag;
+    Json::Value paramTypes{Json::arrayValue};
+    bool wantsPlan = false;
+    std::string sql;
+    std::vector<std::optional<std::string>> params;
+    std::vector<int> length;
+    std::vector<int> format;
+};
+
+static const char *paramType(const char *value, int length, int format) {
+    if (value == nullptr) {
+        return "null";
+    }
+    if (format == 0) {
+        return "text";
+    }
+    switch (length) {
+        case 1: return "bool";
+        case 2: return "int2";
+        case 4: return "int4";
+        case 8: return "int8";
+        default: return "binary";
+    }
+}
+
+static std::mutex &explainMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+// Теги, для которых план уже снят (или снимается)
+static std::unordered_set<std::string> &explainedTags() {
+    static std::unordered_set<std::string> tags;
+    return tags;
+}
+
+static bool planWanted(const std::string &tag) {
+    std::lock_guard lock(explainMutex());
+    return !explainedTags().count(tag);
+}
+
+// Занимает тег и окно rate limit-а; false — план сейчас снимать не нужно
+static bool claimExplain(const std::string &tag) {
+    static std::chrono::steady_clock::time_point last;
+    std::lock_guard lock(explainMutex());
+    auto now = std::chrono::steady_clock::now();
+    if (explainedTags().count(tag) ||
+        (last.time_since_epoch().count() != 0 &&
+         now - last < std::chrono::duration<double>(g_slowOptions.explainIntervalSec))) {
+        return false;
+    }
+    last = now;
+    explainedTags().insert(tag);
+    return true;
+}
+
+static void writePlan(const SlowQuerySample &sample, double ms, const drogon::orm::Result &plan) {
+    std::lock_guard lock(explainMutex());
+    std::ofstream out(g_slowOptions.explainFile, std::ios::app);
+    if (!out) {
+        LOG_ERROR << "Cannot open " << g_slowOptions.explainFile << " for slow query plans";
+        return;
+    }
+    out << "-- " << trantor::Date::now().toFormattedString(false) << " " << sample.tag << " " << ms << " ms\n";
+    out << sample.sql << "\n";
+    for (const auto &row : plan) {
+        out << row[0ul].as<std::string>() << "\n";
+    }
+    out << "\n";
+}
+
+static void explain(const drogon::orm::DbClientPtr &client, std::shared_ptr<SlowQuerySample> sample, double ms) {
+    if (!claimExplain(sample->tag)) {
+        return;
+    }
+    // ANALYZE выполняет запрос по-настоящему, поэтому изменяющие запросы откатываются
+    client->newTransactionAsync([sample, ms](const std::shared_ptr<drogon::orm::Transaction> &trans) {
+        if (!trans) {
+            return;
+        }
+        const std::string sql = "EXPLAIN (ANALYZE, BUFFERS) " + sample->sql;
+        std::vector<const char *> params;
+        for (const auto &p : sample->params) {
+            params.push_back(p ? p->c_str() : nullptr);
+        }
+        forwardSql(
+            *trans, sql.data(), sql.size(), params.size(), params, sample->length, sample->format,
+            [trans, sample, ms](const drogon::orm::Result &plan) {
+                writePlan(*sample, ms, plan);
+                trans->rollback();
+            },
+            [trans, sample](const std::exception_ptr &e) {
+                try {
+                    std::rethrow_exception(e);
+                } catch (const std::exception &ex) {
+                    LOG_WARN << "EXPLAIN for " << sample->tag << " failed: " << ex.what();
+                }
+                trans->rollback();
+            });
+    });
+}
+
+static void reportSlowQuery(const drogon::orm::DbClientPtr &client,
+                            const std::shared_ptr<SlowQuerySample> &sample,
+                            double ms,
+                            size_t rows,
+                            bool failed) {
+    Json::Value entry;
+    entry["tag"] = sample->tag;
+    entry["ms"] = ms;
+    entry["rows"] = static_cast<Json::UInt64>(rows);
+    entry["params"] = sample->paramTypes;
+    if (failed) {
+        entry["error"] = true;
+    }
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    LOG_WARN << "Slow query " << Json::writeString(builder, entry);
+
+    if (sample->wantsPlan && !failed && client) {
+        explain(client, sample, ms);
+    }
+}
+
+static metrics::Histogram &queryDuration() {
+    static metrics::Histogram h("fm_db_query_duration_seconds",
+                                "Database round trip time, by statement tag",
+                                {"tag"},
+                                {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 1});
+    return h;
+}
+
+static metrics::Counter &queryRows() {
+    static metrics::Counter c("fm_db_query_rows_total", "Rows returned, by statement tag", {"tag"});
+    return c;
+}
+
+static metrics::Counter &queryErrors() {
+    static metrics::Counter c("fm_db_query_errors_total", "Failed statements, by statement tag", {"tag"});
+    return c;
+}
+
+MeteredDbClient::MeteredDbClient(drogon::orm::DbClientPtr inner,
+                                 std::shared_ptr<metrics::RequestDbStats> stats,
+                                 std::shared_ptr<profiling::Trace> trace,
+                                 bool replica,
+                                 std::shared_ptr<deadline::Deadline> deadline)
+    : inner_(std::move(inner)),
+      stats_(std::move(stats)),
+      trace_(std::move(trace)),
+      deadline_(std::move(deadline)),
+      replica_(replica) {
+    // EXPLAIN ANALYZE открывает свою транзакцию на base_; на транзакции пользователя его
+    // выполнять нельзя — он повторил бы запрос в ней и откатил бы её
+    if (!std::dynamic_pointer_cast<drogon::orm::Transaction>(inner_)) {
+        base_ = inner_;
+    }
+    type_ = inner_->type();
+    connectionInfo_ = inner_->connectionInfo();
+}
+
+void MeteredDbClient::execSql(const char *sql,
+                              size_t sqlLength,
+                              size_t paraNum,
+                              std::vector<const char *> &&parameters,
+                              std::vector<int> &&length,
+                              std::vector<int> &&format,
+                              drogon::orm::ResultCallback &&rcb,
+                              std::function<void(const std::exception_ptr &)> &&exceptCallback) {
+    using Clock = std::chrono::steady_clock;
+    auto tag = statementTag(std::string_view(sql, sqlLength));
+
+    // Ответ уже не нужен: запрос не отправляется, обработчик получает ошибку и прекращает работу
+    if (deadline_) {
+        if (const char *reason = deadline_->cancelReason(!isReadOnly(std::string_view(sql, sqlLength)))) {
+            cancelledStatements().add({tag, reason});
+            exceptCallback(std::make_exception_ptr(
+                drogon::orm::TimeoutError(std::string("Statement cancelled: ") + reason)));
+            return;
+        }
+    }
+
+    // Параметры живут только до отправки запроса, поэтому всё нужное для лога медленных
+    // запросов собирается заранее. Копия для EXPLAIN — пока план для тега не снят
+    std::shared_ptr<SlowQuerySample> slow;
+    if (g_slowOptions.thresholdMs > 0) {
+        slow = std::make_shared<SlowQuerySample>();
+        slow->tag = tag;
+        for (size_t i = 0; i < paraNum; ++i) {
+            slow->paramTypes.append(paramType(parameters[i], length[i], format[i]));
+        }
+        if (g_slowOptions.explain && base_ && planWanted(tag)) {
+            slow->wantsPlan = true;
+            slow->sql.assign(sql, sqlLength);
+            for (size_t i = 0; i < paraNum; ++i) {
+                if (parameters[i] == nullptr) {
+                    slow->params.emplace_back();
+                } else if (format[i] == 0) {
+                    slow->params.emplace_back(std::string(parameters[i]));
+                } else {
+                    slow->params.emplace_back(std::string(parameters[i], static_cast<size_t>(length[i])));
+                }
+            }
+            slow->length = length;
+            slow->format = format;
+        }
+    }
+
+    // Загрузка пула считается только для основной базы: по ней решается, отклонять ли запросы
+    PoolLoad *pool = replica_ ? nullptr : &localPoolLoad();
+    const bool queued = pool && statementStarted(*pool);
+    auto start = Clock::now();
+    auto elapsed = [start] {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    };
+    forwardSql(
+        *inner_, sql, sqlLength, paraNum, parameters, length, format,
+        [rcb = std::move(rcb), stats = stats_, trace = trace_, base = base_, slow, tag, elapsed, pool, queued](
+            const drogon::orm::Result &result) {
+            const double seconds = elapsed();
+            if (pool) {
+                statementFinished(*pool, queued, seconds);
+            }
+            queryDuration().observe({tag}, seconds);
+            if (trace) {
+                trace->add("db." + tag, seconds * 1000);
+            }
+            if (slow && seconds * 1000 >= g_slowOptions.thresholdMs) {
+                reportSlowQuery(base, slow, seconds * 1000, result.size(), false);
+            }
+            queryRows().add({tag}, static_cast<double>(result.size()));
+            if (stats) {
+                ++stats->queries;
+                stats->rows += result.size();
+            }
+            rcb(result);
+        },
+        [exceptCallback = std::move(exceptCallback), stats = stats_, trace = trace_, base = base_, slow, tag,
+         elapsed, pool, queued](const std::exception_ptr &e) {
+            const double seconds = elapsed();
+            if (pool) {
+                statementFinished(*pool, queued, seconds);
+            }
+            queryDuration().observe({tag}, seconds);
+            if (trace) {
+                trace->add("db." + tag, seconds * 1000);
+            }
+            if (slow && seconds * 1000 >= g_slowOptions.thresholdMs) {
+                reportSlowQuery(base, slow, seconds * 1000, 0, true);
+            }
+            queryErrors().add({tag});
+            if (stats) {
+                ++stats->queries;
+            }
+            exceptCallback(e);
+        });
+}
+
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <drogon/orm/DbClient.h>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "utils/Deadline.h"
+#include "utils/Metrics.h"
+#include "utils/Profiling.h"
+
+// Обёртка над клиентом БД, которая замеряет каждый запрос: гистограмма времени и счётчики
+// строк и ошибок по тегу запроса (fm_db_query_*), плюс счётчики HTTP-запроса, в рамках
+// которого он выполнен (metrics::RequestDbStats), и участок db.<тег> в профиле запроса,
+// если профилирование включено (utils/Profiling.h). Медленные запросы пишутся в лог,
+// а их планы — в файл (SlowQueryOptions). Выдаётся db::getDbClient() на каждый вызов,
+// сама обёртка ничего не хранит, кроме указателей. Запросы в транзакции замеряются,
+// если она открыта через db::TxScope (db/Transaction.h).
+// Запросы к основной базе учитываются в загрузке пула (db/PoolLoad.h). Со сроком запроса
+// (utils/Deadline.h) чтения после срока или отключения клиента не отправляются.
+namespace db {
+
+struct SlowQueryOptions {
+    // Запросы дольше порога попадают в лог: тег, типы параметров, время и число строк.
+    // Значения параметров не пишутся. 0 — не логировать
+    double thresholdMs = 0;
+    // Для первого медленного запроса каждого тега выполнить EXPLAIN (ANALYZE, BUFFERS)
+    // в откатываемой транзакции и дописать план в explainFile
+    bool explain = false;
+    std::string explainFile = "slow_query_plans.log";
+    // Не чаще одного EXPLAIN за интервал на процесс
+    double explainIntervalSec = 60;
+};
+
+// custom_config.slow_queries из config.json; FM_SLOW_QUERY_MS имеет приоритет.
+// Вызывать после loadConfigFile
+const SlowQueryOptions &loadSlowQueryOptions();
+
+// Тег запроса: имя из первого комментария /*tag*/, иначе "<команда>_<таблица>"
+// (select_account, insert_transactions) для запросов мапперов и запросов без тега
+std::string statementTag(std::string_view sql);
+
+class MeteredDbClient : public drogon::orm::DbClient {
+public:
+    MeteredDbClient(drogon::orm::DbClientPtr inner,
+                    std::shared_ptr<metrics::RequestDbStats> stats,
+                    std::shared_ptr<profiling::Trace> trace = nullptr,
+                    bool replica = false,
+                    std::shared_ptr<deadline::Deadline> deadline = nullptr);
+
+    // Такая же обёртка (счётчики и профиль того же HTTP-запроса, его срок) над другим
+    // клиентом — транзакцией, открытой на этом (db::TxScope)
+    std::shared_ptr<MeteredDbClient> withInner(drogon::orm::DbClientPtr inner) const {
+        auto client = std::make_shared<MeteredDbClient>(std::move(inner), stats_, trace_, replica_, deadline_);
+        if (!client->base_) {
+            client->base_ = base_;
+        }
+        return client;
+    }
+
+    // Запросы уходят на реплику (db::getReadDbClient)
+    bool isReplica() const {
+        return replica_;
+    }
+
+    void execSql(const char *sql,
+                 size_t sqlLength,
+                 size_t paraNum,
+                 std::vector<const char *> &&parameters,
+                 std::vector<int> &&length,
+                 std::vector<int> &&format,
+                 drogon::orm::ResultCallback &&rcb,
+                 std::function<void(const std::exception_ptr &)> &&exceptCallback) override;
+    std::shared_ptr<drogon::orm::Transaction> newTransaction(
+        const std::function<void(bool)> &commitCallback = std::function<void(bool)>()) noexcept(false) override {
+        return inner_->newTransaction(commitCallback);
+    }
+    void newTransactionAsync(
+        const std::function<void(const std::shared_ptr<drogon::orm::Transaction> &)> &callback) override {
+        inner_->newTransactionAsync(callback);
+    }
+    bool hasAvailableConnections() const noexcept override {
+        return inner_->hasAvailableConnections();
+    }
+    void setTimeout(double timeout) override {
+        inner_->setTimeout(timeout);
+    }
+    void closeAll() override {
+        inner_->closeAll();
+    }
+
+private:
+    drogon::orm::DbClientPtr inner_;
+    // Клиент пула, на котором снимаются планы медленных запросов (не транзакция)
+    drogon::orm::DbClientPtr base_;
+    std::shared_ptr<metrics::RequestDbStats> stats_;
+    std::shared_ptr<profiling::Trace> trace_;
+    std::shared_ptr<deadline::Deadline> deadline_;
+    bool replica_;
+};
+
+}
@@ -0,0 +1,162 @@
+#include "PoolLoad.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <drogon/HttpAppFramework.h>
+#include <jsoncpp/json/json.h>
+#include "utils/Deadline.h"
+#include "utils/Metrics.h"
+
+namespace db {
+
+static PoolOptions g_options;
+
+// number_of_connections клиента "default" из db_clients; 0 — клиента в файле нет
+// или конфиг не JSON (config.yaml здесь не разбираем)
+static size_t defaultClientConnections(const std::string &configPath) {
+    if (!configPath.ends_with(".json")) {
+        return 0;
+    }
+    std::ifstream in(configPath);
+    Json::Value root;
+    Json::CharReaderBuilder reader;
+    std::string errors;
+    if (!in || !Json::parseFromStream(reader, in, &root, &errors)) {
+        throw std::runtime_error("db_pool: cannot read " + configPath + ": " + errors);
+    }
+    for (const auto &client : root["db_clients"]) {
+        if (client.get("name", "default").asString() == "default") {
+            // Значение drogon по умолчанию
+            return client.get("number_of_connections", 1).asUInt();
+        }
+    }
+    return 0;
+}
+
+const PoolOptions &loadPoolOptions(const std::string &configPath) {
+    const size_t connections = defaultClientConnections(configPath);
+    if (connections) {
+        g_options.connectionsPerLoop = connections;
+    }
+    const auto &cfg = drogon::app().getCustomConfig()["db_pool"];
+    if (cfg.isObject()) {
+        if (cfg.isMember("connections_per_loop")) {
+            const size_t configured = cfg["connections_per_loop"].asUInt();
+            if (connections && configured != connections) {
+                throw std::runtime_error("custom_config.db_pool.connections_per_loop (" +
+                                         std::to_string(configured) +
+                                         ") differs from number_of_connections of the default db client (" +
+                                         std::to_string(connections) + ")");
+            }
+            g_options.connectionsPerLoop = configured;
+        }
+        g_options.maxWaitMs = cfg.get("max_wait_ms", 1000.0).asDouble();
+    }
+    g_options.connectionsPerLoop = std::max<size_t>(1, g_options.connectionsPerLoop);
+    return g_options;
+}
+
+static metrics::Gauge &inFlightGauge() {
+    static metrics::Gauge g("fm_db_pool_in_flight", "Statements sent to the primary and not yet answered", {});
+    return g;
+}
+
+static metrics::Gauge &queuedGauge() {
+    static metrics::Gauge g("fm_db_pool_queued",
+                            "Statements waiting for a free connection (in flight beyond the pool size)", {});
+    return g;
+}
+
+static metrics::Histogram &waitHistogram() {
+    static metrics::Histogram h("fm_db_pool_wait_seconds",
+                                "Estimated time queued statements waited for a connection",
+                                {},
+                                {0.001, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5});
+    return h;
+}
+
+static metrics::Counter &shedCounter() {
+    static metrics::Counter c("fm_http_shed_total", "Requests rejected with 503 because the DB pool was saturated",
+                              {"route"});
+    return c;
+}
+
+PoolLoad &localPoolLoad() {
+    thread_local PoolLoad load;
+    return load;
+}
+
+static uint32_t queuedOf(uint32_t inFlight) {
+    return inFlight > g_options.connectionsPerLoop ? inFlight - static_cast<uint32_t>(g_options.connectionsPerLoop) : 0;
+}
+
+bool statementStarted(PoolLoad &load) {
+    const uint32_t before = load.inFlight.fetch_add(1, std::memory_order_relaxed);
+    inFlightGauge().add({}, 1);
+    const bool queued = before >= g_options.connectionsPerLoop;
+    if (queued) {
+        queuedGauge().add({}, 1);
+    }
+    return queued;
+}
+
+void statementFinished(PoolLoad &load, bool queued, double seconds) {
+    const uint32_t before = load.inFlight.fetch_sub(1, std::memory_order_relaxed);
+    inFlightGauge().add({}, -1);
+    if (queuedOf(before) > 0) {
+        queuedGauge().add({}, -1);
+    }
+    const double ms = seconds * 1000;
+    const double service = load.serviceMs.load(std::memory_order_relaxed);
+    if (queued) {
+        waitHistogram().observe({}, std::max(0.0, ms - service) / 1000);
+    } else {
+        load.serviceMs.store(service * 0.9 + ms * 0.1, std::memory_order_relaxed);
+    }
+}
+
+double projectedWaitMs() {
+    const auto &load = localPoolLoad();
+    const uint32_t ahead = queuedOf(load.inFlight.load(std::memory_order_relaxed) + 1);
+    if (ahead == 0) {
+        return 0;
+    }
+    const double rounds = std::ceil(static_cast<double>(ahead) / static_cast<double>(g_options.connectionsPerLoop));
+    return rounds * load.serviceMs.load(std::memory_order_relaxed);
+}
+
+bool shedIfOverloaded(const drogon::HttpRequestPtr &req,
+                      const std::function<void(const drogon::HttpResponsePtr &)> &callback) {
+    auto deadline = deadline::requestDeadline(req);
+    if (g_options.maxWaitMs <= 0 && !deadline) {
+        return false;
+    }
+    // Метрики и админка не ходят в базу и нужны как раз при перегрузке
+    const auto &path = req->path();
+    if (path.starts_with("/metrics") || path.starts_with("/admin")) {
+        return false;
+    }
+    double limitMs = g_options.maxWaitMs > 0 ? g_options.maxWaitMs : std::numeric_limits<double>::infinity();
+    // Запрос со сроком (utils/Deadline.h) не ждёт соединения дольше, чем ему осталось
+    if (deadline) {
+        limitMs = std::min(limitMs, deadline->remainingMs());
+    }
+    const double waitMs = projectedWaitMs();
+    if (waitMs <= limitMs) {
+        return false;
+    }
+    std::string route(req->matchedPathPattern());
+    shedCounter().add({route.empty() ? "unmatched" : route});
+
+    auto resp = drogon::HttpResponse::newHttpResponse();
+    resp->setStatusCode(drogon::k503ServiceUnavailable);
+    resp->addHeader("Retry-After", std::to_string(std::max(1, static_cast<int>(std::ceil(waitMs / 1000)))));
+    resp->setBody("Service temporarily overloaded");
+    callback(resp);
+    return true;
+}
+
+}
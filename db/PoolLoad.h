@@ -0,0 +1,58 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <drogon/HttpRequest.h>
+#include <drogon/HttpResponse.h>
+
+// Загрузка пула соединений основной базы. У каждого IO-потока свой быстрый клиент
+// с number_of_connections соединений; запросы сверх этого ждут внутри клиента drogon,
+// и снаружи очередь не видна. Поэтому очередь оценивается по числу запросов в работе:
+// всё, что сверх числа соединений, стоит в очереди, а время ожидания — это очередь,
+// делённая на число соединений, умноженная на среднее время запроса без очереди.
+// По этой оценке запросы отклоняются заранее (503 + Retry-After), а не через timeout клиента.
+namespace db {
+
+struct PoolOptions {
+    // number_of_connections клиента "default" в db_clients
+    size_t connectionsPerLoop = 4;
+    // Если ожидаемое ожидание соединения больше, новый запрос получает 503; 0 — не отклонять.
+    // Для запроса со сроком (utils/Deadline.h) предел — не больше оставшегося времени
+    double maxWaitMs = 1000;
+};
+
+// custom_config.db_pool из config.json; число соединений — из db_clients того же файла
+// (drogon не отдаёт настройки клиентов). Если в db_pool задан и connections_per_loop,
+// он обязан совпадать с number_of_connections — иначе std::runtime_error при запуске.
+// Для config.yaml db_clients не читаются: число соединений берётся из connections_per_loop.
+// Вызывать после loadConfigFile
+const PoolOptions &loadPoolOptions(const std::string &configPath);
+
+// Счётчики пула одного IO-потока. Атомики — колбэк запроса может прийти в другом потоке
+// (например, у db::FakeDbClient)
+struct PoolLoad {
+    std::atomic<uint32_t> inFlight{0};
+    // Среднее (EWMA) время запроса, отправленного при свободном соединении, в мс
+    std::atomic<double> serviceMs{1};
+};
+
+// Счётчики пула текущего IO-потока
+PoolLoad &localPoolLoad();
+
+// Запрос отправлен; true — все соединения были заняты и он встал в очередь
+bool statementStarted(PoolLoad &load);
+
+// Запрос завершён за seconds (вместе с ожиданием в очереди)
+void statementFinished(PoolLoad &load, bool queued, double seconds);
+
+// Ожидаемое время ожидания соединения для нового запроса в текущем потоке, мс
+double projectedWaitMs();
+
+// Pre-handling advice: при перегрузке отвечает 503 с Retry-After, не вызывая обработчик.
+// true — запрос отклонён и ответ уже отправлен в callback
+bool shedIfOverloaded(const drogon::HttpRequestPtr &req,
+                      const std::function<void(const drogon::HttpResponsePtr &)> &callback);
+
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <drogon/orm/DbClient.h>
+#include <drogon/utils/coroutine.h>
+
+// Каталог запросов, которые повторяются в нескольких обработчиках: имя, текст и типы
+// параметров. Имя совпадает с тегом /*имя*/ в тексте, по нему запрос виден в метриках
+// и в логе медленных запросов. Драйвер PostgreSQL в drogon готовит запрос с параметрами
+// при первом выполнении на соединении и дальше выполняет подготовленный оператор,
+// ключ — текст запроса. Поэтому один текст на всё приложение — это один разбор и план
+// на соединение вместо отдельного под каждую копию текста в контроллерах.
+// findVisible — выборка строки сразу с проверкой доступа, без отдельного запроса.
+namespace db {
+
+template <typename... Params>
+struct Statement {
+    std::string_view name;
+    const char *sql;
+};
+
+namespace stmt {
+
+// Семья пользователя; пусто — пользователь не состоит в семье
+inline constexpr Statement<int64_t> familyOfUser{
+    "family_of_user_v1",
+    "/*family_of_user_v1*/ SELECT id_family FROM family_members WHERE id_user = $1::int8 LIMIT 1"};
+
+// Семейные списки: строки всех членов семьи пользователя $1 с is_family. Читают
+// db/ListQueries.cc (кешируемые списки) и обработчики GET /transactions, /transfers, /budgets
+inline constexpr Statement<int64_t> familyAccounts{
+    "list_family_accounts_v1",
+    "/*list_family_accounts_v1*/ "
+    "SELECT a.id, a.id_user, a.account_type, a.account_name, a.balance, a.created_at, a.is_family "
+    "FROM account a JOIN family_members fm ON fm.id_user = a.id_user "
+    "WHERE fm.id_family = (SELECT id_family FROM family_members WHERE id_user = $1::int8) "
+    "AND a.is_family = TRUE ORDER BY a.created_at DESC"};
+
+inline constexpr Statement<int64_t> familyCategories{
+    "list_family_categories_v1",
+    "/*list_family_categories_v1*/ "
+    "SELECT c.id, c.id_user, c.name, c.type, c.is_family "
+    "FROM category c JOIN family_members fm ON fm.id_user = c.id_user "
+    "WHERE fm.id_family = (SELECT id_family FROM family_members WHERE id_user = $1::int8) "
+    "AND c.is_family = TRUE"};
+
+inline constexpr Statement<int64_t> familyTransactions{
+    "list_family_transactions_v1",
+    "/*list_family_transactions_v1*/ "
+    "SELECT t.* FROM transactions t JOIN family_members fm ON fm.id_user = t.id_user "
+    "WHERE fm.id_family = (SELECT id_family FROM family_members WHERE id_user = $1::int8) "
+    "AND t.is_family = TRUE ORDER BY t.created_at DESC"};
+
+inline constexpr Statement<int64_t> familyTransfers{
+    "list_family_transfers_v1",
+    "/*list_family_transfers_v1*/ "
+    "SELECT t.* FROM transfer t JOIN family_members fm ON fm.id_user = t.id_user "
+    "WHERE fm.id_family = (SELECT id_family FROM family_members WHERE id_user = $1::int8) "
+    "AND t.is_family = TRUE ORDER BY t.created_at DESC"};
+
+inline constexpr Statement<int64_t> familyBudgets{
+    "list_family_budgets_v1",
+    "/*list_family_budgets_v1*/ "
+    "SELECT b.id, b.id_user, b.id_category, b.month, b.year, b.limit_amount, b.is_family, b.created_at "
+    "FROM budgets b JOIN family_members fm ON fm.id_user = b.id_user "
+    "WHERE fm.id_family = (SELECT id_family FROM family_members WHERE id_user = $1::int8) "
+    "AND b.is_family = TRUE ORDER BY b.year DESC, b.month DESC"};
+
+// Семейный бюджет на категорию $2 за месяц $3 и год $4 уже есть в семье пользователя $1;
+// $5 — id бюджета, который не считается (правка), 0 — при создании
+inline constexpr Statement<int64_t, int32_t, int32_t, int32_t, int32_t> familyBudgetExists{
+    "family_budget_exists_v1",
+    "/*family_budget_exists_v1*/ "
+    "SELECT 1 FROM budgets b JOIN family_members fm ON fm.id_user = b.id_user "
+    "WHERE fm.id_family = (SELECT id_family FROM family_members WHERE id_user = $1::int8) "
+    "AND b.id_category = $2::int4 AND b.month = $3::int4 AND b.year = $4::int4 "
+    "AND b.is_family = TRUE AND b.id <> $5::int4 LIMIT 1"};
+
+// Строка перевода и строка транзакции под блокировкой до COMMIT: правка или удаление
+// сверяет их с прочитанными до транзакции, прежде чем откатывать их балансы
+inline constexpr Statement<int32_t> lockTransfer{
+    "lock_transfer_v1",
+    "/*lock_transfer_v1*/ SELECT account_from, account_to, amount FROM transfer WHERE id = $1::int4 FOR UPDATE"};
+
+inline constexpr Statement<int32_t> lockTransaction{
+    "lock_transaction_v1",
+    "/*lock_transaction_v1*/ SELECT id_account, amount, type FROM transactions WHERE id = $1::int4 FOR UPDATE"};
+
+// Приращение баланса счёта (db/Balances.h): значение строки, а не прочитанное до транзакции
+inline constexpr Statement<int32_t, std::string> accountAddBalance{
+    "account_add_balance_v1",
+    "/*account_add_balance_v1*/ UPDATE account SET balance = balance + $2::numeric "
+    "WHERE id = $1::int4 RETURNING balance"};
+
+// То же, если баланс не уходит в минус; пусто — средств не хватает
+inline constexpr Statement<int32_t, std::string> accountAddBalanceChecked{
+    "account_add_balance_checked_v1",
+    "/*account_add_balance_checked_v1*/ UPDATE account SET balance = balance + $2::numeric "
+    "WHERE id = $1::int4 AND balance + $2::numeric >= 0 RETURNING balance"};
+
+}
+
+// Выполняет запрос каталога: co_await db::exec(db, db::stmt::familyOfUser, userId).
+// Число аргументов проверяется при компиляции, значения приводятся к типам параметров
+template <typename... Params, typename... Args>
+auto exec(const drogon::orm::DbClientPtr &client, const Statement<Params...> &statement, Args &&...args) {
+    static_assert(sizeof...(Params) == sizeof...(Args), "wrong number of statement parameters");
+    return client->execSqlCoro(statement.sql, static_cast<Params>(args)...);
+}
+
+// То же в виде Task — для coro::when_all (см. coro::query)
+template <typename... Params, typename... Args>
+drogon::Task<drogon::orm::Result> execTask(drogon::orm::DbClientPtr client,
+                                           Statement<Params...> statement,
+                                           Args... args) {
+    static_assert(sizeof...(Params) == sizeof...(Args), "wrong number of statement parameters");
+    co_return co_await client->execSqlCoro(statement.sql, static_cast<Params>(args)...);
+}
+
+// Имя таблицы модели для тега запроса: drogon хранит tableName в кавычках ("\"account\"")
+inline std::string bareTableName(std::string tableName) {
+    std::erase(tableName, '"');
+    return tableName;
+}
+
+// Условие доступа к строке для пользователя $2: личная — только владельцу, семейная
+// (is_family) — членам семьи владельца. Общее для findVisible и выдачи строк в GET /sync
+inline constexpr const char *visibleToUser =
+    "CASE WHEN COALESCE(is_family, FALSE) "
+    "THEN id_user IN (SELECT fm2.id_user FROM family_members fm1 "
+    "JOIN family_members fm2 ON fm1.id_family = fm2.id_family WHERE fm1.id_user = $2::int8) "
+    "ELSE id_user = $2::int8 END";
+
+// Строка модели (account, transactions, transfer, category, budgets) по id, если она
+// доступна пользователю userId: личная — только владельцу, семейная (is_family) — членам
+// семьи владельца. Проверка семьи — подзапрос в том же запросе, а не отдельный запрос
+// после выборки. Пусто — строки нет или она чужая; обработчик отвечает 403.
+// Задача, а не awaiter: можно запускать через coro::when_all
+template <typename Model>
+drogon::Task<std::optional<Model>> findVisible(drogon::orm::DbClientPtr client, int64_t id, int64_t userId) {
+    static const std::string sql =
+        "/*visible_" + bareTableName(Model::tableName) + "_v1*/ SELECT * FROM " + Model::tableName +
+        " WHERE id = $1::int8 AND " + visibleToUser;
+    auto rows = co_await client->execSqlCoro(sql, id, userId);
+    if (rows.empty()) {
+        co_return std::nullopt;
+    }
+    co_return Model(rows[0]);
+}
+
+}
@@ -0,0 +1,56 @@
+#include "Transaction.h"
+#include <stdexcept>
+#include <trantor/utils/Logger.h>
+#include "MeteredDbClient.h"
+
+namespace db {
+
+TxScope::TxScope(const drogon::orm::DbClientPtr &outer, std::shared_ptr<drogon::orm::Transaction> transaction)
+    : transaction_(std::move(transaction)) {
+    if (auto metered = std::dynamic_pointer_cast<MeteredDbClient>(outer)) {
+        client_ = metered->withInner(transaction_);
+    } else {
+        client_ = transaction_;
+    }
+}
+
+TxScope::~TxScope() {
+    if (transaction_) {
+        transaction_->rollback();
+    }
+}
+
+TxScope::CommitAwaiter TxScope::commit() {
+    if (!transaction_) {
+        throw std::logic_error("TxScope: transaction is already committed");
+    }
+    client_.reset();
+    // Кроме TxScope транзакцию держит кто-то ещё (маппер в переменной): COMMIT не уйдёт,
+    // пока он жив. Транзакция остаётся у TxScope и откатывается деструктором
+    if (transaction_.use_count() > 1) {
+        throw std::logic_error("TxScope: transaction is still referenced, COMMIT would not be sent");
+    }
+    return CommitAwaiter(std::move(transaction_));
+}
+
+void TxScope::CommitAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    transaction_->setCommitCallback([this, handle](bool committed) {
+        committed_ = committed;
+        if (!committed) {
+            LOG_ERROR << "Transaction commit failed";
+        }
+        handle.resume();
+    });
+    // Последняя ссылка: drogon отправляет COMMIT и вызывает колбэк с его результатом
+    // (возможно, прямо здесь). После reset() awaiter уже может быть уничтожен
+    auto transaction = std::move(transaction_);
+    transaction.reset();
+}
+
+void TxScope::CommitAwaiter::await_resume() const {
+    if (!committed_) {
+        throw std::runtime_error("Transaction commit failed");
+    }
+}
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <coroutine>
+#include <memory>
+#include <drogon/orm/CoroMapper.h>
+#include <drogon/orm/DbClient.h>
+
+// Транзакция для записи в несколько запросов (RAII): все запросы идут через client()
+// или mapper<Model>(), co_await commit() фиксирует запись. Без commit() — при исключении
+// или раннем co_return с ошибкой — деструктор откатывает транзакцию, и частичная запись
+// не остаётся.
+//
+//     db::TxScope tx(db, co_await db->newTransactionCoro());
+//     co_await tx.mapper<Transfer>().insert(transfer);
+//     ...
+//     co_await tx.commit();
+//
+// COMMIT drogon отправляет, когда отпущена последняя ссылка на транзакцию, поэтому commit()
+// отпускает ссылки TxScope и ждёт результата. Мапперы над client() не сохраняются
+// в переменных: ссылка, оставшаяся у такого маппера, не дала бы COMMIT уйти (commit()
+// в этом случае бросает std::logic_error). Неудачный COMMIT — исключение, обработчик
+// отвечает 500, а не успехом.
+//
+// Чтение и проверки лучше делать до начала транзакции: она держит соединение пула.
+namespace db {
+
+class TxScope {
+public:
+    // outer — клиент, на котором открыта транзакция (db::getDbClient(req)): запросы внутри
+    // транзакции замеряются и проверяют срок запроса так же, как запросы через него
+    TxScope(const drogon::orm::DbClientPtr &outer, std::shared_ptr<drogon::orm::Transaction> transaction);
+    ~TxScope();
+
+    TxScope(const TxScope &) = delete;
+    TxScope &operator=(const TxScope &) = delete;
+
+    // Клиент для запросов внутри транзакции: execSqlCoro, db::exec
+    const drogon::orm::DbClientPtr &client() const {
+        return client_;
+    }
+
+    // Маппер над client() — временный объект на один запрос
+    template <typename Model>
+    drogon::orm::CoroMapper<Model> mapper() const {
+        return drogon::orm::CoroMapper<Model>(client_);
+    }
+
+    class CommitAwaiter {
+    public:
+        explicit CommitAwaiter(std::shared_ptr<drogon::orm::Transaction> transaction)
+            : transaction_(std::move(transaction)) {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+        void await_suspend(std::coroutine_handle<> handle);
+        // Бросает std::runtime_error, если COMMIT не прошёл
+        void await_resume() const;
+
+    private:
+        std::shared_ptr<drogon::orm::Transaction> transaction_;
+        bool committed_ = false;
+    };
+
+    // Фиксирует транзакцию: co_await tx.commit(). После него client() пуст
+    CommitAwaiter commit();
+
+private:
+    std::shared_ptr<drogon::orm::Transaction> transaction_;
+    drogon::orm::DbClientPtr client_;
+};
+
+}
@@ -0,0 +1,65 @@
+-- Журнал изменений для GET /sync.
+-- Строка пишется триггером в той же транзакции, что и сама мутация,
+-- поэтому журнал не может разойтись с данными.
+--
+-- Курсор синхронизации — txid, а не seq: клиенту отдаются только записи
+-- транзакций старше xmin текущего снимка, то есть гарантированно завершённых.
+-- Так запись с меньшим seq, закоммиченная позже, не будет пропущена.
+
+CREATE TABLE IF NOT EXISTS change_log (
+    seq        BIGSERIAL PRIMARY KEY,
+    txid       BIGINT    NOT NULL DEFAULT txid_current(),
+    entity     TEXT      NOT NULL,
+    entity_id  INTEGER   NOT NULL,
+    op         CHAR(1)   NOT NULL CHECK (op IN ('I', 'U', 'D')),
+    id_user    BIGINT    NOT NULL,
+    is_family  BOOLEAN   NOT NULL DEFAULT FALSE,
+    id_family  BIGINT,
+    changed_at TIMESTAMP NOT NULL DEFAULT NOW()
+);
+
+CREATE INDEX IF NOT EXISTS change_log_personal_idx
+    ON change_log (id_user, txid) WHERE is_family = FALSE;
+CREATE INDEX IF NOT EXISTS change_log_family_idx
+    ON change_log (id_family, txid) WHERE is_family = TRUE;
+
+CREATE OR REPLACE FUNCTION change_log_write() RETURNS trigger AS $$
+DECLARE
+    r   RECORD;
+    fam BIGINT;
+BEGIN
+    IF TG_OP = 'DELETE' THEN
+        r := OLD;
+    ELSE
+        r := NEW;
+    END IF;
+
+    IF COALESCE(r.is_family, FALSE) THEN
+        SELECT id_family INTO fam FROM family_members WHERE id_user = r.id_user LIMIT 1;
+    END IF;
+
+    INSERT INTO change_log (entity, entity_id, op, id_user, is_family, id_family)
+    VALUES (TG_TABLE_NAME, r.id, left(TG_OP, 1), r.id_user, COALESCE(r.is_family, FALSE), fam);
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+DROP TRIGGER IF EXISTS account_change_log ON account;
+CREATE TRIGGER account_change_log AFTER INSERT OR UPDATE OR DELETE ON account
+    FOR EACH ROW EXECUTE FUNCTION change_log_write();
+
+DROP TRIGGER IF EXISTS category_change_log ON category;
+CREATE TRIGGER category_change_log AFTER INSERT OR UPDATE OR DELETE ON category
+    FOR EACH ROW EXECUTE FUNCTION change_log_write();
+
+DROP TRIGGER IF EXISTS transactions_change_log ON transactions;
+CREATE TRIGGER transactions_change_log AFTER INSERT OR UPDATE OR DELETE ON transactions
+    FOR EACH ROW EXECUTE FUNCTION change_log_write();
+
+DROP TRIGGER IF EXISTS transfer_change_log ON transfer;
+CREATE TRIGGER transfer_change_log AFTER INSERT OR UPDATE OR DELETE ON transfer
+    FOR EACH ROW EXECUTE FUNCTION change_log_write();
+
+DROP TRIGGER IF EXISTS budgets_change_log ON budgets;
+CREATE TRIGGER budgets_change_log AFTER INSERT OR UPDATE OR DELETE ON budgets
+    FOR EACH ROW EXECUTE FUNCTION change_log_write();
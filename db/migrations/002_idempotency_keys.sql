@@ -0,0 +1,18 @@
+-- Ключи Idempotency-Key для создающих запросов (db/Idempotency.h).
+-- Строка занимается первым запросом с ключом (status IS NULL, expires_at — срок
+-- блокировки), затем в неё записывается ответ и expires_at продлевается на ttl.
+-- Истёкшая строка может быть занята заново; периодически такие строки удаляются.
+
+CREATE TABLE IF NOT EXISTS idempotency_keys (
+    id_user      BIGINT    NOT NULL,
+    idem_key     TEXT      NOT NULL,
+    request_hash TEXT      NOT NULL,
+    status       INTEGER,
+    content_type INTEGER,
+    body         TEXT,
+    expires_at   TIMESTAMP NOT NULL,
+    PRIMARY KEY (id_user, idem_key)
+);
+
+CREATE INDEX IF NOT EXISTS idempotency_keys_expires_idx
+    ON idempotency_keys (expires_at);
@@ -0,0 +1,13 @@
+-- Граница очистки change_log (db/ChangeLog.h): записи с txid меньше pruned_before
+-- удалены. Клиент с курсором GET /sync старше границы получает 410 и загружает
+-- коллекции заново. Одна строка; до первой очистки граница 0.
+
+CREATE TABLE IF NOT EXISTS change_log_horizon (
+    id            BOOLEAN PRIMARY KEY DEFAULT TRUE CHECK (id),
+    pruned_before BIGINT  NOT NULL DEFAULT 0
+);
+
+INSERT INTO change_log_horizon (id, pruned_before) VALUES (TRUE, 0)
+ON CONFLICT (id) DO NOTHING;
+
+CREATE INDEX IF NOT EXISTS change_log_changed_at_idx ON change_log (changed_at);
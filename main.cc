@@ -1,6 +1,21 @@
 #include <drogon/drogon.h>
 #include <filesystem>
 #include <cstdlib>
+#include "utils/JwtUtils.h"
+#include "db/ChangeLog.h"
+#include "db/DataBase.h"
+#include "db/FamilyActors.h"
+#include "db/GroupCommit.h"
+#include "db/Idempotency.h"
+#include "db/ListQueries.h"
+#include "db/MeteredDbClient.h"
+#include "db/PoolLoad.h"
+#include "utils/Prefork.h"
+#include "utils/Metrics.h"
+#include "utils/Profiling.h"
+#include "utils/AsyncLog.h"
+#include "utils/Deadline.h"
+#include "utils/PageShell.h"
 
 int main() {
     // Загружаем конфиг: приоритет у переменной окружения DROGON_CONFIG,
@@ -13,10 +28,136 @@ int main() {
     }
     drogon::app().loadConfigFile(configPath);
 
+    // Число IO-потоков (event loop-ов) можно переопределить без правки конфига:
+    // FM_IO_THREADS=4 ./financial_manager. У каждого потока свой fast DB client
+    // (number_of_connections соединений на поток) и свои шарды кешей.
+    if (const char* envThreads = std::getenv("FM_IO_THREADS")) {
+        int threads = std::atoi(envThreads);
+        if (threads > 0) {
+            drogon::app().setThreadNum(static_cast<size_t>(threads));
+        }
+    }
+
+    // Prefork: FM_WORKERS=N (или custom_config.prefork.workers) запускает N процессов
+    // на одном порту через SO_REUSEPORT. Форк — до app().run(), пока не созданы потоки
+    // и соединения с БД: у каждого процесса будут свои
+    const auto &preforkOptions = prefork::loadOptions();
+    if (preforkOptions.workers > 0) {
+        prefork::runSupervisor();
+        drogon::app().enableReusePort(true);
+    }
+    // Loopback-порт процесса: через него /metrics собирает метрики всех процессов.
+    // В обычном режиме — только если включён custom_config.prefork.local_listener
+    if (prefork::hasLocalListener()) {
+        drogon::app().addListener("127.0.0.1", prefork::localPort());
+    }
+    prefork::enableGracefulDrain();
+
+    // Логи (и строки AccessLogger-а) — через буферы потоков и фоновую запись (utils/AsyncLog.h).
+    // Поток записи запускается после форка: в рабочем процессе
+    asynclog::loadOptions();
+    asynclog::start();
+
+    // Ассеты с хешем в имени (cmake/FingerprintAssets.cmake) кешируются на год как immutable;
+    // остальная статика — с коротким max-age из static_file_headers в config.json
+    drogon::app().registerPreSendingAdvice(
+        [](const drogon::HttpRequestPtr &req, const drogon::HttpResponsePtr &resp) {
+            if (resp->statusCode() == drogon::k200OK && pages::isFingerprintedAsset(req->path())) {
+                resp->addHeader("Cache-Control", "public, max-age=31536000, immutable");
+            }
+        });
+
+    // Чтение с реплики (db/DataBase.h)
+    db::loadReplicaOptions();
+
+    // Успешный изменяющий запрос сбрасывает закешированные списки пользователя
+    // и на время отставания реплики переводит его чтения на основную базу
+    drogon::app().registerPostHandlingAdvice(
+        [](const drogon::HttpRequestPtr &req, const drogon::HttpResponsePtr &resp) {
+            if (req->method() == drogon::Get || req->method() == drogon::Head ||
+                static_cast<int>(resp->statusCode()) >= 400) {
+                return;
+            }
+            if (auto userId = jwt_utils::getUserIdFromRequest(req)) {
+                db::invalidateLists(*userId);
+                db::noteWrite(*userId, resp);
+            }
+        });
+
+    // Сроки запросов (utils/Deadline.h). Срок назначается до проверки загрузки пула:
+    // она учитывает оставшееся время
+    if (deadline::loadOptions().defaultMs > 0 || !deadline::options().routeMs.empty()) {
+        drogon::app().registerPreHandlingAdvice([](const drogon::HttpRequestPtr &req) {
+            deadline::beginRequest(req);
+        });
+        drogon::app().registerPostHandlingAdvice(
+            [](const drogon::HttpRequestPtr &req, const drogon::HttpResponsePtr &resp) {
+                deadline::finishRequest(req, resp);
+            });
+    }
+
+    // Загрузка пула соединений и отказ 503 при перегрузке до вызова обработчика (db/PoolLoad.h)
+    db::loadPoolOptions(configPath);
+    drogon::app().registerPreHandlingAdvice([](const drogon::HttpRequestPtr &req,
+                                               drogon::AdviceCallback &&callback,
+                                               drogon::AdviceChainCallback &&chainCallback) {
+        if (!db::shedIfOverloaded(req, callback)) {
+            chainCallback();
+        }
+    });
+
+    // Пакетная запись новых транзакций по счёту (db/GroupCommit.h)
+    db::loadGroupCommitOptions();
+
+    // Акторы семей для проверок семейных записей (db/FamilyActors.h)
+    db::loadFamilyActorOptions();
+    db::scheduleFamilyActorEviction();
+
+    // Очистка журнала изменений для GET /sync (db/ChangeLog.h)
+    db::loadChangeLogOptions();
+    db::scheduleChangeLogCleanup();
+
+    // Idempotency-Key на создающих маршрутах (db/Idempotency.h). Ключ занимается после
+    // проверки загрузки пула, чтобы отклонённый запрос его не держал
+    if (!db::loadIdempotencyOptions().routes.empty()) {
+        drogon::app().registerPreHandlingAdvice([](const drogon::HttpRequestPtr &req,
+                                                   drogon::AdviceCallback &&callback,
+                                                   drogon::AdviceChainCallback &&chainCallback) {
+            db::beginIdempotent(req, std::move(callback), std::move(chainCallback));
+        });
+        drogon::app().registerPostHandlingAdvice(
+            [](const drogon::HttpRequestPtr &req, const drogon::HttpResponsePtr &resp) {
+                db::finishIdempotent(req, resp);
+            });
+        db::scheduleIdempotencyCleanup();
+    }
+
+    // Время, размер ответа и запросы к БД по маршрутам — на /metrics (utils/Metrics.h)
+    drogon::app().registerPostHandlingAdvice(
+        [](const drogon::HttpRequestPtr &req, const drogon::HttpResponsePtr &resp) {
+            metrics::observeRequest(req, resp);
+        });
+
+    // Лог медленных SQL-запросов и снятие их планов (db/MeteredDbClient.h)
+    db::loadSlowQueryOptions();
+
+    // Профилирование запросов (Server-Timing, лог медленных запросов); выключенное
+    // не регистрирует advice и не заводит Trace
+    if (profiling::loadOptions().enabled) {
+        drogon::app().registerPreHandlingAdvice([](const drogon::HttpRequestPtr &req) {
+            profiling::beginRequest(req);
+        });
+        drogon::app().registerPostHandlingAdvice(
+            [](const drogon::HttpRequestPtr &req, const drogon::HttpResponsePtr &resp) {
+                profiling::finishRequest(req, resp);
+            });
+    }
+
     // Если в конфиге уже есть listeners, эту строку можно не вызывать,
     // но она не мешает и переопределяет адрес/порт при необходимости.
     drogon::app().addListener("0.0.0.0", 9000);
 
     drogon::app().run();
+    asynclog::flush();
     return 0;
 }
@@ -0,0 +1,248 @@
+const token = localStorage.getItem("authToken") || localStorage.getItem("token");
+if (!token) {
+    console.error("Token not found in localStorage");
+    window.location.href = "/auth/login";
+}
+const urlParams = new URLSearchParams(window.location.search);
+const isFamilyView = urlParams.get("family") === "true";
+const accountsUrl = "/accounts" + (isFamilyView ? "?family=true" : "");
+const accountByIdUrl = (id) => "/accounts/" + id + (isFamilyView ? "?family=true" : "");
+console.log("Token found:", token ? "Yes" : "No", "Family view:", isFamilyView);
+
+const accountTypeNames = {
+    cash: "Наличные",
+    card: "Карта",
+    deposit: "Депозит"
+};
+
+function formatDate(dateStr) {
+    if (!dateStr) return "-";
+    try {
+        const date = new Date(dateStr);
+        return date.toLocaleString("ru-RU", {
+            year: "numeric",
+            month: "2-digit",
+            day: "2-digit",
+            hour: "2-digit",
+            minute: "2-digit"
+        });
+    } catch (e) {
+        return dateStr || "-";
+    }
+}
+
+function escapeHtml(text) {
+    const div = document.createElement("div");
+    div.textContent = text;
+    return div.innerHTML;
+}
+
+async function loadAccounts() {
+    const loadingMsg = document.getElementById("loadingMessage");
+    const emptyMsg = document.getElementById("emptyMessage");
+    const table = document.getElementById("accountsTable");
+    const tbody = document.getElementById("accountsTableBody");
+    
+    try {
+        if (!token) {
+            loadingMsg.textContent = "Ошибка: токен авторизации не найден";
+            console.error("Token not found");
+            return;
+        }
+        
+        console.log("Fetching accounts with token:", token ? (token.substring(0, 20) + "...") : "null");
+        const resp = await fetch(accountsUrl, {
+            headers: {
+                "Authorization": "Bearer " + token
+            }
+        });
+        console.log("Response status:", resp.status);
+        if (!resp.ok) {
+            const errorText = await resp.text();
+            loadingMsg.textContent = "Ошибка загрузки счетов: " + (errorText || resp.status);
+            console.error("Failed to load accounts:", resp.status, errorText);
+            return;
+        }
+        let data;
+        try {
+            data = await resp.json();
+        } catch (e) {
+            const text = await resp.text();
+            loadingMsg.textContent = "Ошибка парсинга JSON: " + text;
+            console.error("JSON parse error:", e, text);
+            return;
+        }
+        console.log("Loaded accounts:", JSON.stringify(data));
+        console.log("Accounts count:", data ? data.length : 0);
+        loadingMsg.style.display = "none";
+        
+        if (!data) {
+            loadingMsg.textContent = "Ошибка: данные не получены";
+            console.error("No data received");
+            return;
+        }
+        if (!Array.isArray(data)) {
+            loadingMsg.textContent = "Ошибка: неверный формат данных";
+            console.error("Data is not an array:", typeof data, JSON.stringify(data));
+            return;
+        }
+        console.log("Data is array, length:", data.length);
+        if (data.length === 0) {
+            console.log("No accounts found, showing empty message");
+            emptyMsg.style.display = "block";
+            table.style.display = "none";
+            loadingMsg.style.display = "none";
+        } else {
+            console.log("Found", data.length, "accounts, displaying table");
+            emptyMsg.style.display = "none";
+            table.style.display = "table";
+            tbody.innerHTML = "";
+            data.forEach((acc, index) => {
+                console.log("Processing account", index + 1, ":", JSON.stringify(acc));
+                const row = document.createElement("tr");
+                row.style.borderBottom = "1px solid #eee";
+                const typeName = accountTypeNames[acc.account_type] || acc.account_type;
+                const accessType = acc.is_family ? "Семейный" : "Личный";
+                row.innerHTML = "<td style=\"word-break: break-word; white-space: normal;\">" + escapeHtml(acc.account_name) + "</td>" +
+                    "<td>" + escapeHtml(typeName) + "</td>" +
+                    "<td style=\"font-weight: bold;\">" + escapeHtml(acc.balance) + " руб.</td>" +
+                    "<td>" + accessType + "</td>" +
+                    "<td>" + formatDate(acc.created_at) + "</td>" +
+                    "<td class=\"actions\">" +
+                    "<button onclick=\"editAccount(" + acc.id + ", '" + escapeHtml(acc.account_name) + "', '" + acc.account_type + "', '" + acc.balance + "')\">Редактировать</button>" +
+                    "<button onclick=\"deleteAccount(" + acc.id + ")\">Удалить</button>" +
+                    "</td>";
+                tbody.appendChild(row);
+                console.log("Account row added to table");
+            });
+            console.log("All accounts displayed");
+        }
+    } catch (error) {
+        loadingMsg.textContent = "Ошибка сети: " + error.message;
+        console.error("Error loading accounts:", error);
+    }
+}
+
+function editAccount(id, name, type, balance) {
+    document.getElementById("editAccountId").value = id;
+    document.getElementById("editAccountName").value = name;
+    document.getElementById("editAccountType").value = type;
+    document.getElementById("editAccountBalance").value = balance;
+    document.getElementById("editModal").style.display = "block";
+}
+
+function closeEditModal() {
+    document.getElementById("editModal").style.display = "none";
+}
+
+async function updateAccount() {
+    const id = document.getElementById("editAccountId").value;
+    const name = document.getElementById("editAccountName").value;
+    const type = document.getElementById("editAccountType").value;
+    const balance = document.getElementById("editAccountBalance").value;
+
+    if (!name || !name.trim()) {
+        alert("Название счёта не может быть пустым");
+        return;
+    }
+
+    if (parseFloat(balance) < 0) {
+        alert("Баланс не может быть отрицательным");
+        return;
+    }
+
+    try {
+        const resp = await fetch(accountByIdUrl(id), {
+            method: "PUT",
+            headers: {
+                "Content-Type": "application/json",
+                "Authorization": "Bearer " + token
+            },
+            body: JSON.stringify({
+                account_name: name,
+                account_type: type,
+                balance: balance
+            })
+        });
+        const text = await resp.text();
+        if (resp.ok) {
+            alert("Счёт обновлён");
+            closeEditModal();
+            loadAccounts();
+        } else {
+            alert("Ошибка: " + text);
+        }
+    } catch (error) {
+        alert("Ошибка сети: " + error.message);
+    }
+}
+
+document.getElementById("editAccountForm").addEventListener("submit", async (e) => {
+    e.preventDefault();
+    await updateAccount();
+});
+
+// Закрытие модального окна при клике вне его
+window.onclick = function(event) {
+    const modal = document.getElementById("editModal");
+    if (event.target == modal) {
+        closeEditModal();
+    }
+}
+
+async function deleteAccount(id) {
+    if (!confirm("Вы уверены, что хотите удалить этот счёт?")) {
+        return;
+    }
+    try {
+        const resp = await fetch(accountByIdUrl(id), {
+            method: "DELETE",
+            headers: {
+                "Authorization": "Bearer " + token
+            }
+        });
+        if (resp.ok) {
+            alert("Счёт удалён");
+            loadAccounts();
+        } else {
+            const text = await resp.text();
+            alert("Ошибка: " + text);
+        }
+    } catch (error) {
+        alert("Ошибка сети: " + error.message);
+    }
+}
+
+document.getElementById("accountForm").addEventListener("submit", async (e) => {
+    e.preventDefault();
+    const form = e.target;
+    const body = {
+        account_name: form.account_name.value,
+        account_type: form.account_type.value,
+        balance: form.balance.value || "0"
+    };
+    try {
+        const resp = await fetch(accountsUrl, {
+            method: "POST",
+            headers: {
+                "Content-Type": "application/json",
+                "Authorization": "Bearer " + token
+            },
+            body: JSON.stringify(body)
+        });
+        const text = await resp.text();
+        if (resp.ok) {
+            alert("Счёт создан");
+            form.reset();
+            form.balance.value = "0";
+            loadAccounts();
+        } else {
+            alert("Ошибка: " + text);
+        }
+    } catch (error) {
+        alert("Ошибка сети: " + error.message);
+    }
+});
+
+// Загружаем счета при загрузке страницы
+loadAccounts();
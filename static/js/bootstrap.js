@@ -0,0 +1,44 @@
+// Стартовые данные страницы одним запросом: семья, приглашения, счета и категории.
+// Загрузчики страниц получают из них Response, как от обычного fetch,
+// а после изменений данных снова обращаются к /accounts и /categories.
+// Если сервер уже встроил данные в страницу (#initialData), запрос не нужен.
+function loadBootstrap(token, isFamily) {
+    const embedded = document.getElementById("initialData");
+    if (embedded) {
+        try {
+            return Promise.resolve(JSON.parse(embedded.textContent));
+        } catch (e) {
+            console.error("Bad initial data:", e);
+        }
+    }
+    return fetch("/api/bootstrap" + (isFamily ? "?family=true" : ""), {
+        headers: {
+            "Authorization": "Bearer " + token
+        }
+    })
+        .then(resp => resp.ok ? resp.json() : null)
+        .catch(() => null);
+}
+
+function fetchFromBootstrap(boot, key, url, token) {
+    if (!boot) {
+        return fetch(url, {
+            headers: {
+                "Authorization": "Bearer " + token
+            }
+        });
+    }
+    return boot.then(data => {
+        if (!data || !(key in data)) {
+            return fetch(url, {
+                headers: {
+                    "Authorization": "Bearer " + token
+                }
+            });
+        }
+        return new Response(JSON.stringify(data[key]), {
+            status: 200,
+            headers: { "Content-Type": "application/json" }
+        });
+    });
+}
@@ -0,0 +1,279 @@
+const token = localStorage.getItem("authToken") || localStorage.getItem("token");
+if (!token) {
+    window.location.href = "/auth/login";
+}
+const urlParams = new URLSearchParams(window.location.search);
+const isFamilyView = urlParams.get("family") === "true";
+
+const monthNames = ["Январь", "Февраль", "Март", "Апрель", "Май", "Июнь",
+                   "Июль", "Август", "Сентябрь", "Октябрь", "Ноябрь", "Декабрь"];
+
+let categoriesCache = {};
+let budgetsData = [];
+let editingBudgetId = null;
+const editBudgetModal = document.getElementById("editBudgetModal");
+const editBudgetCategory = document.getElementById("editBudgetCategory");
+const editBudgetMonth = document.getElementById("editBudgetMonth");
+const editBudgetYear = document.getElementById("editBudgetYear");
+const editBudgetLimit = document.getElementById("editBudgetLimit");
+
+async function loadCategoriesForDisplay(boot) {
+    try {
+        const resp = await fetchFromBootstrap(boot, "categories", "/categories" + (isFamilyView ? "?family=true" : ""), token);
+        if (resp.ok) {
+            const categories = await resp.json();
+            categoriesCache = {};
+            categories.forEach(cat => {
+                categoriesCache[cat.id] = cat;
+            });
+        }
+    } catch {}
+}
+
+async function loadBudgets(boot) {
+    const loadingMsg = document.getElementById("loadingMessage");
+    const emptyMsg = document.getElementById("emptyMessage");
+    const table = document.getElementById("budgetsTable");
+    const tbody = document.getElementById("budgetsTableBody");
+    
+    try {
+        const url = "/budgets" + (isFamilyView ? "?family=true" : "");
+        const resp = await fetchFromBootstrap(boot, "budgets", url, token);
+        if (!resp.ok) {
+            loadingMsg.textContent = "Ошибка загрузки бюджетов";
+            return;
+        }
+        const data = await resp.json();
+        budgetsData = data;
+        loadingMsg.style.display = "none";
+        
+        if (!data || data.length === 0) {
+            emptyMsg.style.display = "block";
+            table.style.display = "none";
+        } else {
+            emptyMsg.style.display = "none";
+            table.style.display = "table";
+            tbody.innerHTML = "";
+            data.forEach(budget => {
+                const row = document.createElement("tr");
+                row.style.borderBottom = "1px solid #eee";
+            const category = categoriesCache[budget.id_category];
+            const categoryName = category ? category.name : "Категория недоступна";
+                const monthName = monthNames[budget.month - 1] || budget.month;
+                const accessType = budget.is_family ? "Семейный" : "Личный";
+                row.innerHTML =
+                    "<td style=\"padding: 0.5em; word-break: break-word; white-space: normal;\">" + escapeHtml(categoryName) + "</td>" +
+                    "<td style=\"padding: 0.5em;\">" + monthName + "</td>" +
+                    "<td style=\"padding: 0.5em;\">" + budget.year + "</td>" +
+                    "<td style=\"padding: 0.5em; font-weight: bold;\">" + escapeHtml(budget.limit_amount) + " руб.</td>" +
+                    "<td style=\"padding: 0.5em;\">" + accessType + "</td>" +
+                    "<td style=\"padding: 0.5em; display:flex; gap:6px; flex-wrap:wrap;\">" +
+                        "<button onclick=\"startEditBudget(" + budget.id + ")\" style=\"padding:4px 8px;\">Редактировать</button>" +
+                        "<button onclick=\"deleteBudget(" + budget.id + ")\" style=\"padding:4px 8px; background:#dc3545; color:#fff; border:none;\">Удалить</button>" +
+                    "</td>";
+                tbody.appendChild(row);
+            });
+        }
+    } catch (error) {
+        loadingMsg.textContent = "Ошибка сети: " + error.message;
+        console.error("Error loading budgets:", error);
+    }
+}
+
+function escapeHtml(text) {
+    const div = document.createElement("div");
+    div.textContent = text;
+    return div.innerHTML;
+}
+
+async function loadCategories(boot) {
+    const select = document.getElementById("categorySelect");
+    const errorMsg = document.getElementById("categoriesError");
+    const submitBtn = document.getElementById("submitBtn");
+    
+    try {
+        const resp = await fetchFromBootstrap(boot, "categories", "/categories" + (isFamilyView ? "?family=true" : ""), token);
+        if (!resp.ok) {
+            select.innerHTML = "<option value=\"\">Ошибка загрузки категорий</option>";
+            return;
+        }
+        const categories = await resp.json();
+        select.innerHTML = "";
+        
+        if (!categories || categories.length === 0) {
+            select.innerHTML = "<option value=\"\">Нет доступных категорий</option>";
+            select.disabled = true;
+            errorMsg.style.display = "block";
+            submitBtn.disabled = true;
+        } else {
+            errorMsg.style.display = "none";
+            submitBtn.disabled = false;
+            select.disabled = false;
+            select.innerHTML = "<option value=\"\">Выберите категорию</option>";
+            categories.forEach(cat => {
+                const option = document.createElement("option");
+                option.value = cat.id;
+                const typeText = cat.type === "income" ? "Доход" : "Расход";
+                option.textContent = cat.name + " (" + typeText + ")";
+                select.appendChild(option);
+            });
+        }
+        if (editBudgetCategory) {
+            editBudgetCategory.innerHTML = select.innerHTML;
+        }
+    } catch (error) {
+        select.innerHTML = "<option value=\"\">Ошибка сети</option>";
+        console.error("Error loading categories:", error);
+    }
+}
+
+const form = document.getElementById("createBudgetForm");
+if (form) {
+    form.addEventListener("submit", async (e) => {
+        e.preventDefault();
+        const categoryId = form.id_category.value;
+        if (!categoryId) {
+            alert("Пожалуйста, выберите категорию");
+            return;
+        }
+        const limitValue = parseFloat(form.limit_amount.value);
+        if (isNaN(limitValue) || limitValue < 0) {
+            alert("Пожалуйста, введите корректный лимит (больше или равно 0)");
+            return;
+        }
+        
+        const body = {
+            id_category: Number(categoryId),
+            month: Number(form.month.value),
+            year: Number(form.year.value),
+            limit_amount: limitValue.toString()
+        };
+        try {
+            const url = editingBudgetId
+                ? ("/budgets/" + editingBudgetId + (isFamilyView ? "?family=true" : ""))
+                : ("/budgets" + (isFamilyView ? "?family=true" : ""));
+            const resp = await fetch(url, {
+                method: editingBudgetId ? "PUT" : "POST",
+                headers: {
+                    "Content-Type": "application/json",
+                    "Authorization": "Bearer " + token
+                },
+                body: JSON.stringify(body)
+            });
+            const text = await resp.text();
+            if (resp.ok) {
+                alert(editingBudgetId ? "Бюджет обновлён" : "Бюджет создан");
+                form.reset();
+                form.year.value = new Date().getFullYear();
+                editingBudgetId = null;
+                document.getElementById("submitBtn").textContent = "Создать бюджет";
+                document.getElementById("cancelBudgetEdit").style.display = "none";
+                loadCategories();
+                loadCategoriesForDisplay().then(() => loadBudgets());
+            } else {
+                alert("Ошибка: " + text);
+            }
+        } catch (error) {
+            alert("Ошибка сети: " + error.message);
+        }
+    });
+}
+
+const cancelBtnBudget = document.getElementById("cancelBudgetEdit");
+if (cancelBtnBudget) {
+    cancelBtnBudget.addEventListener("click", cancelBudgetEdit);
+}
+
+function startEditBudget(id) {
+    const budget = budgetsData.find(b => b.id === id);
+    if (!budget) return;
+    editingBudgetId = id;
+    editBudgetCategory.value = budget.id_category;
+    editBudgetMonth.value = budget.month;
+    editBudgetYear.value = budget.year;
+    editBudgetLimit.value = budget.limit_amount;
+    editBudgetModal.style.display = "block";
+}
+
+function cancelBudgetEdit() {
+    editingBudgetId = null;
+    editBudgetModal.style.display = "none";
+}
+
+function closeEditBudgetModal() {
+    editingBudgetId = null;
+    editBudgetModal.style.display = "none";
+}
+
+document.getElementById("editBudgetForm").addEventListener("submit", async (e) => {
+    e.preventDefault();
+    if (!editingBudgetId) {
+        closeEditBudgetModal();
+        return;
+    }
+    const categoryId = editBudgetCategory.value;
+    if (!categoryId) {
+        alert("Пожалуйста, выберите категорию");
+        return;
+    }
+    const limitValue = parseFloat(editBudgetLimit.value);
+    if (isNaN(limitValue) || limitValue < 0) {
+        alert("Пожалуйста, введите корректный лимит (больше или равно 0)");
+        return;
+    }
+    const body = {
+        id_category: Number(categoryId),
+        month: Number(editBudgetMonth.value),
+        year: Number(editBudgetYear.value),
+        limit_amount: limitValue.toString()
+    };
+    try {
+        const url = "/budgets/" + editingBudgetId + (isFamilyView ? "?family=true" : "");
+        const resp = await fetch(url, {
+            method: "PUT",
+            headers: {
+                "Content-Type": "application/json",
+                "Authorization": "Bearer " + token
+            },
+            body: JSON.stringify(body)
+        });
+        const text = await resp.text();
+        if (resp.ok) {
+            alert("Бюджет обновлён");
+            closeEditBudgetModal();
+            loadCategoriesForDisplay().then(() => loadBudgets());
+        } else {
+            alert("Ошибка: " + text);
+        }
+    } catch (error) {
+        alert("Ошибка сети: " + error.message);
+    }
+});
+
+async function deleteBudget(id) {
+    if (!confirm("Удалить бюджет?")) return;
+    try {
+        const resp = await fetch("/budgets/" + id + (isFamilyView ? "?family=true" : ""), {
+            method: "DELETE",
+            headers: {
+                "Authorization": "Bearer " + token
+            }
+        });
+        if (resp.status === 204) {
+            if (editingBudgetId === id) {
+                cancelBudgetEdit();
+            }
+            loadBudgets();
+        } else {
+            const text = await resp.text();
+            alert("Ошибка удаления: " + text);
+        }
+    } catch (error) {
+        alert("Ошибка сети: " + error.message);
+    }
+}
+
+// Загружаем категории и бюджеты при загрузке страницы
+const boot = loadBootstrap(token, isFamilyView);
+loadCategories(boot);
+loadCategoriesForDisplay(boot).then(() => loadBudgets(boot));
@@ -0,0 +1,187 @@
+const token = localStorage.getItem("authToken") || localStorage.getItem("token");
+if (!token) {
+    window.location.href = "/auth/login";
+}
+const urlParams = new URLSearchParams(window.location.search);
+const isFamily = urlParams.get("family") === "true";
+
+const categoriesUrl = "/categories" + (isFamily ? "?family=true" : "");
+
+let editingCategoryId = null;
+let categoriesData = [];
+const editCategoryModal = document.getElementById("editCategoryModal");
+const editCategoryName = document.getElementById("editCategoryName");
+const editCategoryType = document.getElementById("editCategoryType");
+
+async function loadCategories(boot) {
+    const loadingMsg = document.getElementById("loadingMessage");
+    const emptyMsg = document.getElementById("emptyMessage");
+    const table = document.getElementById("categoriesTable");
+    const tbody = document.getElementById("categoriesTableBody");
+    
+    try {
+        const resp = await fetchFromBootstrap(boot, "categories", categoriesUrl, token);
+        if (!resp.ok) {
+            loadingMsg.textContent = "Ошибка загрузки категорий";
+            return;
+        }
+        const data = await resp.json();
+        categoriesData = data;
+        loadingMsg.style.display = "none";
+        
+        if (!data || data.length === 0) {
+            emptyMsg.style.display = "block";
+            table.style.display = "none";
+        } else {
+            emptyMsg.style.display = "none";
+            table.style.display = "table";
+            tbody.innerHTML = "";
+            data.forEach(cat => {
+                const row = document.createElement("tr");
+                row.style.borderBottom = "1px solid #eee";
+                const typeText = cat.type === "income" ? "Доход" : "Расход";
+                const typeColor = cat.type === "income" ? "#28a745" : "#dc3545";
+                const accessType = cat.is_family ? "Семейная" : "Личная";
+                row.innerHTML = "<td style=\"padding: 0.5em; word-break: break-word; white-space: normal;\">" + escapeHtml(cat.name) + "</td>" +
+                    "<td style=\"padding: 0.5em; color: " + typeColor + "; font-weight: bold;\">" + typeText + "</td>" +
+                    "<td style=\"padding: 0.5em;\">" + accessType + "</td>" +
+                    "<td style=\"padding: 0.5em; display: flex; gap: 6px; flex-wrap: wrap;\">" +
+                        "<button onclick=\"startEditCategory(" + cat.id + ")\" style=\"padding: 4px 8px;\">Редактировать</button>" +
+                        "<button onclick=\"deleteCategory(" + cat.id + ")\" style=\"padding: 4px 8px; background:#dc3545; color:#fff; border:none;\">Удалить</button>" +
+                    "</td>";
+                tbody.appendChild(row);
+            });
+        }
+    } catch (error) {
+        loadingMsg.textContent = "Ошибка сети: " + error.message;
+        console.error("Error loading categories:", error);
+    }
+}
+
+function escapeHtml(text) {
+    const div = document.createElement("div");
+    div.textContent = text;
+    return div.innerHTML;
+}
+
+const form = document.getElementById("createCategoryForm");
+if (form) {
+    form.addEventListener("submit", async (e) => {
+        e.preventDefault();
+        const body = {
+            name: form.name.value,
+            type: form.type.value
+        };
+        try {
+            const url = editingCategoryId ? ("/categories/" + editingCategoryId + (isFamily ? "?family=true" : "")) : categoriesUrl;
+            const method = editingCategoryId ? "PUT" : "POST";
+            const resp = await fetch(url, {
+                method,
+                headers: {
+                    "Content-Type": "application/json",
+                    "Authorization": "Bearer " + token
+                },
+                body: JSON.stringify(body)
+            });
+            const text = await resp.text();
+            if (resp.ok) {
+                alert(editingCategoryId ? "Категория обновлена" : "Категория создана");
+                form.reset();
+                editingCategoryId = null;
+                form.querySelector("button[type='submit']").textContent = "Создать";
+                const cancelBtn = document.getElementById("cancelCategoryEdit");
+                if (cancelBtn) cancelBtn.style.display = "none";
+                loadCategories();
+            } else {
+                alert("Ошибка: " + text);
+            }
+        } catch (error) {
+            alert("Ошибка сети: " + error.message);
+        }
+    });
+}
+const cancelBtnCat = document.getElementById("cancelCategoryEdit");
+if (cancelBtnCat) {
+    cancelBtnCat.addEventListener("click", cancelCategoryEdit);
+}
+
+function startEditCategory(id) {
+    const cat = categoriesData.find(c => c.id === id);
+    if (!cat) return;
+    editingCategoryId = id;
+    editCategoryName.value = cat.name;
+    editCategoryType.value = cat.type;
+    editCategoryModal.style.display = "block";
+}
+
+function cancelCategoryEdit() {
+    const form = document.getElementById("createCategoryForm");
+    form.reset();
+    editingCategoryId = null;
+    form.querySelector("button[type='submit']").textContent = "Создать";
+    document.getElementById("cancelCategoryEdit").style.display = "none";
+    closeEditCategoryModal();
+}
+
+function closeEditCategoryModal() {
+    editCategoryModal.style.display = "none";
+    editingCategoryId = null;
+}
+
+document.getElementById("editCategoryForm").addEventListener("submit", async (e) => {
+    e.preventDefault();
+    if (!editingCategoryId) {
+        closeEditCategoryModal();
+        return;
+    }
+    try {
+        const resp = await fetch("/categories/" + editingCategoryId + (isFamily ? "?family=true" : ""), {
+            method: "PUT",
+            headers: {
+                "Content-Type": "application/json",
+                "Authorization": "Bearer " + token
+            },
+            body: JSON.stringify({
+                name: editCategoryName.value,
+                type: editCategoryType.value
+            })
+        });
+        const text = await resp.text();
+        if (resp.ok) {
+            alert("Категория обновлена");
+            closeEditCategoryModal();
+            loadCategories();
+        } else {
+            alert("Ошибка: " + text);
+        }
+    } catch (error) {
+        alert("Ошибка сети: " + error.message);
+    }
+});
+
+async function deleteCategory(id) {
+    if (!confirm("Удалить категорию?")) return;
+    try {
+        const resp = await fetch("/categories/" + id + (isFamily ? "?family=true" : ""), {
+            method: "DELETE",
+            headers: {
+                "Authorization": "Bearer " + token
+            }
+        });
+        if (resp.status === 204) {
+            if (editingCategoryId === id) {
+                cancelCategoryEdit();
+            }
+            loadCategories();
+        } else {
+            const text = await resp.text();
+            alert("Ошибка удаления: " + text);
+        }
+    } catch (error) {
+        alert("Ошибка сети: " + error.message);
+    }
+}
+
+// Загружаем категории при загрузке страницы
+const boot = loadBootstrap(token, isFamily);
+loadCategories(boot);
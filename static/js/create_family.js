@@ -0,0 +1,33 @@
+document.getElementById("createFamilyForm").addEventListener("submit", async function(e) {
+    e.preventDefault();
+    
+    const name = document.getElementById("name").value;
+    const token = localStorage.getItem("authToken") || localStorage.getItem("token") || getCookie("token");
+    
+    try {
+        const response = await fetch("/api/family", {
+            method: "POST",
+            headers: {
+                "Content-Type": "application/json",
+                "Authorization": "Bearer " + token
+            },
+            body: JSON.stringify({ name: name })
+        });
+        
+        if (response.ok) {
+            alert("Семья успешно создана!");
+            window.location.href = "/home";
+        } else {
+            const error = await response.text();
+            alert("Ошибка: " + error);
+        }
+    } catch (error) {
+        alert("Ошибка при создании семьи: " + error.message);
+    }
+});
+
+function getCookie(name) {
+    const value = "; " + document.cookie;
+    const parts = value.split("; " + name + "=");
+    if (parts.length === 2) return parts.pop().split(";").shift();
+}
@@ -0,0 +1,61 @@
+async function loadMembers() {
+    const token = localStorage.getItem("authToken") || localStorage.getItem("token") || getCookie("token");
+    const familyId = document.getElementById("membersContainer").dataset.familyId;
+    
+    try {
+        const response = await fetch("/api/family/" + familyId + "/members", {
+            headers: {
+                "Authorization": "Bearer " + token
+            }
+        });
+        
+        if (response.ok) {
+            const members = await response.json();
+            displayMembers(members);
+        } else {
+            document.getElementById("membersContainer").innerHTML = 
+                "<div class=\"error\">Ошибка при загрузке списка членов</div>";
+        }
+    } catch (error) {
+        document.getElementById("membersContainer").innerHTML = 
+            "<div class=\"error\">Ошибка: " + error.message + "</div>";
+    }
+}
+
+function displayMembers(members) {
+    const container = document.getElementById("membersContainer");
+    
+    if (members.length === 0) {
+        container.innerHTML = "<p>В семье пока нет других членов.</p>";
+        return;
+    }
+    
+    let html = "<div class=\"member-list\">";
+    members.forEach(member => {
+        html += "<div class=\"member-item\">";
+        html += "<strong>" + escapeHtml(member.name) + "</strong>";
+        if (member.is_owner) {
+            html += "<span class=\"owner-badge\">Владелец</span>";
+        }
+        html += "<p>Email: " + escapeHtml(member.email) + "</p>";
+        html += "<p>Присоединился: " + new Date(member.joined_at).toLocaleDateString("ru-RU") + "</p>";
+        html += "</div>";
+    });
+    html += "</div>";
+    
+    container.innerHTML = html;
+}
+
+function escapeHtml(text) {
+    const div = document.createElement("div");
+    div.textContent = text;
+    return div.innerHTML;
+}
+
+function getCookie(name) {
+    const value = "; " + document.cookie;
+    const parts = value.split("; " + name + "=");
+    if (parts.length === 2) return parts.pop().split(";").shift();
+}
+
+loadMembers();
@@ -0,0 +1,106 @@
+const token = localStorage.getItem("authToken") || localStorage.getItem("token");
+if (!token) {
+    document.getElementById("loadingMessage").textContent = "Вы не авторизованы. Пожалуйста, войдите в систему.";
+    setTimeout(() => {
+        window.location.href = "/auth/login";
+    }, 2000);
+} else {
+    loadHomeContent();
+}
+
+async function loadHomeContent() {
+    try {
+        // Семья и приглашения приходят одним запросом
+        const bootResp = await fetch("/api/bootstrap", {
+            headers: {
+                "Authorization": "Bearer " + token
+            }
+        });
+        const boot = bootResp.ok ? await bootResp.json() : null;
+        
+        let html = "";
+        
+        // Обрабатываем приглашения
+        if (boot) {
+            const invites = boot.invites;
+            if (invites && invites.length > 0) {
+                html += "<div class=\"invite-notification\">";
+                html += "<strong>У вас есть " + invites.length + " приглашение(й) в семью!</strong>";
+                html += "<p>";
+                invites.forEach(invite => {
+                    if (invite.token) {
+                        html += "<a href=\"/join-family?token=" + invite.token + "\" style=\"display: inline-block; margin: 5px; padding: 12px 24px; background-color: #4CAF50; color: white; text-decoration: none; border-radius: 5px; font-weight: bold; font-size: 16px;\">✅ Принять приглашение в " + (invite.family_name || "Семья") + "</a>";
+                    }
+                });
+                html += "</p>";
+                html += "</div>";
+            }
+        }
+        
+        // Обрабатываем информацию о семье
+        if (boot) {
+            const family = boot.family;
+            if (family && family.id) {
+                html += "<div class=\"family-info\">";
+                html += "<strong>Семья: " + family.name + "</strong>";
+                html += "<p>";
+                html += "<a href=\"/family/members\" style=\"margin-right: 15px;\">Просмотреть членов семьи</a>";
+                html += "<a href=\"/family/invite\" style=\"background-color: #2196f3; color: white; padding: 12px 24px; text-decoration: none; border-radius: 5px; display: inline-block; font-weight: bold; font-size: 16px;\">➕ Пригласить в семью</a>";
+                html += "</p>";
+                html += "</div>";
+                
+                html += "<div class=\"section-title\">Личные финансы:</div>";
+                html += "<nav><ul>";
+                html += "<li><a href=\"/accounts/create\">Счета</a></li>";
+                html += "<li><a href=\"/ui/categories\">Категории</a></li>";
+                html += "<li><a href=\"/ui/transactions\">Транзакции</a></li>";
+                html += "<li><a href=\"/ui/budgets\">Бюджеты</a></li>";
+                html += "<li><a href=\"/ui/transfers\">Переводы</a></li>";
+                html += "</ul></nav>";
+                
+                html += "<div class=\"section-title\">Семейные финансы:</div>";
+                html += "<nav><ul>";
+                html += "<li><a href=\"/accounts/create?family=true\">Семейные счета</a></li>";
+                html += "<li><a href=\"/ui/categories?family=true\">Семейные категории</a></li>";
+                html += "<li><a href=\"/ui/transactions?family=true\">Семейные транзакции</a></li>";
+                html += "<li><a href=\"/ui/budgets?family=true\">Семейные бюджеты</a></li>";
+                html += "<li><a href=\"/ui/transfers?family=true\">Семейные переводы</a></li>";
+                html += "</ul></nav>";
+            } else {
+                html += "<div style=\"margin: 20px 0;\">";
+                html += "<a href=\"/family/create\" style=\"background-color: #4CAF50; color: white; padding: 10px 20px; text-decoration: none; border-radius: 5px; display: inline-block;\">";
+                html += "Создать семейный аккаунт</a>";
+                html += "</div>";
+                
+                html += "<div class=\"section-title\">Личные финансы:</div>";
+                html += "<nav><ul>";
+                html += "<li><a href=\"/accounts/create\">Счета</a></li>";
+                html += "<li><a href=\"/ui/categories\">Категории</a></li>";
+                html += "<li><a href=\"/ui/transactions\">Транзакции</a></li>";
+                html += "<li><a href=\"/ui/budgets\">Бюджеты</a></li>";
+                html += "<li><a href=\"/ui/transfers\">Переводы</a></li>";
+                html += "</ul></nav>";
+            }
+        } else {
+            html += "<div style=\"margin: 20px 0;\">";
+            html += "<a href=\"/family/create\" style=\"background-color: #4CAF50; color: white; padding: 10px 20px; text-decoration: none; border-radius: 5px; display: inline-block;\">";
+            html += "Создать семейный аккаунт</a>";
+            html += "</div>";
+            
+            html += "<div class=\"section-title\">Личные финансы:</div>";
+            html += "<nav><ul>";
+            html += "<li><a href=\"/accounts/create\">Счета</a></li>";
+            html += "<li><a href=\"/ui/categories\">Категории</a></li>";
+            html += "<li><a href=\"/ui/transactions\">Транзакции</a></li>";
+            html += "<li><a href=\"/ui/budgets\">Бюджеты</a></li>";
+            html += "<li><a href=\"/ui/transfers\">Переводы</a></li>";
+            html += "</ul></nav>";
+        }
+        
+        document.getElementById("loadingMessage").style.display = "none";
+        document.getElementById("contentArea").innerHTML = html;
+    } catch (error) {
+        document.getElementById("loadingMessage").textContent = "Ошибка загрузки данных: " + error.message;
+        console.error("Error loading home content:", error);
+    }
+}
@@ -0,0 +1,79 @@
+const token = localStorage.getItem("authToken") || localStorage.getItem("token");
+if (!token) {
+    document.getElementById("loadingMessage").style.display = "none";
+    document.getElementById("errorMessage").textContent = "Вы не авторизованы. Пожалуйста, войдите в систему.";
+    document.getElementById("errorMessage").style.display = "block";
+    setTimeout(() => {
+        window.location.href = "/auth/login";
+    }, 2000);
+} else {
+    loadFamilyInfo();
+}
+
+async function loadFamilyInfo() {
+    try {
+        const response = await fetch("/api/family", {
+            headers: {
+                "Authorization": "Bearer " + token
+            }
+        });
+        
+        if (!response.ok) {
+            if (response.status === 401) {
+                document.getElementById("loadingMessage").style.display = "none";
+                document.getElementById("errorMessage").textContent = "Ошибка авторизации. Пожалуйста, войдите в систему.";
+                document.getElementById("errorMessage").style.display = "block";
+                setTimeout(() => {
+                    window.location.href = "/auth/login";
+                }, 2000);
+                return;
+            }
+            const error = await response.text();
+            throw new Error(error);
+        }
+        
+        const family = await response.json();
+        if (!family || !family.id) {
+            document.getElementById("loadingMessage").style.display = "none";
+            document.getElementById("errorMessage").textContent = "Вы не состоите в семье";
+            document.getElementById("errorMessage").style.display = "block";
+            return;
+        }
+        
+        document.getElementById("loadingMessage").style.display = "none";
+        document.getElementById("inviteFormContainer").style.display = "block";
+        document.querySelector("h1").textContent = "Пригласить в семью: " + family.name;
+        
+        document.getElementById("inviteForm").addEventListener("submit", async function(e) {
+            e.preventDefault();
+            
+            const email = document.getElementById("email").value;
+            
+            try {
+                const inviteResponse = await fetch("/api/family/" + family.id + "/invite", {
+                    method: "POST",
+                    headers: {
+                        "Content-Type": "application/json",
+                        "Authorization": "Bearer " + token
+                    },
+                    body: JSON.stringify({ email: email })
+                });
+                
+                if (inviteResponse.ok) {
+                    const result = await inviteResponse.json();
+                    alert("Приглашение успешно отправлено на " + email + "!\\nСсылка: " + result.join_url);
+                    document.getElementById("email").value = "";
+                } else {
+                    const error = await inviteResponse.text();
+                    alert("Ошибка: " + error);
+                }
+            } catch (error) {
+                alert("Ошибка при отправке приглашения: " + error.message);
+            }
+        });
+    } catch (error) {
+        document.getElementById("loadingMessage").style.display = "none";
+        document.getElementById("errorMessage").textContent = "Ошибка: " + error.message;
+        document.getElementById("errorMessage").style.display = "block";
+    }
+}
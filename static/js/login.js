@@ -0,0 +1,30 @@
+document.getElementById('loginForm').addEventListener('submit', async (e) => {
+    e.preventDefault();
+    const form = e.target;
+    const body = {
+        email: form.email.value,
+        password: form.password.value
+    };
+    try {
+        const resp = await fetch('/api/auth/login', {
+            method: 'POST',
+            headers: { 'Content-Type': 'application/json' },
+            body: JSON.stringify(body)
+        });
+        if (resp.ok) {
+            const data = await resp.json();
+            if (data.token) {
+                localStorage.setItem('authToken', data.token);
+            }
+            document.getElementById('message').textContent = 'Вход выполнен, переходим к выбору действия...';
+            setTimeout(() => {
+                window.location.href = '/home';
+            }, 800);
+        } else {
+            const text = await resp.text();
+            document.getElementById('message').textContent = 'Ошибка: ' + text;
+        }
+    } catch (e) {
+        document.getElementById('message').textContent = 'Ошибка сети';
+    }
+});
@@ -0,0 +1,10 @@
+(function () {
+    try {
+        localStorage.removeItem('authToken');
+    } catch (e) {
+        // ignore
+    }
+    setTimeout(function () {
+        window.location.href = '/';
+    }, 500);
+})();
@@ -0,0 +1,27 @@
+document.getElementById('registerForm').addEventListener('submit', async (e) => {
+    e.preventDefault();
+    const form = e.target;
+    const body = {
+        name: form.name.value,
+        email: form.email.value,
+        password: form.password.value
+    };
+    try {
+        const resp = await fetch('/api/auth/register', {
+            method: 'POST',
+            headers: { 'Content-Type': 'application/json' },
+            body: JSON.stringify(body)
+        });
+        if (resp.ok) {
+            document.getElementById('message').textContent = 'Регистрация успешна, перенаправление на страницу входа...';
+            setTimeout(() => {
+                window.location.href = '/auth/login';
+            }, 800);
+        } else {
+            const text = await resp.text();
+            document.getElementById('message').textContent = 'Ошибка: ' + text;
+        }
+    } catch (e) {
+        document.getElementById('message').textContent = 'Ошибка сети';
+    }
+});
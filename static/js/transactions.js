@@ -0,0 +1,349 @@
+const token = localStorage.getItem("authToken") || localStorage.getItem("token");
+if (!token) {
+    window.location.href = "/auth/login";
+}
+const urlParams = new URLSearchParams(window.location.search);
+const isFamilyView = urlParams.get("family") === "true";
+
+function formatDate(dateStr) {
+    if (!dateStr) return "-";
+    try {
+        const date = new Date(dateStr);
+        return date.toLocaleString("ru-RU", {
+            year: "numeric",
+            month: "2-digit",
+            day: "2-digit",
+            hour: "2-digit",
+            minute: "2-digit"
+        });
+    } catch (e) {
+        return dateStr || "-";
+    }
+}
+
+let accountsCache = {};
+let categoriesCacheTx = {};
+let editingTransactionId = null;
+let transactionsData = [];
+const editTxModal = document.getElementById("editTransactionModal");
+const editTxAccount = document.getElementById("editTxAccount");
+const editTxCategory = document.getElementById("editTxCategory");
+const editTxAmount = document.getElementById("editTxAmount");
+const editTxType = document.getElementById("editTxType");
+const editTxDescription = document.getElementById("editTxDescription");
+
+async function loadAccountsForDisplay(boot) {
+    try {
+        const resp = await fetchFromBootstrap(boot, "accounts", "/accounts" + (isFamilyView ? "?family=true" : ""), token);
+        if (resp.ok) {
+            const accounts = await resp.json();
+            accountsCache = {};
+            accounts.forEach(acc => {
+                accountsCache[acc.id] = acc;
+            });
+            fillTxAccountSelects(accounts);
+        }
+    } catch {}
+}
+
+function fillTxAccountSelects(accounts) {
+    const options = ['<option value="">Выберите счёт</option>'].concat(
+        accounts.map(acc => `<option value="${acc.id}">${escapeHtml(acc.account_name)} (${acc.account_type}) - Баланс: ${acc.balance} руб.</option>`)
+    ).join("");
+    if (editTxAccount) {
+        editTxAccount.innerHTML = options;
+    }
+}
+
+async function loadTransactions(boot) {
+    const loadingMsg = document.getElementById("loadingMessage");
+    const emptyMsg = document.getElementById("emptyMessage");
+    const table = document.getElementById("transactionsTable");
+    const tbody = document.getElementById("transactionsTableBody");
+    
+    try {
+        const url = "/transactions" + (isFamilyView ? "?family=true" : "");
+        const resp = await fetchFromBootstrap(boot, "transactions", url, token);
+        if (!resp.ok) {
+            loadingMsg.textContent = "Ошибка загрузки транзакций";
+            return;
+        }
+        const data = await resp.json();
+        transactionsData = data;
+        loadingMsg.style.display = "none";
+        
+        if (!data || data.length === 0) {
+            emptyMsg.style.display = "block";
+            table.style.display = "none";
+        } else {
+            emptyMsg.style.display = "none";
+            table.style.display = "table";
+            tbody.innerHTML = "";
+            data.forEach(tr => {
+                const row = document.createElement("tr");
+                row.style.borderBottom = "1px solid #eee";
+                const typeText = tr.type === "income" ? "Доход" : "Расход";
+                const typeColor = tr.type === "income" ? "#28a745" : "#dc3545";
+                const amountColor = tr.type === "income" ? "#28a745" : "#dc3545";
+                const account = accountsCache[tr.id_account];
+                const accountName = account ? account.account_name : "Счёт недоступен";
+                const category = tr.id_category ? categoriesCacheTx[tr.id_category] : null;
+                const categoryName = category ? category.name : "-";
+                const amountSign = tr.type === "income" ? "+" : "-";
+                const accessType = tr.is_family ? "Семейная" : "Личная";
+                row.innerHTML =
+                    "<td style=\"padding: 0.5em; word-break: break-word; white-space: normal;\">" + escapeHtml(accountName) + "</td>" +
+                    "<td style=\"padding: 0.5em; color: " + amountColor + "; font-weight: bold;\">" + amountSign + escapeHtml(tr.amount) + " руб.</td>" +
+                    "<td style=\"padding: 0.5em; color: " + typeColor + "; font-weight: bold;\">" + typeText + "</td>" +
+                    "<td style=\"padding: 0.5em; word-break: break-word; white-space: normal;\">" + escapeHtml(categoryName) + "</td>" +
+                    "<td style=\"padding: 0.5em; word-break: break-word; white-space: normal;\">" + escapeHtml(tr.description || "-") + "</td>" +
+                    "<td style=\"padding: 0.5em;\">" + formatDate(tr.created_at) + "</td>" +
+                    "<td style=\"padding: 0.5em;\">" + accessType + "</td>" +
+                    "<td style=\"padding: 0.5em; display:flex; gap:6px; flex-wrap:wrap;\">" +
+                        "<button onclick=\"startEditTransaction(" + tr.id + ")\" style=\"padding:4px 8px;\">Редактировать</button>" +
+                        "<button onclick=\"deleteTransaction(" + tr.id + ")\" style=\"padding:4px 8px; background:#dc3545; color:#fff; border:none;\">Удалить</button>" +
+                    "</td>";
+                tbody.appendChild(row);
+            });
+        }
+    } catch (error) {
+        loadingMsg.textContent = "Ошибка сети: " + error.message;
+        console.error("Error loading transactions:", error);
+    }
+}
+
+function escapeHtml(text) {
+    const div = document.createElement("div");
+    div.textContent = text;
+    return div.innerHTML;
+}
+
+async function loadAccounts(boot) {
+    const select = document.getElementById("accountSelect");
+    const errorMsg = document.getElementById("accountsError");
+    const submitBtn = document.getElementById("submitBtn");
+    
+    try {
+        const resp = await fetchFromBootstrap(boot, "accounts", "/accounts" + (isFamilyView ? "?family=true" : ""), token);
+        if (!resp.ok) {
+            select.innerHTML = "<option value=\"\">Ошибка загрузки счетов</option>";
+            return;
+        }
+        const accounts = await resp.json();
+        select.innerHTML = "";
+        
+        if (!accounts || accounts.length === 0) {
+            select.innerHTML = "<option value=\"\">Нет доступных счетов</option>";
+            select.disabled = true;
+            errorMsg.style.display = "block";
+            submitBtn.disabled = true;
+        } else {
+            errorMsg.style.display = "none";
+            submitBtn.disabled = false;
+            select.disabled = false;
+            select.innerHTML = "<option value=\"\">Выберите счёт</option>";
+            accounts.forEach(acc => {
+                const option = document.createElement("option");
+                option.value = acc.id;
+                option.textContent = acc.account_name + " (" + acc.account_type + ") - Баланс: " + acc.balance + " руб.";
+                select.appendChild(option);
+            });
+        }
+    } catch (error) {
+        select.innerHTML = "<option value=\"\">Ошибка сети</option>";
+        console.error("Error loading accounts:", error);
+    }
+}
+
+async function loadCategories(boot) {
+    const select = document.getElementById("categorySelect");
+    
+    try {
+        const resp = await fetchFromBootstrap(boot, "categories", "/categories" + (isFamilyView ? "?family=true" : ""), token);
+        if (!resp.ok) {
+            select.innerHTML = "<option value=\"\">Ошибка загрузки категорий</option>";
+            return;
+        }
+        const categories = await resp.json();
+        categoriesCacheTx = {};
+        categories.forEach(cat => { categoriesCacheTx[cat.id] = cat; });
+        select.innerHTML = "<option value=\"\">Не выбрано</option>";
+        
+        if (categories && categories.length > 0) {
+            categories.forEach(cat => {
+                const option = document.createElement("option");
+                option.value = cat.id;
+                const typeText = cat.type === "income" ? "Доход" : "Расход";
+                option.textContent = cat.name + " (" + typeText + ")";
+                select.appendChild(option);
+            });
+        }
+        // дублируем опции в модалку
+        if (editTxCategory) {
+            editTxCategory.innerHTML = select.innerHTML;
+        }
+    } catch (error) {
+        select.innerHTML = "<option value=\"\">Ошибка сети</option>";
+        console.error("Error loading categories:", error);
+    }
+}
+
+const form = document.getElementById("createTransactionForm");
+if (form) {
+    form.addEventListener("submit", async (e) => {
+        e.preventDefault();
+        const accountId = form.id_account.value;
+        if (!accountId) {
+            alert("Пожалуйста, выберите счёт");
+            return;
+        }
+        const amountValue = parseFloat(form.amount.value);
+        if (isNaN(amountValue) || amountValue <= 0) {
+            alert("Пожалуйста, введите корректную сумму (больше 0)");
+            return;
+        }
+        
+        const body = {
+            id_account: Number(accountId),
+            amount: amountValue.toString(),
+            type: form.type.value,
+            description: form.description.value || ""
+        };
+        if (form.id_category.value) {
+            body.id_category = Number(form.id_category.value);
+        }
+        try {
+            const url = editingTransactionId
+                ? ("/transactions/" + editingTransactionId + (isFamilyView ? "?family=true" : ""))
+                : ("/transactions" + (isFamilyView ? "?family=true" : ""));
+            const resp = await fetch(url, {
+                method: editingTransactionId ? "PUT" : "POST",
+                headers: {
+                    "Content-Type": "application/json",
+                    "Authorization": "Bearer " + token
+                },
+                body: JSON.stringify(body)
+            });
+            const text = await resp.text();
+            if (resp.ok) {
+                alert(editingTransactionId ? "Транзакция обновлена" : "Транзакция создана");
+                form.reset();
+                form.id_category.value = "";
+                editingTransactionId = null;
+                document.getElementById("submitBtn").textContent = "Создать";
+                document.getElementById("cancelTransactionEdit").style.display = "none";
+                loadAccounts();
+                loadCategories();
+                loadAccountsForDisplay().then(() => loadTransactions());
+            } else {
+                alert("Ошибка: " + text);
+            }
+        } catch (error) {
+            alert("Ошибка сети: " + error.message);
+        }
+    });
+}
+
+const cancelBtnTx = document.getElementById("cancelTransactionEdit");
+if (cancelBtnTx) {
+    cancelBtnTx.addEventListener("click", cancelTransactionEdit);
+}
+
+function startEditTransaction(id) {
+    const tr = transactionsData.find(t => t.id === id);
+    if (!tr) return;
+    editingTransactionId = id;
+    editTxAccount.value = tr.id_account;
+    editTxAmount.value = tr.amount;
+    editTxType.value = tr.type;
+    editTxDescription.value = tr.description || "";
+    editTxCategory.value = tr.id_category || "";
+    editTxModal.style.display = "block";
+}
+
+function cancelTransactionEdit() {
+    editingTransactionId = null;
+    editTxModal.style.display = "none";
+}
+
+function closeEditTransactionModal() {
+    editingTransactionId = null;
+    editTxModal.style.display = "none";
+}
+
+document.getElementById("editTransactionForm").addEventListener("submit", async (e) => {
+    e.preventDefault();
+    if (!editingTransactionId) {
+        closeEditTransactionModal();
+        return;
+    }
+    const accountId = editTxAccount.value;
+    if (!accountId) {
+        alert("Пожалуйста, выберите счёт");
+        return;
+    }
+    const amountValue = parseFloat(editTxAmount.value);
+    if (isNaN(amountValue) || amountValue <= 0) {
+        alert("Пожалуйста, введите корректную сумму (больше 0)");
+        return;
+    }
+    const body = {
+        id_account: Number(accountId),
+        amount: amountValue.toString(),
+        type: editTxType.value,
+        description: editTxDescription.value || ""
+    };
+    if (editTxCategory.value) {
+        body.id_category = Number(editTxCategory.value);
+    }
+    try {
+        const url = "/transactions/" + editingTransactionId + (isFamilyView ? "?family=true" : "");
+        const resp = await fetch(url, {
+            method: "PUT",
+            headers: {
+                "Content-Type": "application/json",
+                "Authorization": "Bearer " + token
+            },
+            body: JSON.stringify(body)
+        });
+        const text = await resp.text();
+        if (resp.ok) {
+            alert("Транзакция обновлена");
+            closeEditTransactionModal();
+            loadAccountsForDisplay().then(() => loadTransactions());
+        } else {
+            alert("Ошибка: " + text);
+        }
+    } catch (error) {
+        alert("Ошибка сети: " + error.message);
+    }
+});
+
+async function deleteTransaction(id) {
+    if (!confirm("Удалить транзакцию?")) return;
+    try {
+        const resp = await fetch("/transactions/" + id + (isFamilyView ? "?family=true" : ""), {
+            method: "DELETE",
+            headers: {
+                "Authorization": "Bearer " + token
+            }
+        });
+        if (resp.status === 204) {
+            if (editingTransactionId === id) {
+                cancelTransactionEdit();
+            }
+            loadAccountsForDisplay().then(() => loadTransactions());
+        } else {
+            const text = await resp.text();
+            alert("Ошибка удаления: " + text);
+        }
+    } catch (error) {
+        alert("Ошибка сети: " + error.message);
+    }
+}
+
+// Загружаем счета, категории и транзакции при загрузке страницы (стартовые данные одним запросом)
+const boot = loadBootstrap(token, isFamilyView);
+loadAccounts(boot);
+loadCategories(boot);
+loadAccountsForDisplay(boot).then(() => loadTransactions(boot));
@@ -0,0 +1,282 @@
+const token = localStorage.getItem("authToken") || localStorage.getItem("token");
+if (!token) {
+    window.location.href = "/auth/login";
+}
+const urlParams = new URLSearchParams(window.location.search);
+const isFamilyView = urlParams.get("family") === "true";
+
+function formatDate(dateStr) {
+    if (!dateStr) return "-";
+    try {
+        const date = new Date(dateStr);
+        return date.toLocaleString("ru-RU", {
+            year: "numeric",
+            month: "2-digit",
+            day: "2-digit",
+            hour: "2-digit",
+            minute: "2-digit"
+        });
+    } catch (e) {
+        return dateStr || "-";
+    }
+}
+
+let accountsCache = {};
+let transfersData = [];
+let editingTransferId = null;
+const editTransferModal = document.getElementById("editTransferModal");
+const editTransferFrom = document.getElementById("editTransferFrom");
+const editTransferTo = document.getElementById("editTransferTo");
+const editTransferAmount = document.getElementById("editTransferAmount");
+
+async function loadAccountsForDisplay(boot) {
+    try {
+        const resp = await fetchFromBootstrap(boot, "accounts", "/accounts" + (isFamilyView ? "?family=true" : ""), token);
+        if (resp.ok) {
+            const accounts = await resp.json();
+            accountsCache = {};
+            accounts.forEach(acc => {
+                accountsCache[acc.id] = acc;
+            });
+            fillTransferSelects(accounts);
+        }
+    } catch {}
+}
+
+function fillTransferSelects(accounts) {
+    const options = ['<option value="">Выберите счёт</option>'].concat(
+        accounts.map(acc => `<option value="${acc.id}">${escapeHtml(acc.account_name)} (${acc.account_type}) - Баланс: ${acc.balance} руб.</option>`)
+    ).join("");
+    if (editTransferFrom) editTransferFrom.innerHTML = options;
+    if (editTransferTo) editTransferTo.innerHTML = options;
+}
+
+async function loadTransfers(boot) {
+    const loadingMsg = document.getElementById("loadingMessage");
+    const emptyMsg = document.getElementById("emptyMessage");
+    const table = document.getElementById("transfersTable");
+    const tbody = document.getElementById("transfersTableBody");
+    
+    try {
+        const url = "/transfers" + (isFamilyView ? "?family=true" : "");
+        const resp = await fetchFromBootstrap(boot, "transfers", url, token);
+        if (!resp.ok) {
+            loadingMsg.textContent = "Ошибка загрузки переводов";
+            return;
+        }
+        const data = await resp.json();
+        transfersData = data;
+        loadingMsg.style.display = "none";
+        
+        if (!data || data.length === 0) {
+            emptyMsg.style.display = "block";
+            table.style.display = "none";
+        } else {
+            emptyMsg.style.display = "none";
+            table.style.display = "table";
+            tbody.innerHTML = "";
+            data.forEach(tr => {
+                const row = document.createElement("tr");
+                row.style.borderBottom = "1px solid #eee";
+                const fromAcc = accountsCache[tr.account_from];
+                const toAcc = accountsCache[tr.account_to];
+                const fromName = fromAcc ? fromAcc.account_name : "Счёт отправителя недоступен";
+                const toName = toAcc ? toAcc.account_name : "Счёт получателя недоступен";
+                const accessType = tr.is_family ? "Семейный" : "Личный";
+                row.innerHTML =
+                    "<td style=\"padding: 0.5em; word-break: break-word; white-space: normal;\">" + escapeHtml(fromName) + "</td>" +
+                    "<td style=\"padding: 0.5em; word-break: break-word; white-space: normal;\">" + escapeHtml(toName) + "</td>" +
+                    "<td style=\"padding: 0.5em; font-weight: bold;\">" + escapeHtml(tr.amount) + " руб.</td>" +
+                    "<td style=\"padding: 0.5em;\">" + formatDate(tr.created_at) + "</td>" +
+                    "<td style=\"padding: 0.5em;\">" + accessType + "</td>" +
+                    "<td style=\"padding: 0.5em; display:flex; gap:6px; flex-wrap:wrap;\">" +
+                        "<button onclick=\"startEditTransfer(" + tr.id + ")\" style=\"padding:4px 8px;\">Редактировать</button>" +
+                        "<button onclick=\"deleteTransfer(" + tr.id + ")\" style=\"padding:4px 8px; background:#dc3545; color:#fff; border:none;\">Удалить</button>" +
+                    "</td>";
+                tbody.appendChild(row);
+            });
+        }
+    } catch (error) {
+        loadingMsg.textContent = "Ошибка сети: " + error.message;
+        console.error("Error loading transfers:", error);
+    }
+}
+
+function escapeHtml(text) {
+    const div = document.createElement("div");
+    div.textContent = text;
+    return div.innerHTML;
+}
+
+async function loadAccounts(boot) {
+    const fromSelect = document.getElementById("accountFromSelect");
+    const toSelect = document.getElementById("accountToSelect");
+    
+    try {
+        const resp = await fetchFromBootstrap(boot, "accounts", "/accounts" + (isFamilyView ? "?family=true" : ""), token);
+        if (!resp.ok) {
+            fromSelect.innerHTML = "<option value=\"\">Ошибка загрузки счетов</option>";
+            toSelect.innerHTML = "<option value=\"\">Ошибка загрузки счетов</option>";
+            return;
+        }
+        const accounts = await resp.json();
+        let options = "<option value=\"\">Выберите счёт</option>";
+        accounts.forEach(acc => {
+            options += "<option value=\"" + acc.id + "\">" + acc.account_name + " (" + acc.account_type + ") - Баланс: " + acc.balance + " руб.</option>";
+        });
+        fromSelect.innerHTML = options;
+        toSelect.innerHTML = options;
+        fillTransferSelects(accounts);
+    } catch (error) {
+        fromSelect.innerHTML = "<option value=\"\">Ошибка сети</option>";
+        toSelect.innerHTML = "<option value=\"\">Ошибка сети</option>";
+        console.error("Error loading accounts:", error);
+    }
+}
+
+const form = document.getElementById("createTransferForm");
+if (form) {
+    form.addEventListener("submit", async (e) => {
+        e.preventDefault();
+        const fromId = form.account_from.value;
+        const toId = form.account_to.value;
+        if (!fromId || !toId) {
+            alert("Пожалуйста, выберите оба счёта");
+            return;
+        }
+        if (fromId === toId) {
+            alert("Счёт отправителя и получателя не могут быть одинаковыми");
+            return;
+        }
+        const amountValue = parseFloat(form.amount.value);
+        if (isNaN(amountValue) || amountValue <= 0) {
+            alert("Пожалуйста, введите корректную сумму (больше 0)");
+            return;
+        }
+        
+        const body = {
+            account_from: Number(fromId),
+            account_to: Number(toId),
+            amount: amountValue.toString()
+        };
+        try {
+            const url = "/transfers" + (isFamilyView ? "?family=true" : "");
+            const resp = await fetch(url, {
+                method: "POST",
+                headers: {
+                    "Content-Type": "application/json",
+                    "Authorization": "Bearer " + token
+                },
+                body: JSON.stringify(body)
+            });
+            const text = await resp.text();
+            if (resp.ok) {
+                alert("Перевод создан");
+                form.reset();
+                loadAccounts();
+                loadAccountsForDisplay().then(() => loadTransfers());
+            } else {
+                alert("Ошибка: " + text);
+            }
+        } catch (error) {
+            alert("Ошибка сети: " + error.message);
+        }
+    });
+}
+
+function startEditTransfer(id) {
+    const tr = transfersData.find(t => t.id === id);
+    if (!tr) return;
+    editingTransferId = id;
+    editTransferFrom.value = tr.account_from;
+    editTransferTo.value = tr.account_to;
+    editTransferAmount.value = tr.amount;
+    editTransferModal.style.display = "block";
+}
+
+function cancelTransferEdit() {
+    editingTransferId = null;
+    editTransferModal.style.display = "none";
+}
+
+function closeEditTransferModal() {
+    editingTransferId = null;
+    editTransferModal.style.display = "none";
+}
+
+document.getElementById("editTransferForm").addEventListener("submit", async (e) => {
+    e.preventDefault();
+    if (!editingTransferId) {
+        closeEditTransferModal();
+        return;
+    }
+    const fromId = editTransferFrom.value;
+    const toId = editTransferTo.value;
+    if (!fromId || !toId) {
+        alert("Пожалуйста, выберите оба счёта");
+        return;
+    }
+    if (fromId === toId) {
+        alert("Счёт отправителя и получателя не могут быть одинаковыми");
+        return;
+    }
+    const amountValue = parseFloat(editTransferAmount.value);
+    if (isNaN(amountValue) || amountValue <= 0) {
+        alert("Пожалуйста, введите корректную сумму (больше 0)");
+        return;
+    }
+    const body = {
+        account_from: Number(fromId),
+        account_to: Number(toId),
+        amount: amountValue.toString()
+    };
+    try {
+        const url = "/transfers/" + editingTransferId + (isFamilyView ? "?family=true" : "");
+        const resp = await fetch(url, {
+            method: "PUT",
+            headers: {
+                "Content-Type": "application/json",
+                "Authorization": "Bearer " + token
+            },
+            body: JSON.stringify(body)
+        });
+        const text = await resp.text();
+        if (resp.ok) {
+            alert("Перевод обновлён");
+            closeEditTransferModal();
+            loadAccountsForDisplay().then(() => loadTransfers());
+        } else {
+            alert("Ошибка: " + text);
+        }
+    } catch (error) {
+        alert("Ошибка сети: " + error.message);
+    }
+});
+
+async function deleteTransfer(id) {
+    if (!confirm("Удалить перевод?")) return;
+    try {
+        const resp = await fetch("/transfers/" + id + (isFamilyView ? "?family=true" : ""), {
+            method: "DELETE",
+            headers: {
+                "Authorization": "Bearer " + token
+            }
+        });
+        if (resp.status === 204) {
+            if (editingTransferId === id) {
+                cancelTransferEdit();
+            }
+            loadAccountsForDisplay().then(() => loadTransfers());
+        } else {
+            const text = await resp.text();
+            alert("Ошибка удаления: " + text);
+        }
+    } catch (error) {
+        alert("Ошибка сети: " + error.message);
+    }
+}
+
+// Загружаем счета и переводы при загрузке страницы
+const boot = loadBootstrap(token, isFamilyView);
+loadAccounts(boot);
+loadAccountsForDisplay(boot).then(() => loadTransfers(boot));
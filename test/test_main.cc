@@ -1,16 +1,298 @@
 #define DROGON_TEST_MAIN
 #include <drogon/drogon_test.h>
 #include <drogon/drogon.h>
+#include <algorithm>
+#include <atomic>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "db/DataBase.h"
+#include "db/FakeDbClient.h"
+#include "db/GroupCommit.h"
+#include "db/Idempotency.h"
+#include "db/MeteredDbClient.h"
+#include "db/Transaction.h"
+#include "utils/AmountUtils.h"
+#include "utils/CoroUtils.h"
+#include "utils/JwtUtils.h"
+#include "utils/Metrics.h"
+
+static constexpr int64_t kUserId = 7;
+static constexpr uint16_t kTestPort = 18480;
+
+// Вместо PostgreSQL — db::FakeDbClient со схемой приложения; счета тестов заводятся
+// в самих тестах, у каждого свой id
+static std::shared_ptr<db::FakeDbClient> testDb()
+{
+    static auto client = [] {
+        auto c = std::make_shared<db::FakeDbClient>();
+        c->addAppSchema();
+        c->insert("users", {{"id", std::to_string(kUserId)}, {"name", "Test"},
+                            {"email", "test@example.com"}, {"hashed_password", "x"}});
+        db::setDbClientOverride(c);
+        return c;
+    }();
+    return client;
+}
+
+static void addAccount(int32_t id, const std::string &balance)
+{
+    testDb()->insert("account", {{"id", std::to_string(id)}, {"id_user", std::to_string(kUserId)},
+                                 {"account_type", "card"}, {"account_name", "Test"}, {"balance", balance}});
+}
+
+static std::string balanceOf(int32_t id)
+{
+    auto rows = testDb()->select("account", {{"id", std::to_string(id)}});
+    auto col = std::find(rows.columns.begin(), rows.columns.end(), "balance");
+    return rows.rows.at(0).at(static_cast<size_t>(col - rows.columns.begin())).value_or("");
+}
+
+static db::NewTransaction newTransaction(int32_t idAccount, double amount, const std::string &type)
+{
+    db::NewTransaction tx;
+    tx.idUser = static_cast<int32_t>(kUserId);
+    tx.idAccount = idAccount;
+    tx.amount = amount_utils::amountToString(amount);
+    tx.amountValue = amount;
+    tx.type = type;
+    return tx;
+}
+
+// Записи отправляются за один проход event loop: первая сразу уходит пакетом,
+// остальные ждут её COMMIT в очереди счёта и уходят следующим пакетом
+static drogon::Task<std::vector<db::NewTransactionResult>> addTogether(std::vector<db::NewTransaction> items)
+{
+    co_await drogon::switchThreadCoro(drogon::app().getLoop());
+    std::vector<drogon::Task<db::NewTransactionResult>> tasks;
+    for (auto &item : items)
+    {
+        tasks.push_back(db::addTransaction(std::move(item)));
+    }
+    co_return co_await coro::when_all(std::move(tasks));
+}
 
 DROGON_TEST(BasicTest)
 {
     // Add your tests here
 }
 
-int main(int argc, char** argv) 
+DROGON_TEST(GroupCommitBatchesWritesToOneAccount)
+{
+    auto fake = testDb();
+    addAccount(101, "100.00");
+    std::vector<db::NewTransaction> items;
+    for (int i = 0; i < 8; ++i)
+    {
+        items.push_back(newTransaction(101, 1, "income"));
+    }
+    const auto before = fake->statementCount();
+    auto results = drogon::sync_wait(addTogether(std::move(items)));
+
+    REQUIRE(results.size() == 8);
+    for (const auto &result : results)
+    {
+        CHECK(result.status == drogon::k201Created);
+        CHECK(result.inserted.has_value());
+    }
+    CHECK(balanceOf(101) == "108.00");
+    // Два пакета по три запроса (блокировка, баланс, INSERT) вместо трёх на каждую запись
+    CHECK(fake->statementCount() - before == 6);
+}
+
+DROGON_TEST(GroupCommitRejectsOverdraft)
+{
+    addAccount(102, "100.00");
+    std::vector<db::NewTransaction> items{newTransaction(102, 60, "expense"),
+                                          newTransaction(102, 60, "expense"),
+                                          newTransaction(102, 10, "income")};
+    auto results = drogon::sync_wait(addTogether(std::move(items)));
+
+    REQUIRE(results.size() == 3);
+    CHECK(results[0].inserted.has_value());
+    CHECK(!results[1].inserted.has_value());
+    CHECK(results[1].status == drogon::k400BadRequest);
+    CHECK(results[1].error == "Insufficient funds");
+    // Отказ одной записи не задевает остальные записи пакета
+    CHECK(results[2].inserted.has_value());
+    CHECK(balanceOf(102) == "50.00");
+
+    std::vector<db::NewTransaction> missing{newTransaction(999, 1, "income")};
+    auto rejected = drogon::sync_wait(addTogether(std::move(missing)));
+    REQUIRE(rejected.size() == 1);
+    CHECK(rejected[0].status == drogon::k403Forbidden);
+}
+
+DROGON_TEST(TxScopeCommitAndRollback)
+{
+    auto fake = testDb();
+
+    drogon::sync_wait([&]() -> drogon::Task<> {
+        auto db = db::getDbClient();
+        db::TxScope tx(db, co_await db->newTransactionCoro());
+        // Запросы внутри транзакции замеряются так же, как через внешний клиент
+        CHECK(std::dynamic_pointer_cast<db::MeteredDbClient>(tx.client()) != nullptr);
+        co_await tx.commit();
+        CHECK(tx.client() == nullptr);
+    }());
+
+    // Без commit() деструктор откатывает транзакцию
+    std::optional<bool> committed;
+    {
+        db::TxScope tx(fake, fake->newTransaction([&](bool ok) { committed = ok; }));
+    }
+    REQUIRE(committed.has_value());
+    CHECK(!*committed);
+
+    // Лишняя ссылка на транзакцию не дала бы COMMIT уйти
+    auto transaction = fake->newTransaction();
+    auto extra = transaction;
+    db::TxScope tx(fake, std::move(transaction));
+    CHECK_THROWS_AS(tx.commit(), std::logic_error);
+}
+
+static drogon::Task<int> valueTask(int v)
+{
+    co_return v;
+}
+
+static drogon::Task<int> failingTask()
+{
+    throw std::runtime_error("failed");
+    co_return 0;
+}
+
+DROGON_TEST(CoroWhenAll)
+{
+    auto [a, b] = drogon::sync_wait(coro::when_all(valueTask(1), valueTask(2)));
+    CHECK(a == 1);
+    CHECK(b == 2);
+
+    std::vector<drogon::Task<int>> tasks;
+    for (int i = 0; i < 3; ++i)
+    {
+        tasks.push_back(valueTask(i));
+    }
+    auto values = drogon::sync_wait(coro::when_all(std::move(tasks)));
+    CHECK(values == std::vector<int>({0, 1, 2}));
+
+    CHECK_THROWS_AS(drogon::sync_wait(coro::when_all(valueTask(1), failingTask())), std::runtime_error);
+}
+
+DROGON_TEST(StatementTag)
+{
+    CHECK(db::statementTag("/*list_accounts_v1*/ SELECT * FROM account") == "list_accounts_v1");
+    CHECK(db::statementTag("select * from \"account\" where id = $1") == "select_account");
+    CHECK(db::statementTag("INSERT INTO transactions (id) VALUES ($1)") == "insert_transactions");
+    CHECK(db::statementTag("UPDATE budgets SET amount = $1 WHERE id = $2") == "update_budgets");
+    CHECK(db::statementTag("DELETE FROM transfer WHERE id = $1") == "delete_transfer");
+    CHECK(db::statementTag("BEGIN") == "begin");
+    CHECK(db::statementTag("") == "unknown");
+}
+
+DROGON_TEST(MergeWorkerMetrics)
+{
+    const std::vector<std::string> outputs{
+        "# HELP fm_requests Requests\n# TYPE fm_requests counter\nfm_requests{route=\"/a\"} 1\n"
+        "# TYPE fm_latency histogram\nfm_latency_bucket{le=\"1\"} 1\nfm_latency_sum 0.5\nfm_latency_count 1\n",
+        "# HELP fm_requests Requests\n# TYPE fm_requests counter\nfm_requests{route=\"/a\"} 2\nfm_other 3\n"};
+    CHECK(metrics::mergeWorkers(outputs) ==
+          "# HELP fm_requests Requests\n"
+          "# TYPE fm_requests counter\n"
+          "fm_requests{worker=\"0\",route=\"/a\"} 1\n"
+          "fm_requests{worker=\"1\",route=\"/a\"} 2\n"
+          "# TYPE fm_latency histogram\n"
+          "fm_latency_bucket{worker=\"0\",le=\"1\"} 1\n"
+          "fm_latency_sum{worker=\"0\"} 0.5\n"
+          "fm_latency_count{worker=\"0\"} 1\n"
+          "fm_other{worker=\"1\"} 3\n");
+}
+
+DROGON_TEST(ParseRequestAmount)
+{
+    CHECK(amount_utils::parseRequestAmount("12.50") == 12.5);
+    CHECK(amount_utils::parseRequestAmount("-3") == -3.0);
+    CHECK(!amount_utils::parseRequestAmount(""));
+    CHECK(!amount_utils::parseRequestAmount("12abc"));
+    CHECK(!amount_utils::parseRequestAmount("1e400"));
+    CHECK(!amount_utils::parseRequestAmount("nan"));
+    CHECK(!amount_utils::parseRequestAmount("inf"));
+}
+
+// Обработчик за маршрутом с Idempotency-Key: тело ответа — номер вызова
+static std::atomic<int> idempotentCalls{0};
+
+static drogon::HttpResponsePtr sendIdempotent(const std::string &key, const std::string &body)
+{
+    static auto client = drogon::HttpClient::newHttpClient("127.0.0.1", kTestPort);
+    auto req = drogon::HttpRequest::newHttpRequest();
+    req->setMethod(drogon::Post);
+    req->setPath("/test/idempotent");
+    req->addHeader("Authorization", "Bearer " + jwt_utils::createToken(kUserId, "test@example.com"));
+    req->addHeader("Idempotency-Key", key);
+    req->setBody(body);
+    auto [result, resp] = client->sendRequest(req, 5);
+    return result == drogon::ReqResult::Ok ? resp : nullptr;
+}
+
+DROGON_TEST(IdempotencyClaimAndReplay)
+{
+    const int callsBefore = idempotentCalls.load();
+    auto first = sendIdempotent("key-1", "{\"amount\":\"1\"}");
+    REQUIRE(first != nullptr);
+    CHECK(first->statusCode() == drogon::k201Created);
+    CHECK(first->getHeader("Idempotent-Replayed").empty());
+
+    // Повтор с тем же ключом и телом получает сохранённый ответ, обработчик не вызывается
+    auto retry = sendIdempotent("key-1", "{\"amount\":\"1\"}");
+    REQUIRE(retry != nullptr);
+    CHECK(retry->statusCode() == drogon::k201Created);
+    CHECK(retry->getHeader("Idempotent-Replayed") == "true");
+    CHECK(retry->body() == first->body());
+    CHECK(idempotentCalls.load() == callsBefore + 1);
+
+    // Тот же ключ для другого запроса — 422
+    auto other = sendIdempotent("key-1", "{\"amount\":\"2\"}");
+    REQUIRE(other != nullptr);
+    CHECK(other->statusCode() == drogon::k422UnprocessableEntity);
+
+    auto fresh = sendIdempotent("key-2", "{\"amount\":\"1\"}");
+    REQUIRE(fresh != nullptr);
+    CHECK(fresh->statusCode() == drogon::k201Created);
+    CHECK(idempotentCalls.load() == callsBefore + 2);
+}
+
+int main(int argc, char** argv)
 {
     using namespace drogon;
 
+    // Один IO-поток и маршрут для проверки Idempotency-Key (db/Idempotency.h)
+    Json::Value config;
+    config["app"]["number_of_threads"] = 1;
+    config["custom_config"]["idempotency"]["routes"].append("POST /test/idempotent");
+    app().loadConfigJson(config);
+    app().addListener("127.0.0.1", kTestPort);
+    testDb();
+    db::loadIdempotencyOptions();
+    app().registerPreHandlingAdvice([](const HttpRequestPtr &req,
+                                       AdviceCallback &&callback,
+                                       AdviceChainCallback &&chainCallback) {
+        db::beginIdempotent(req, std::move(callback), std::move(chainCallback));
+    });
+    app().registerPostHandlingAdvice([](const HttpRequestPtr &req, const HttpResponsePtr &resp) {
+        db::finishIdempotent(req, resp);
+    });
+    app().registerHandler(
+        "/test/idempotent",
+        [](const HttpRequestPtr &, std::function<void(const HttpResponsePtr &)> &&callback) {
+            auto resp = HttpResponse::newHttpResponse();
+            resp->setStatusCode(k201Created);
+            resp->setBody(std::to_string(++idempotentCalls));
+            callback(resp);
+        },
+        {Post});
+
     std::promise<void> p1;
     std::future<void> f1 = p1.get_future();
 
@@ -0,0 +1,33 @@
+#include "AmountUtils.h"
+#include <cmath>
+#include <sstream>
+
+double amount_utils::parseAmount(const std::string &s) {
+    try {
+        return std::stod(s);
+    } catch (...) {
+        return 0.0;
+    }
+}
+
+std::string amount_utils::amountToString(double v) {
+    std::ostringstream oss;
+    oss.setf(std::ios::fixed);
+    oss.precision(2);
+    oss << v;
+    return oss.str();
+}
+
+std::optional<double> amount_utils::parseRequestAmount(const std::string &s) {
+    size_t pos = 0;
+    double v = 0.0;
+    try {
+        v = std::stod(s, &pos);
+    } catch (...) {
+        return std::nullopt;
+    }
+    if (pos != s.size() || !std::isfinite(v)) {
+        return std::nullopt;
+    }
+    return v;
+}
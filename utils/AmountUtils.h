@@ -0,0 +1,12 @@
+#pragma once
+#include <optional>
+#include <string>
+
+// Денежные суммы хранятся в БД строками (numeric) — разбор и форматирование с двумя знаками
+namespace amount_utils {
+    // Некорректная строка даёт 0.0
+    double parseAmount(const std::string &s);
+    std::string amountToString(double v);
+    // Сумма из запроса: вся строка — конечное число ("12abc", "1e400", "nan" не проходят)
+    std::optional<double> parseRequestAmount(const std::string &s);
+}
@@ -0,0 +1,284 @@
+#include "AsyncLog.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <drogon/HttpAppFramework.h>
+#include <trantor/utils/Logger.h>
+#include "Metrics.h"
+#include "Prefork.h"
+
+static asynclog::Options g_options;
+
+const asynclog::Options &asynclog::loadOptions() {
+    const auto &cfg = drogon::app().getCustomConfig()["async_log"];
+    if (cfg.isObject()) {
+        g_options.enabled = cfg.get("enabled", true).asBool();
+        g_options.file = cfg.get("file", "").asString();
+        g_options.rotateBytes = cfg.get("rotate_bytes", Json::UInt64(g_options.rotateBytes)).asUInt64();
+        g_options.maxFiles = cfg.get("max_files", Json::UInt(g_options.maxFiles)).asUInt();
+        g_options.bufferBytes = cfg.get("buffer_kb", Json::UInt(g_options.bufferBytes / 1024)).asUInt() * 1024;
+        g_options.flushIntervalMs = cfg.get("flush_interval_ms", g_options.flushIntervalMs).asUInt();
+    }
+    if (const char *env = std::getenv("FM_LOG_FILE")) {
+        g_options.file = env;
+    }
+    return g_options;
+}
+
+// Кольцевой буфер одного потока: пишет только этот поток (head), читает только
+// фоновый поток (tail). Счётчики растут монотонно, позиция в data — по модулю размера
+namespace {
+struct Ring {
+    explicit Ring(size_t capacity) : data(capacity) {}
+
+    std::vector<char> data;
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> tail{0};
+    std::atomic<uint64_t> dropped{0};
+};
+}
+
+static std::mutex &ringsMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+static std::vector<std::shared_ptr<Ring>> &rings() {
+    static std::vector<std::shared_ptr<Ring>> all;
+    return all;
+}
+
+static Ring &localRing() {
+    thread_local std::shared_ptr<Ring> ring = [] {
+        auto r = std::make_shared<Ring>(std::max<size_t>(g_options.bufferBytes, 4096));
+        std::lock_guard lock(ringsMutex());
+        rings().push_back(r);
+        return r;
+    }();
+    return *ring;
+}
+
+static void append(const char *msg, uint64_t len) {
+    auto &ring = localRing();
+    const uint64_t capacity = ring.data.size();
+    const uint64_t head = ring.head.load(std::memory_order_relaxed);
+    const uint64_t tail = ring.tail.load(std::memory_order_acquire);
+    if (len > capacity - (head - tail)) {
+        ring.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const size_t pos = head % capacity;
+    const size_t first = std::min<uint64_t>(len, capacity - pos);
+    std::memcpy(ring.data.data() + pos, msg, first);
+    std::memcpy(ring.data.data(), msg + first, len - first);
+    ring.head.store(head + len, std::memory_order_release);
+}
+
+// Состояние фонового потока; flushMutex защищает файл и чтение буферов
+static std::mutex &flushMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+static int g_fd = STDERR_FILENO;
+static std::string g_path;
+static uint64_t g_fileSize = 0;
+
+static void openFile() {
+    if (g_path.empty()) {
+        g_fd = STDERR_FILENO;
+        return;
+    }
+    int fd = ::open(g_path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::fprintf(stderr, "asynclog: cannot open %s: %s\n", g_path.c_str(), std::strerror(errno));
+        g_fd = STDERR_FILENO;
+        return;
+    }
+    struct stat st {};
+    g_fileSize = ::fstat(fd, &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+    g_fd = fd;
+}
+
+static void rotate() {
+    if (g_fd != STDERR_FILENO) {
+        ::close(g_fd);
+    }
+    for (size_t i = g_options.maxFiles; i > 1; --i) {
+        auto from = g_path + "." + std::to_string(i - 1);
+        auto to = g_path + "." + std::to_string(i);
+        ::rename(from.c_str(), to.c_str());
+    }
+    if (g_options.maxFiles > 0) {
+        ::rename(g_path.c_str(), (g_path + ".1").c_str());
+    } else {
+        ::unlink(g_path.c_str());
+    }
+    g_fileSize = 0;
+    openFile();
+}
+
+static void writeAll(std::vector<iovec> &iov) {
+    size_t i = 0;
+    while (i < iov.size()) {
+        const int count = static_cast<int>(std::min<size_t>(iov.size() - i, IOV_MAX));
+        ssize_t n = ::writev(g_fd, iov.data() + i, count);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        g_fileSize += static_cast<uint64_t>(n);
+        // Частичная запись: пропускаем записанные куски и дописываем остаток
+        while (i < iov.size() && static_cast<size_t>(n) >= iov[i].iov_len) {
+            n -= static_cast<ssize_t>(iov[i].iov_len);
+            ++i;
+        }
+        if (i < iov.size()) {
+            iov[i].iov_base = static_cast<char *>(iov[i].iov_base) + n;
+            iov[i].iov_len -= static_cast<size_t>(n);
+        }
+    }
+}
+
+static metrics::Counter &droppedCounter() {
+    static metrics::Counter c("fm_log_dropped_total", "Log lines dropped because a thread's log buffer was full", {});
+    return c;
+}
+
+// Забирает всё накопленное из буферов всех потоков одним writev
+static void drain() {
+    std::lock_guard lock(flushMutex());
+    std::vector<std::shared_ptr<Ring>> snapshot;
+    {
+        std::lock_guard ringsLock(ringsMutex());
+        // Буферы завершившихся потоков, из которых уже всё записано, больше не нужны
+        auto &all = rings();
+        all.erase(std::remove_if(all.begin(), all.end(),
+                                 [](const std::shared_ptr<Ring> &r) {
+                                     return r.use_count() == 1 &&
+                                            r->head.load(std::memory_order_acquire) ==
+                                                r->tail.load(std::memory_order_relaxed);
+                                 }),
+                  all.end());
+        snapshot = all;
+    }
+
+    std::vector<iovec> iov;
+    std::vector<uint64_t> heads(snapshot.size());
+    uint64_t dropped = 0;
+    for (size_t i = 0; i < snapshot.size(); ++i) {
+        auto &ring = *snapshot[i];
+        const uint64_t capacity = ring.data.size();
+        const uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+        heads[i] = ring.head.load(std::memory_order_acquire);
+        dropped += ring.dropped.exchange(0, std::memory_order_relaxed);
+        if (heads[i] == tail) {
+            continue;
+        }
+        const size_t pos = tail % capacity;
+        const size_t len = heads[i] - tail;
+        const size_t first = std::min<size_t>(len, capacity - pos);
+        iov.push_back({ring.data.data() + pos, first});
+        if (len > first) {
+            iov.push_back({ring.data.data(), len - first});
+        }
+    }
+    std::string droppedNote;
+    if (dropped > 0) {
+        droppedCounter().add({}, static_cast<double>(dropped));
+        droppedNote = "asynclog: dropped " + std::to_string(dropped) + " log lines, buffer full\n";
+        iov.push_back({droppedNote.data(), droppedNote.size()});
+    }
+    if (!iov.empty()) {
+        writeAll(iov);
+    }
+    for (size_t i = 0; i < snapshot.size(); ++i) {
+        snapshot[i]->tail.store(heads[i], std::memory_order_release);
+    }
+    if (g_options.rotateBytes > 0 && !g_path.empty() && g_fileSize >= g_options.rotateBytes) {
+        rotate();
+    }
+}
+
+void asynclog::flush() {
+    drain();
+}
+
+// Пробуждение фонового потока раньше flushIntervalMs. Флаг ставится без блокировки:
+// уведомление, пришедшее до начала ожидания, теряется, и строки уходят по таймеру
+static std::mutex &wakeMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+static std::condition_variable g_wakeCv;
+static std::atomic<bool> g_wakeRequested{false};
+
+static void wake() {
+    if (!g_wakeRequested.exchange(true, std::memory_order_acq_rel)) {
+        g_wakeCv.notify_one();
+    }
+}
+
+void asynclog::start() {
+    if (!g_options.enabled) {
+        return;
+    }
+    g_path = g_options.file;
+    // В prefork-режиме у каждого процесса свой файл: ротация переименовывает файл,
+    // и общий файл процессы переименовывали бы друг у друга
+    if (!g_path.empty() && prefork::options().workers > 0) {
+        g_path += "." + std::to_string(prefork::workerIndex());
+    }
+    openFile();
+
+    std::thread([] {
+        for (;;) {
+            {
+                std::unique_lock lock(wakeMutex());
+                g_wakeCv.wait_for(lock, std::chrono::milliseconds(g_options.flushIntervalMs),
+                                  [] { return g_wakeRequested.load(std::memory_order_acquire); });
+            }
+            g_wakeRequested.store(false, std::memory_order_release);
+            drain();
+        }
+    }).detach();
+
+    // trantor вызывает функцию сброса синхронно после каждой строки уровня ERROR и выше:
+    // поток запроса только будит фоновый поток, а не пишет файл сам
+    trantor::Logger::setOutputFunction([](const char *msg, const uint64_t len) { append(msg, len); },
+                                       [] { wake(); });
+}
+
+static const char *const kLevelNames[] = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR", "FATAL"};
+
+std::string asynclog::logLevel() {
+    const auto level = static_cast<size_t>(trantor::Logger::logLevel());
+    return level < std::size(kLevelNames) ? kLevelNames[level] : "UNKNOWN";
+}
+
+bool asynclog::setLogLevel(const std::string &level) {
+    for (size_t i = 0; i < std::size(kLevelNames); ++i) {
+        if (strcasecmp(level.c_str(), kLevelNames[i]) == 0) {
+            trantor::Logger::setLogLevel(static_cast<trantor::Logger::LogLevel>(i));
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Асинхронный вывод логов trantor (LOG_* и строки AccessLogger-а). Каждый поток пишет
+// в свой кольцевой буфер без блокировок; фоновый поток забирает накопленное из всех
+// буферов одним writev и ротирует файл по размеру. Если буфер потока полон, строка
+// отбрасывается и учитывается в fm_log_dropped_total — поток запроса никогда не ждёт диск.
+namespace asynclog {
+
+struct Options {
+    bool enabled = true;
+    // Пусто — stderr
+    std::string file;
+    // Размер файла, после которого он переименовывается в <file>.1; 0 — без ротации
+    uint64_t rotateBytes = 100 * 1024 * 1024;
+    // Сколько старых файлов хранить (<file>.1 … <file>.N)
+    size_t maxFiles = 5;
+    // Размер кольцевого буфера каждого потока
+    size_t bufferBytes = 1024 * 1024;
+    // Как часто фоновый поток сбрасывает буферы
+    uint32_t flushIntervalMs = 50;
+};
+
+// custom_config.async_log из config.json; FM_LOG_FILE имеет приоритет.
+// Вызывать после loadConfigFile
+const Options &loadOptions();
+
+// Подключает буферы к trantor::Logger и запускает фоновый поток (если enabled)
+void start();
+
+// Синхронно дописывает всё накопленное (при выходе из процесса). Сброс, который trantor
+// запрашивает после строк ERROR и FATAL, только будит фоновый поток
+void flush();
+
+// Текущий уровень логирования строкой (TRACE, DEBUG, INFO, WARN, ERROR) и его смена.
+// false — неизвестный уровень
+std::string logLevel();
+bool setLogLevel(const std::string &level);
+
+}
@@ -0,0 +1,159 @@
+#pragma once
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <drogon/utils/coroutine.h>
+#include <drogon/orm/DbClient.h>
+#include <drogon/orm/CoroMapper.h>
+
+// Комбинаторы для drogon::Task: запуск независимых запросов одновременно.
+// execSqlCoro и CoroMapper возвращают не Task, а одноразовые awaiter-ы, поэтому
+// для when_all запросы оборачиваются в query()/findByPrimaryKey(): аргументы
+// копируются в кадр корутины, и запрос уходит в пул при её запуске.
+namespace coro {
+
+namespace detail {
+
+template <typename... Ts>
+struct WhenAllState {
+    std::tuple<std::optional<Ts>...> results;
+    std::exception_ptr error;
+    std::atomic<bool> failed{false};
+    // +1 — ссылка самого ожидающего корутина, снимается в await_suspend
+    std::atomic<std::size_t> remaining{sizeof...(Ts) + 1};
+    std::coroutine_handle<> waiter;
+
+    void fail(std::exception_ptr e) {
+        if (!failed.exchange(true)) {
+            error = std::move(e);
+        }
+    }
+
+    void arrive() {
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            waiter.resume();
+        }
+    }
+};
+
+template <typename State>
+struct WhenAllAwaiter {
+    std::shared_ptr<State> state;
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> h) noexcept {
+        state->waiter = h;
+        // Если все задачи уже завершились, продолжаем без приостановки
+        return state->remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+
+    void await_resume() const noexcept {}
+};
+
+// AsyncTask стартует сразу: запрос уходит в пул до первого co_await
+template <std::size_t I, typename State, typename T>
+drogon::AsyncTask runOne(std::shared_ptr<State> state, drogon::Task<T> task) {
+    try {
+        std::get<I>(state->results).emplace(co_await std::move(task));
+    } catch (...) {
+        state->fail(std::current_exception());
+    }
+    state->arrive();
+}
+
+}
+
+// Запускает все задачи одновременно и ждёт завершения каждой.
+// Если какая-то задача упала, после завершения остальных пробрасывается первое исключение.
+template <typename... Ts>
+drogon::Task<std::tuple<Ts...>> when_all(drogon::Task<Ts>... tasks) {
+    using State = detail::WhenAllState<Ts...>;
+    auto state = std::make_shared<State>();
+
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (detail::runOne<I>(state, std::move(tasks)), ...);
+    }(std::index_sequence_for<Ts...>{});
+
+    co_await detail::WhenAllAwaiter<State>{state};
+
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+    co_return [&]<std::size_t... I>(std::index_sequence<I...>) {
+        return std::tuple<Ts...>(std::move(*std::get<I>(state->results))...);
+    }(std::index_sequence_for<Ts...>{});
+}
+
+// Вариант для заранее неизвестного числа однотипных задач; порядок результатов сохраняется
+template <typename T>
+drogon::Task<std::vector<T>> when_all(std::vector<drogon::Task<T>> tasks) {
+    struct State {
+        std::vector<std::optional<T>> results;
+        std::exception_ptr error;
+        std::atomic<bool> failed{false};
+        std::atomic<std::size_t> remaining;
+        std::coroutine_handle<> waiter;
+
+        explicit State(std::size_t n) : results(n), remaining(n + 1) {}
+
+        void fail(std::exception_ptr e) {
+            if (!failed.exchange(true)) {
+                error = std::move(e);
+            }
+        }
+
+        void arrive() {
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                waiter.resume();
+            }
+        }
+    };
+    auto state = std::make_shared<State>(tasks.size());
+
+    struct Runner {
+        static drogon::AsyncTask run(std::shared_ptr<State> state, std::size_t i, drogon::Task<T> task) {
+            try {
+                state->results[i].emplace(co_await std::move(task));
+            } catch (...) {
+                state->fail(std::current_exception());
+            }
+            state->arrive();
+        }
+    };
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        Runner::run(state, i, std::move(tasks[i]));
+    }
+
+    co_await detail::WhenAllAwaiter<State>{state};
+
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+    std::vector<T> results;
+    results.reserve(state->results.size());
+    for (auto &r : state->results) {
+        results.push_back(std::move(*r));
+    }
+    co_return results;
+}
+
+// SQL-запрос в виде Task для when_all
+template <typename... Args>
+drogon::Task<drogon::orm::Result> query(drogon::orm::DbClientPtr db, std::string sql, Args... args) {
+    co_return co_await db->execSqlCoro(sql, args...);
+}
+
+// CoroMapper::findByPrimaryKey в виде Task; UnexpectedRows пробрасывается как есть
+template <typename Model>
+drogon::Task<Model> findByPrimaryKey(drogon::orm::DbClientPtr db, typename Model::PrimaryKeyType id) {
+    drogon::orm::CoroMapper<Model> mapper(db);
+    co_return co_await mapper.findByPrimaryKey(id);
+}
+
+}
@@ -0,0 +1,98 @@
+#include "Deadline.h"
+#include <drogon/HttpAppFramework.h>
+#include <trantor/utils/Date.h>
+#include "Metrics.h"
+
+static deadline::Options g_options;
+
+static const std::string kDeadlineKey = "deadline";
+
+const deadline::Options &deadline::loadOptions() {
+    const auto &cfg = drogon::app().getCustomConfig()["deadlines"];
+    if (cfg.isObject()) {
+        g_options.defaultMs = cfg.get("default_ms", 0.0).asDouble();
+        g_options.cancelOnDisconnect = cfg.get("cancel_on_disconnect", true).asBool();
+        const auto &routes = cfg["routes"];
+        if (routes.isObject()) {
+            for (const auto &route : routes.getMemberNames()) {
+                g_options.routeMs[route] = routes[route].asDouble();
+            }
+        }
+    }
+    return g_options;
+}
+
+const deadline::Options &deadline::options() {
+    return g_options;
+}
+
+deadline::Deadline::Deadline(const drogon::HttpRequestPtr &req, double ms)
+    : atUs_(req->creationDate().microSecondsSinceEpoch() + static_cast<int64_t>(ms * 1000)), request_(req) {
+}
+
+const char *deadline::Deadline::cancelReason(bool write) {
+    if (write) {
+        writing_.store(true, std::memory_order_relaxed);
+    }
+    if (writing_.load(std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    if (remainingMs() <= 0) {
+        expired_.store(true, std::memory_order_relaxed);
+        return "deadline";
+    }
+    if (g_options.cancelOnDisconnect) {
+        auto req = request_.lock();
+        if (req && !req->connected()) {
+            return "disconnected";
+        }
+    }
+    return nullptr;
+}
+
+double deadline::Deadline::remainingMs() const {
+    return static_cast<double>(atUs_ - trantor::Date::now().microSecondsSinceEpoch()) / 1000.0;
+}
+
+std::shared_ptr<deadline::Deadline> deadline::requestDeadline(const drogon::HttpRequestPtr &req) {
+    const auto &attrs = req->attributes();
+    if (!attrs->find(kDeadlineKey)) {
+        return nullptr;
+    }
+    return attrs->get<std::shared_ptr<Deadline>>(kDeadlineKey);
+}
+
+void deadline::beginRequest(const drogon::HttpRequestPtr &req) {
+    double ms = g_options.defaultMs;
+    if (!g_options.routeMs.empty()) {
+        std::string route(req->matchedPathPattern());
+        auto it = g_options.routeMs.find(std::string(req->methodString()) + " " + route);
+        if (it == g_options.routeMs.end()) {
+            it = g_options.routeMs.find(route);
+        }
+        if (it != g_options.routeMs.end()) {
+            ms = it->second;
+        }
+    }
+    if (ms > 0) {
+        req->attributes()->insert(kDeadlineKey, std::make_shared<Deadline>(req, ms));
+    }
+}
+
+static metrics::Counter &expiredCounter() {
+    static metrics::Counter c("fm_http_deadline_exceeded_total",
+                              "Requests answered with 504 because a DB statement was skipped after the deadline",
+                              {"route"});
+    return c;
+}
+
+void deadline::finishRequest(const drogon::HttpRequestPtr &req, const drogon::HttpResponsePtr &resp) {
+    auto deadline = requestDeadline(req);
+    if (!deadline || !deadline->expired() || static_cast<int>(resp->statusCode()) < 500) {
+        return;
+    }
+    std::string route(req->matchedPathPattern());
+    expiredCounter().add({route.empty() ? "unmatched" : route});
+    resp->setStatusCode(drogon::k504GatewayTimeout);
+    resp->setBody("Request deadline exceeded");
+}
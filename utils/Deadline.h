@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <drogon/HttpRequest.h>
+#include <drogon/HttpResponse.h>
+
+// Срок выполнения запроса: к этому моменту ответ клиенту уже не нужен. Срок задаётся
+// custom_config.deadlines — общий и по маршрутам — и отсчитывается от получения запроса.
+// Каждый запрос к БД через db::getDbClient(req) проверяет срок и соединение клиента:
+// если срок прошёл или клиент отключился, запрос к БД не отправляется, а обработчик
+// получает ошибку и заканчивает работу. Серверный предел — statement_timeout соединений
+// (connect_options в db_clients).
+namespace deadline {
+
+struct Options {
+    // Срок по умолчанию, мс; 0 — без срока
+    double defaultMs = 0;
+    // Сроки по маршрутам; ключ — шаблон пути, как метка route в /metrics, с методом
+    // ("PUT /transactions/{transactionId}") или без него; 0 — без срока
+    std::unordered_map<std::string, double> routeMs;
+    // Не выполнять запросы к БД после отключения клиента
+    bool cancelOnDisconnect = true;
+};
+
+// custom_config.deadlines из config.json. Вызывать после loadConfigFile
+const Options &loadOptions();
+
+const Options &options();
+
+class Deadline {
+public:
+    Deadline(const drogon::HttpRequestPtr &req, double ms);
+
+    // Можно ли отправить ещё один запрос к БД: nullptr — можно, иначе причина отказа
+    // ("deadline" или "disconnected"). После первого изменяющего запроса (write) отказов
+    // больше нет: начатая запись доводится до конца, а не откатывается (db/Transaction.h)
+    // ради ответа, который клиент всё равно может не дождаться
+    const char *cancelReason(bool write);
+
+    // Сколько осталось до срока, мс (отрицательное — срок прошёл)
+    double remainingMs() const;
+
+    // Запрос к БД был отменён по сроку: ответ обработчика заменяется на 504
+    bool expired() const {
+        return expired_.load(std::memory_order_relaxed);
+    }
+
+private:
+    int64_t atUs_;
+    // Слабая ссылка: сам Deadline хранится в атрибутах запроса
+    std::weak_ptr<drogon::HttpRequest> request_;
+    std::atomic<bool> writing_{false};
+    std::atomic<bool> expired_{false};
+};
+
+// Срок запроса или nullptr, если он не задан
+std::shared_ptr<Deadline> requestDeadline(const drogon::HttpRequestPtr &req);
+
+// Pre-handling advice: назначает срок по маршруту запроса
+void beginRequest(const drogon::HttpRequestPtr &req);
+
+// Post-handling advice: ошибка обработчика из-за истёкшего срока становится 504
+void finishRequest(const drogon::HttpRequestPtr &req, const drogon::HttpResponsePtr &resp);
+
+}
@@ -4,6 +4,8 @@
 #include "JwtUtils.h"
 #include <jwt-cpp/jwt.h>
 #include <drogon/HttpAppFramework.h>
+#include "LoopCache.h"
+#include "Profiling.h"
 
 // ⚠️ Замените на значение из config.json в продакшене!
 static const std::string JWT_SECRET = "your_strong_secret_key_123!_CHANGE_ME";
@@ -22,6 +24,7 @@ std::string jwt_utils::createToken(int64_t user_id, const std::string &email) {
 
 std::optional<int64_t> jwt_utils::getUserIdFromRequest(const drogon::HttpRequestPtr &req) {
     if (!req) return std::nullopt;
+    profiling::Span span(req, "auth");
 
     // 1) Authorization: Bearer <token> (проверяем оба варианта регистра)
     std::string token;
@@ -46,6 +49,14 @@ std::optional<int64_t> jwt_utils::getUserIdFromRequest(const drogon::HttpRequest
 
     if (token.empty()) return std::nullopt;
 
+    // Уже проверенные токены: разбор и HMAC на каждый запрос — основная работа CPU
+    // на лёгких эндпоинтах. Шард свой у каждого IO-потока, запись живёт до exp токена.
+    using TokenCache = cache::LoopCache<std::string, int64_t>;
+    static TokenCache verified(4096, std::chrono::minutes(10));
+    if (const auto *userId = verified.find(token)) {
+        return *userId;
+    }
+
     try {
         auto decoded = jwt::decode(token);
         auto verifier = jwt::verify()
@@ -53,7 +64,14 @@ std::optional<int64_t> jwt_utils::getUserIdFromRequest(const drogon::HttpRequest
             .with_issuer("financial_manager");
         verifier.verify(decoded);
 
-        return std::stoll(decoded.get_payload_claim("user_id").as_string());
+        int64_t userId = std::stoll(decoded.get_payload_claim("user_id").as_string());
+        if (decoded.has_expires_at()) {
+            auto left = decoded.get_expires_at() - std::chrono::system_clock::now();
+            verified.putUntil(token, userId,
+                              TokenCache::Clock::now() +
+                                  std::chrono::duration_cast<TokenCache::Clock::duration>(left));
+        }
+        return userId;
     } catch (...) {
         return std::nullopt;
     }
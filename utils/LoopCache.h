@@ -0,0 +1,92 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <drogon/HttpAppFramework.h>
+#include <drogon/IOThreadStorage.h>
+
+namespace cache {
+
+// Кеш, разделённый по IO-потокам: у каждого event loop своя хеш-таблица, поэтому
+// чтение и запись с горячего пути не берут блокировок и не делят строки кеша между ядрами.
+// Запись действительна до expires и пока её tag совпадает с тем, что передал читатель
+// (так снаружи инвалидируются все шарды сразу — см. db::invalidateLists).
+// При переполнении шард очищается целиком: промах стоит одного запроса к БД.
+// Объект создаётся после загрузки конфига (IOThreadStorage знает число потоков),
+// обычно как static внутри функции.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LoopCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    LoopCache(std::size_t maxEntriesPerLoop, Clock::duration ttl)
+        : maxEntries_(maxEntriesPerLoop), ttl_(ttl) {}
+
+    // nullptr, если записи нет, она устарела или tag не совпал
+    const Value *find(const Key &key, uint64_t tag = 0) const {
+        auto *shard = localShard();
+        if (!shard) {
+            return nullptr;
+        }
+        auto it = shard->find(key);
+        if (it == shard->end()) {
+            return nullptr;
+        }
+        if (it->second.tag != tag || it->second.expires <= Clock::now()) {
+            shard->erase(it);
+            return nullptr;
+        }
+        return &it->second.value;
+    }
+
+    void put(Key key, Value value, uint64_t tag = 0) {
+        putUntil(std::move(key), std::move(value), Clock::now() + ttl_, tag);
+    }
+
+    // Срок жизни не больше ttl, даже если expires дальше
+    void putUntil(Key key, Value value, Clock::time_point expires, uint64_t tag = 0) {
+        auto *shard = localShard();
+        if (!shard) {
+            return;
+        }
+        if (shard->size() >= maxEntries_) {
+            shard->clear();
+        }
+        auto limit = Clock::now() + ttl_;
+        shard->insert_or_assign(std::move(key),
+                               Entry{std::move(value), expires < limit ? expires : limit, tag});
+    }
+
+    void erase(const Key &key) {
+        if (auto *shard = localShard()) {
+            shard->erase(key);
+        }
+    }
+
+private:
+    struct Entry {
+        Value value;
+        Clock::time_point expires;
+        uint64_t tag;
+    };
+
+    using Shard = std::unordered_map<Key, Entry, Hash>;
+
+    // Шард IO-потока (или главного потока приложения). Вне них — в тестах, бенчмарках,
+    // чужих пулах потоков — шарда нет, и кеш просто не используется
+    Shard *localShard() const {
+        if (drogon::app().getCurrentThreadIndex() > drogon::app().getThreadNum()) {
+            return nullptr;
+        }
+        return &shards_.getThreadData();
+    }
+
+    std::size_t maxEntries_;
+    Clock::duration ttl_;
+    mutable drogon::IOThreadStorage<Shard> shards_;
+};
+
+}
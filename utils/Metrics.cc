@@ -0,0 +1,245 @@
+#include "Metrics.h"
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <trantor/utils/Date.h>
+
+using namespace metrics;
+
+static std::mutex &registryMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+static std::vector<const Family *> &registry() {
+    static std::vector<const Family *> families;
+    return families;
+}
+
+static void appendEscaped(std::string &out, const std::string &value) {
+    for (char c : value) {
+        switch (c) {
+            case '\\': out += "\\\\"; break;
+            case '"': out += "\\\""; break;
+            case '\n': out += "\\n"; break;
+            default: out += c;
+        }
+    }
+}
+
+static std::string formatNumber(double v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.17g", v);
+    return buf;
+}
+
+Family::Family(std::string name, std::string help, std::vector<std::string> labelNames, std::vector<double> buckets)
+    : name_(std::move(name)), help_(std::move(help)), labelNames_(std::move(labelNames)), buckets_(std::move(buckets)) {
+    std::sort(buckets_.begin(), buckets_.end());
+    std::lock_guard lock(registryMutex());
+    registry().push_back(this);
+}
+
+Family::Series &Family::series(const std::vector<std::string> &labelValues) {
+    // Ключ — готовый текст меток: route="/x",method="GET"
+    std::string key;
+    for (size_t i = 0; i < labelNames_.size() && i < labelValues.size(); ++i) {
+        if (i > 0) {
+            key += ',';
+        }
+        key += labelNames_[i];
+        key += "=\"";
+        appendEscaped(key, labelValues[i]);
+        key += '"';
+    }
+
+    thread_local std::unordered_map<const Family *, std::unordered_map<std::string, Series *>> cache;
+    auto &local = cache[this];
+    if (auto it = local.find(key); it != local.end()) {
+        return *it->second;
+    }
+    std::lock_guard lock(mutex_);
+    auto &slot = series_[key];
+    if (!slot) {
+        slot = std::make_unique<Series>(buckets_.size());
+    }
+    local.emplace(std::move(key), slot.get());
+    return *slot;
+}
+
+void Family::render(std::string &out) const {
+    const bool histogram = !buckets_.empty();
+    out += "# HELP " + name_ + " " + help_ + "\n";
+    out += "# TYPE " + name_ + " " + type() + "\n";
+    std::lock_guard lock(mutex_);
+    for (const auto &[labels, s] : series_) {
+        const std::string sep = labels.empty() ? "" : ",";
+        if (!histogram) {
+            out += name_ + "{" + labels + "} " + formatNumber(s->sum.load(std::memory_order_relaxed)) + "\n";
+            continue;
+        }
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < buckets_.size(); ++i) {
+            cumulative += s->counts[i].load(std::memory_order_relaxed);
+            out += name_ + "_bucket{" + labels + sep + "le=\"" + formatNumber(buckets_[i]) + "\"} " +
+                   std::to_string(cumulative) + "\n";
+        }
+        const auto count = s->count.load(std::memory_order_relaxed);
+        out += name_ + "_bucket{" + labels + sep + "le=\"+Inf\"} " + std::to_string(count) + "\n";
+        out += name_ + "_sum{" + labels + "} " + formatNumber(s->sum.load(std::memory_order_relaxed)) + "\n";
+        out += name_ + "_count{" + labels + "} " + std::to_string(count) + "\n";
+    }
+}
+
+void Histogram::observe(const std::vector<std::string> &labelValues, double value) {
+    auto &s = series(labelValues);
+    const auto &b = buckets();
+    auto it = std::lower_bound(b.begin(), b.end(), value);
+    if (it != b.end()) {
+        s.counts[static_cast<size_t>(it - b.begin())].fetch_add(1, std::memory_order_relaxed);
+    }
+    s.count.fetch_add(1, std::memory_order_relaxed);
+    s.sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+void Counter::add(const std::vector<std::string> &labelValues, double value) {
+    auto &s = series(labelValues);
+    s.count.fetch_add(1, std::memory_order_relaxed);
+    s.sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+void Gauge::add(const std::vector<std::string> &labelValues, double delta) {
+    series(labelValues).sum.fetch_add(delta, std::memory_order_relaxed);
+}
+
+std::string metrics::render() {
+    std::string out;
+    std::lock_guard lock(registryMutex());
+    for (const auto *family : registry()) {
+        family->render(out);
+    }
+    return out;
+}
+
+static const std::string kDbStatsKey = "metrics.db_stats";
+
+std::shared_ptr<RequestDbStats> metrics::requestDbStats(const drogon::HttpRequestPtr &req) {
+    auto &attrs = req->attributes();
+    if (attrs->find(kDbStatsKey)) {
+        return attrs->get<std::shared_ptr<RequestDbStats>>(kDbStatsKey);
+    }
+    auto stats = std::make_shared<RequestDbStats>();
+    attrs->insert(kDbStatsKey, stats);
+    return stats;
+}
+
+void metrics::observeRequest(const drogon::HttpRequestPtr &req, const drogon::HttpResponsePtr &resp) {
+    static Histogram duration("fm_http_request_duration_seconds",
+                              "Time from request parsing to the response, by route",
+                              {"route", "method", "status"},
+                              {0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5});
+    static Histogram size("fm_http_response_size_bytes",
+                          "Response body size, by route",
+                          {"route", "method"},
+                          {256, 1024, 4096, 16384, 65536, 262144, 1048576});
+    static Histogram queries("fm_http_db_queries_per_request",
+                             "Database round trips made while handling one request",
+                             {"route", "method"},
+                             {0, 1, 2, 3, 4, 6, 8, 12, 16, 32});
+    static Histogram rows("fm_http_db_rows_per_request",
+                          "Rows returned by the database while handling one request",
+                          {"route", "method"},
+                          {0, 1, 10, 100, 1000, 10000, 100000});
+
+    std::string route(req->matchedPathPattern());
+    if (route.empty()) {
+        route = "unmatched";
+    }
+    std::string method(req->methodString());
+    const double seconds =
+        static_cast<double>(trantor::Date::now().microSecondsSinceEpoch() - req->creationDate().microSecondsSinceEpoch()) / 1e6;
+
+    duration.observe({route, method, std::to_string(static_cast<int>(resp->statusCode()))}, seconds);
+    size.observe({route, method}, static_cast<double>(resp->body().size()));
+
+    RequestDbStats stats;
+    if (req->attributes()->find(kDbStatsKey)) {
+        stats = *req->attributes()->get<std::shared_ptr<RequestDbStats>>(kDbStatsKey);
+    }
+    queries.observe({route, method}, stats.queries);
+    rows.observe({route, method}, static_cast<double>(stats.rows));
+}
+
+std::string metrics::mergeWorkers(const std::vector<std::string> &outputs) {
+    struct MergedFamily {
+        std::string help;
+        std::string type;
+        std::vector<std::string> samples;
+    };
+    std::vector<std::string> order;
+    std::unordered_map<std::string, MergedFamily> families;
+    auto family = [&](const std::string &name) -> MergedFamily & {
+        auto it = families.find(name);
+        if (it == families.end()) {
+            order.push_back(name);
+            it = families.emplace(name, MergedFamily{}).first;
+        }
+        return it->second;
+    };
+
+    for (size_t worker = 0; worker < outputs.size(); ++worker) {
+        const std::string label = "worker=\"" + std::to_string(worker) + "\"";
+        std::istringstream in(outputs[worker]);
+        std::string line;
+        std::string current;
+        while (std::getline(in, line)) {
+            if (line.empty()) {
+                continue;
+            }
+            if (line.rfind("# HELP ", 0) == 0 || line.rfind("# TYPE ", 0) == 0) {
+                auto nameEnd = line.find(' ', 7);
+                current = line.substr(7, nameEnd == std::string::npos ? std::string::npos : nameEnd - 7);
+                auto &f = family(current);
+                auto &slot = line[2] == 'H' ? f.help : f.type;
+                if (slot.empty()) {
+                    slot = line;
+                }
+                continue;
+            }
+            if (line[0] == '#') {
+                continue;
+            }
+            auto nameEnd = line.find_first_of("{ ");
+            if (nameEnd == std::string::npos) {
+                continue;
+            }
+            std::string name = line.substr(0, nameEnd);
+            // _bucket/_sum/_count гистограмм относятся к семейству из последнего TYPE
+            bool ofCurrent = name == current || name == current + "_bucket" ||
+                             name == current + "_sum" || name == current + "_count";
+            auto &f = family(ofCurrent ? current : name);
+            if (line[nameEnd] == '{') {
+                bool noLabels = nameEnd + 1 < line.size() && line[nameEnd + 1] == '}';
+                f.samples.push_back(name + "{" + label + (noLabels ? "" : ",") + line.substr(nameEnd + 1));
+            } else {
+                f.samples.push_back(name + "{" + label + "}" + line.substr(nameEnd));
+            }
+        }
+    }
+
+    std::string out;
+    for (const auto &name : order) {
+        const auto &f = families[name];
+        for (const auto *l : {&f.help, &f.type}) {
+            if (!l->empty()) {
+                out += *l;
+                out += '\n';
+            }
+        }
+        for (const auto &s : f.samples) {
+            out += s;
+            out += '\n';
+        }
+    }
+    return out;
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <drogon/HttpRequest.h>
+#include <drogon/HttpResponse.h>
+
+// Метрики приложения в формате Prometheus: гистограммы и счётчики с метками.
+// Значения — атомики, общие для всех IO-потоков; поиск серии по меткам идёт через
+// кеш потока, так что на горячем пути нет общей блокировки.
+// Отдаются на /metrics/local/app (см. MetricsController) рядом с метриками PromExporter-а.
+namespace metrics {
+
+class Family {
+public:
+    Family(std::string name, std::string help, std::vector<std::string> labelNames, std::vector<double> buckets);
+    virtual ~Family() = default;
+
+    const std::string &name() const {
+        return name_;
+    }
+    void render(std::string &out) const;
+    // Тип для строки # TYPE
+    virtual const char *type() const = 0;
+
+protected:
+    struct Series {
+        explicit Series(size_t buckets) : counts(buckets) {}
+        std::vector<std::atomic<uint64_t>> counts;  // по границам, не накопительно
+        std::atomic<uint64_t> count{0};
+        std::atomic<double> sum{0};
+    };
+
+    // labelValues — в порядке labelNames
+    Series &series(const std::vector<std::string> &labelValues);
+    const std::vector<double> &buckets() const {
+        return buckets_;
+    }
+
+private:
+    std::string name_;
+    std::string help_;
+    std::vector<std::string> labelNames_;
+    std::vector<double> buckets_;  // пусто — счётчик
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::unique_ptr<Series>> series_;
+};
+
+class Histogram : public Family {
+public:
+    Histogram(std::string name, std::string help, std::vector<std::string> labelNames, std::vector<double> buckets)
+        : Family(std::move(name), std::move(help), std::move(labelNames), std::move(buckets)) {}
+
+    void observe(const std::vector<std::string> &labelValues, double value);
+    const char *type() const override {
+        return "histogram";
+    }
+};
+
+class Counter : public Family {
+public:
+    Counter(std::string name, std::string help, std::vector<std::string> labelNames)
+        : Family(std::move(name), std::move(help), std::move(labelNames), {}) {}
+
+    void add(const std::vector<std::string> &labelValues, double value = 1);
+    const char *type() const override {
+        return "counter";
+    }
+};
+
+// Текущее значение, которое может и расти, и уменьшаться
+class Gauge : public Family {
+public:
+    Gauge(std::string name, std::string help, std::vector<std::string> labelNames)
+        : Family(std::move(name), std::move(help), std::move(labelNames), {}) {}
+
+    void add(const std::vector<std::string> &labelValues, double delta);
+    const char *type() const override {
+        return "gauge";
+    }
+};
+
+// Все созданные семейства метрик текстом для Prometheus
+std::string render();
+
+// Склеивает выводы рабочих процессов (outputs[i] — процесс i) в формате Prometheus:
+// сэмплы одного семейства идут подряд под одной парой HELP/TYPE, к каждому добавляется
+// метка worker="i". Для GET /metrics в prefork-режиме
+std::string mergeWorkers(const std::vector<std::string> &outputs);
+
+// Запросы к БД, сделанные при обработке HTTP-запроса. Заполняется db::MeteredDbClient;
+// обработчик и колбэки клиента выполняются в одном IO-потоке, поэтому без атомиков
+struct RequestDbStats {
+    uint32_t queries = 0;
+    uint64_t rows = 0;
+};
+
+// Счётчики запроса (создаются при первом обращении)
+std::shared_ptr<RequestDbStats> requestDbStats(const drogon::HttpRequestPtr &req);
+
+// Время обработки и размер ответа по маршрутам, число запросов к БД и строк на HTTP-запрос.
+// Маршрут — шаблон пути из контроллера (/transactions/{transactionId}), а не сам путь
+void observeRequest(const drogon::HttpRequestPtr &req, const drogon::HttpResponsePtr &resp);
+
+}
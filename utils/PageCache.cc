@@ -0,0 +1,74 @@
+#include "PageCache.h"
+#include <drogon/utils/Utilities.h>
+#include "Profiling.h"
+
+namespace pages {
+
+static drogon::HttpResponsePtr makeResponse(drogon::HttpStatusCode code,
+                                            std::string body,
+                                            const std::string &etag,
+                                            bool gzip,
+                                            const CachedPage::Headers &headers) {
+    auto resp = drogon::HttpResponse::newHttpResponse();
+    resp->setStatusCode(code);
+    resp->setContentTypeCode(drogon::CT_TEXT_HTML);
+    resp->setBody(std::move(body));
+    resp->addHeader("ETag", etag);
+    resp->addHeader("Vary", "Accept-Encoding");
+    // Страница ссылается на ассеты с хешем в имени, поэтому её саму браузер
+    // перепроверяет по ETag при каждом заходе
+    resp->addHeader("Cache-Control", "no-cache");
+    if (gzip) {
+        resp->addHeader("Content-Encoding", "gzip");
+    }
+    for (const auto &[name, value] : headers) {
+        resp->addHeader(name, value);
+    }
+    return resp;
+}
+
+CachedPage::CachedPage(Renderer render, Headers headers)
+    : render_(std::move(render)), headers_(std::move(headers)) {}
+
+CachedPage::Variant CachedPage::build(bool isFamily) const {
+    Variant v;
+    auto body = render_(isFamily);
+    auto hash = drogon::utils::getMd5(body);
+    v.etag = "\"" + hash + "\"";
+    v.gzipEtag = "\"" + hash + "-gz\"";
+
+    auto compressed = drogon::utils::gzipCompress(body.data(), body.size());
+    v.plain = makeResponse(drogon::k200OK, std::move(body), v.etag, false, headers_);
+    if (!compressed.empty()) {
+        v.gzip = makeResponse(drogon::k200OK, std::move(compressed), v.gzipEtag, true, headers_);
+    }
+    v.notModified = makeResponse(drogon::k304NotModified, {}, v.etag, false, headers_);
+    v.gzipNotModified = makeResponse(drogon::k304NotModified, {}, v.gzipEtag, false, headers_);
+    return v;
+}
+
+const drogon::HttpResponsePtr &CachedPage::get(const drogon::HttpRequestPtr &req, bool isFamily) const {
+    auto &slot = (*variants_)[isFamily ? 1 : 0];
+    if (!slot) {
+        slot = build(isFamily);
+    }
+    const auto &v = *slot;
+    profiling::markSharedResponse(req);
+
+    const auto &ifNoneMatch = req->getHeader("if-none-match");
+    if (!ifNoneMatch.empty()) {
+        if (ifNoneMatch.find(v.gzipEtag) != std::string::npos) {
+            return v.gzipNotModified;
+        }
+        if (ifNoneMatch.find(v.etag) != std::string::npos) {
+            return v.notModified;
+        }
+    }
+
+    if (v.gzip && req->getHeader("accept-encoding").find("gzip") != std::string::npos) {
+        return v.gzip;
+    }
+    return v.plain;
+}
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <array>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include <drogon/HttpRequest.h>
+#include <drogon/HttpResponse.h>
+#include <drogon/IOThreadStorage.h>
+
+namespace pages {
+
+// Готовые ответы для страниц, содержимое которых зависит только от флага family.
+// Тело рендерится один раз на IO-поток при первом запросе, gzip-вариант сжимается
+// заранее, ETag — md5 тела. Один и тот же HttpResponsePtr отдаётся всем запросам
+// этого потока, поэтому менять объект ответа после get() нельзя.
+class CachedPage {
+public:
+    using Renderer = std::function<std::string(bool isFamily)>;
+
+    using Headers = std::vector<std::pair<std::string, std::string>>;
+
+    // headers — дополнительные заголовки, одинаковые для всех ответов страницы
+    explicit CachedPage(Renderer render, Headers headers = {});
+
+    const drogon::HttpResponsePtr &get(const drogon::HttpRequestPtr &req, bool isFamily = false) const;
+
+private:
+    struct Variant {
+        std::string etag;
+        std::string gzipEtag;
+        drogon::HttpResponsePtr plain;
+        drogon::HttpResponsePtr gzip;
+        drogon::HttpResponsePtr notModified;
+        drogon::HttpResponsePtr gzipNotModified;
+    };
+
+    Variant build(bool isFamily) const;
+
+    Renderer render_;
+    Headers headers_;
+    mutable drogon::IOThreadStorage<std::array<std::optional<Variant>, 2>> variants_;
+};
+
+}
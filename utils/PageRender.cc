@@ -0,0 +1,677 @@
+#include "PageRender.h"
+#include <drogon/HttpViewData.h>
+#include <map>
+#include <optional>
+#include "PageShell.h"
+#include "StaticAssets.h"
+
+namespace pages {
+
+// "2024-05-01 13:45:00" -> "01.05.2024, 13:45", как toLocaleString("ru-RU") на клиенте
+static std::string formatDate(const Json::Value &v) {
+    auto s = v.asString();
+    if (s.size() < 16) {
+        return s.empty() ? "-" : s;
+    }
+    return s.substr(8, 2) + "." + s.substr(5, 2) + "." + s.substr(0, 4) + ", " + s.substr(11, 5);
+}
+
+static std::string esc(const std::string &s) {
+    return drogon::HttpViewData::htmlTranslate(s);
+}
+
+// Справочник id -> объект для подписей в таблицах (счета, категории)
+static std::map<int64_t, const Json::Value *> indexById(const Json::Value &arr) {
+    std::map<int64_t, const Json::Value *> index;
+    for (const auto &item : arr) {
+        index[item["id"].asInt64()] = &item;
+    }
+    return index;
+}
+
+static std::string actionButtons(const char *editFn, const char *deleteFn, const Json::Value &id) {
+    auto idStr = id.asString();
+    return std::string("<td style=\"padding: 0.5em; display:flex; gap:6px; flex-wrap:wrap;\">") +
+        "<button onclick=\"" + editFn + "(" + idStr + ")\" style=\"padding:4px 8px;\">Редактировать</button>" +
+        "<button onclick=\"" + deleteFn + "(" + idStr + ")\" style=\"padding:4px 8px; background:#dc3545; color:#fff; border:none;\">Удалить</button>" +
+        "</td>";
+}
+
+// Блок списка: "Загрузка...", сообщение о пустом списке и таблица.
+// Если строки отрендерены на сервере, сразу показывается таблица или сообщение о пустом списке.
+static std::string listSection(const std::string &name, const std::string &emptyText,
+                               std::initializer_list<const char *> columns,
+                               const std::optional<std::string> &rows) {
+    bool rendered = rows.has_value();
+    bool empty = rendered && rows->empty();
+    std::string html;
+    html += rendered ? "        <p id=\"loadingMessage\" style=\"display: none;\">Загрузка...</p>\n"
+                     : "        <p id=\"loadingMessage\">Загрузка...</p>\n";
+    html += std::string("        <div id=\"emptyMessage\" style=\"display: ") + (empty ? "block" : "none") + ";\">\n";
+    html += "            <p style=\"color: #666; font-style: italic;\">" + emptyText + "</p>\n";
+    html += "        </div>\n";
+    html += "        <table id=\"" + name + "Table\" style=\"display: " + (rendered && !empty ? "table" : "none") +
+            "; width: 100%; border-collapse: collapse; margin-top: 1em;\">\n";
+    html += "            <thead>\n                <tr style=\"background-color: #f0f0f0;\">\n";
+    for (const char *col : columns) {
+        html += "                    <th style=\"padding: 0.5em; text-align: left; border-bottom: 2px solid #ddd;\">";
+        html += col;
+        html += "</th>\n";
+    }
+    html += "                </tr>\n            </thead>\n";
+    html += "            <tbody id=\"" + name + "TableBody\">\n";
+    if (rendered) {
+        html += *rows;
+    }
+    html += "            </tbody>\n        </table>\n";
+    return html;
+}
+
+// Строки таблиц повторяют разметку, которую строят скрипты страниц
+
+static std::string categoryRows(const Json::Value &data) {
+    std::string html;
+    for (const auto &cat : data["categories"]) {
+        bool income = cat["type"].asString() == "income";
+        html += "<tr style=\"border-bottom: 1px solid #eee;\">";
+        html += "<td style=\"padding: 0.5em; word-break: break-word; white-space: normal;\">" + esc(cat["name"].asString()) + "</td>";
+        html += std::string("<td style=\"padding: 0.5em; color: ") + (income ? "#28a745" : "#dc3545") +
+                "; font-weight: bold;\">" + (income ? "Доход" : "Расход") + "</td>";
+        html += std::string("<td style=\"padding: 0.5em;\">") + (cat["is_family"].asBool() ? "Семейная" : "Личная") + "</td>";
+        html += std::string("<td style=\"padding: 0.5em; display: flex; gap: 6px; flex-wrap: wrap;\">") +
+                "<button onclick=\"startEditCategory(" + cat["id"].asString() + ")\" style=\"padding: 4px 8px;\">Редактировать</button>" +
+                "<button onclick=\"deleteCategory(" + cat["id"].asString() + ")\" style=\"padding: 4px 8px; background:#dc3545; color:#fff; border:none;\">Удалить</button>" +
+                "</td>";
+        html += "</tr>\n";
+    }
+    return html;
+}
+
+static std::string transactionRows(const Json::Value &data) {
+    auto accounts = indexById(data["accounts"]);
+    auto categories = indexById(data["categories"]);
+    std::string html;
+    for (const auto &tr : data["transactions"]) {
+        bool income = tr["type"].asString() == "income";
+        const char *color = income ? "#28a745" : "#dc3545";
+        auto acc = accounts.find(tr["id_account"].asInt64());
+        std::string accountName = acc != accounts.end() ? (*acc->second)["account_name"].asString() : "Счёт недоступен";
+        std::string categoryName = "-";
+        if (!tr["id_category"].isNull()) {
+            auto cat = categories.find(tr["id_category"].asInt64());
+            if (cat != categories.end()) {
+                categoryName = (*cat->second)["name"].asString();
+            }
+        }
+        auto description = tr["description"].asString();
+        html += "<tr style=\"border-bottom: 1px solid #eee;\">";
+        html += "<td style=\"padding: 0.5em; word-break: break-word; white-space: normal;\">" + esc(accountName) + "</td>";
+        html += std::string("<td style=\"padding: 0.5em; color: ") + color + "; font-weight: bold;\">" +
+                (income ? "+" : "-") + esc(tr["amount"].asString()) + " руб.</td>";
+        html += std::string("<td style=\"padding: 0.5em; color: ") + color + "; font-weight: bold;\">" +
+                (income ? "Доход" : "Расход") + "</td>";
+        html += "<td style=\"padding: 0.5em; word-break: break-word; white-space: normal;\">" + esc(categoryName) + "</td>";
+        html += "<td style=\"padding: 0.5em; word-break: break-word; white-space: normal;\">" +
+                esc(description.empty() ? "-" : description) + "</td>";
+        html += "<td style=\"padding: 0.5em;\">" + formatDate(tr["created_at"]) + "</td>";
+        html += std::string("<td style=\"padding: 0.5em;\">") + (tr["is_family"].asBool() ? "Семейная" : "Личная") + "</td>";
+        html += actionButtons("startEditTransaction", "deleteTransaction", tr["id"]);
+        html += "</tr>\n";
+    }
+    return html;
+}
+
+static std::string transferRows(const Json::Value &data) {
+    auto accounts = indexById(data["accounts"]);
+    std::string html;
+    for (const auto &tr : data["transfers"]) {
+        auto from = accounts.find(tr["account_from"].asInt64());
+        auto to = accounts.find(tr["account_to"].asInt64());
+        std::string fromName = from != accounts.end() ? (*from->second)["account_name"].asString() : "Счёт отправителя недоступен";
+        std::string toName = to != accounts.end() ? (*to->second)["account_name"].asString() : "Счёт получателя недоступен";
+        html += "<tr style=\"border-bottom: 1px solid #eee;\">";
+        html += "<td style=\"padding: 0.5em; word-break: break-word; white-space: normal;\">" + esc(fromName) + "</td>";
+        html += "<td style=\"padding: 0.5em; word-break: break-word; white-space: normal;\">" + esc(toName) + "</td>";
+        html += "<td style=\"padding: 0.5em; font-weight: bold;\">" + esc(tr["amount"].asString()) + " руб.</td>";
+        html += "<td style=\"padding: 0.5em;\">" + formatDate(tr["created_at"]) + "</td>";
+        html += std::string("<td style=\"padding: 0.5em;\">") + (tr["is_family"].asBool() ? "Семейный" : "Личный") + "</td>";
+        html += actionButtons("startEditTransfer", "deleteTransfer", tr["id"]);
+        html += "</tr>\n";
+    }
+    return html;
+}
+
+static std::string budgetRows(const Json::Value &data) {
+    static const char *kMonthNames[] = {"Январь", "Февраль", "Март", "Апрель", "Май", "Июнь",
+                                        "Июль", "Август", "Сентябрь", "Октябрь", "Ноябрь", "Декабрь"};
+    auto categories = indexById(data["categories"]);
+    std::string html;
+    for (const auto &budget : data["budgets"]) {
+        auto cat = categories.find(budget["id_category"].asInt64());
+        std::string categoryName = cat != categories.end() ? (*cat->second)["name"].asString() : "Категория недоступна";
+        int month = budget["month"].asInt();
+        std::string monthName = (month >= 1 && month <= 12) ? kMonthNames[month - 1] : budget["month"].asString();
+        html += "<tr style=\"border-bottom: 1px solid #eee;\">";
+        html += "<td style=\"padding: 0.5em; word-break: break-word; white-space: normal;\">" + esc(categoryName) + "</td>";
+        html += "<td style=\"padding: 0.5em;\">" + monthName + "</td>";
+        html += "<td style=\"padding: 0.5em;\">" + budget["year"].asString() + "</td>";
+        html += "<td style=\"padding: 0.5em; font-weight: bold;\">" + esc(budget["limit_amount"].asString()) + " руб.</td>";
+        html += std::string("<td style=\"padding: 0.5em;\">") + (budget["is_family"].asBool() ? "Семейный" : "Личный") + "</td>";
+        html += actionButtons("startEditBudget", "deleteBudget", budget["id"]);
+        html += "</tr>\n";
+    }
+    return html;
+}
+
+std::string renderIndex(bool /*isFamily*/) {
+    std::string html = pages::head("Financial Manager", {assets::css_sakura_css});
+    html += R"(<body>
+    <h1>Financial Manager</h1>
+    <p>Добро пожаловать! Для продолжения войдите в аккаунт или зарегистрируйтесь.</p>
+    <nav>
+        <ul>
+            <li><a href="/auth/register">Регистрация</a></li>
+            <li><a href="/auth/login">Вход</a></li>
+        </ul>
+    </nav>
+</body>
+</html>
+)";
+    return html;
+}
+
+std::string renderHomePage(bool /*isFamily*/) {
+    std::string html = pages::head("Financial Manager",
+                                   {assets::css_sakura_css, assets::css_app_css, assets::css_home_css});
+    html += R"HTML(<body>
+    <h1>Выбор действия</h1>
+    <div id="loadingMessage" class="loading">Загрузка...</div>
+    <div id="contentArea"></div>
+)HTML";
+    html += pages::script(assets::js_home_js);
+    html += R"HTML(    <nav style="margin-top: 30px;">
+        <ul>
+            <li><a href="/auth/logout">Выход из аккаунта</a></li>
+        </ul>
+    </nav>
+</body>
+</html>
+)HTML";
+    
+    return html;
+}
+
+std::string renderCategoriesPage(bool isFamily, const Json::Value *initial) {
+    std::string pageTitle = isFamily ? "Семейные категории" : "Категории";
+    
+    std::string html;
+    html += pages::head(pageTitle + " - Financial Manager", {assets::css_sakura_css, assets::css_app_css});
+    html += "<body>\n    <h1>" + pageTitle + "</h1>\n";
+    
+    {
+        html += R"(    <form id="createCategoryForm">
+        <label>Название
+            <input type="text" name="name" required />
+        </label>
+        <label>Тип
+            <select name="type" required>
+                <option value="income">Доход</option>
+                <option value="expense">Расход</option>
+            </select>
+        </label>
+        <button type="submit">Создать</button>
+        <button type="button" id="cancelCategoryEdit" style="display:none; margin-left: 8px;">Отмена</button>
+    </form>
+)";
+    }
+    
+    html += R"HTML(    <p><a href="/home">← Вернуться на главную</a></p>
+
+    <h2>Список категорий</h2>
+    <div id="categoriesContainer">
+)HTML";
+    html += listSection("categories", "Пока не было добавлено ни одной категории",
+                        {"Название", "Тип", "Тип доступа", "Действия"},
+                        initial ? categoryRows(*initial) : std::optional<std::string>{});
+    html += R"HTML(    </div>
+
+    <div id="editCategoryModal" style="display:none; position:fixed; z-index:9999; left:0; top:0; width:100%; height:100%; overflow:auto; background-color: rgba(0,0,0,0.4);">
+        <div style="background:#fff; margin:10% auto; padding:20px; border:1px solid #888; width:90%; max-width:480px; border-radius:6px;">
+            <h3>Редактировать категорию</h3>
+            <form id="editCategoryForm">
+                <label>Название
+                    <input type="text" id="editCategoryName" required />
+                </label>
+                <label>Тип
+                    <select id="editCategoryType" required>
+                        <option value="income">Доход</option>
+                        <option value="expense">Расход</option>
+                    </select>
+                </label>
+                <div style="margin-top:12px;">
+                    <button type="submit">Сохранить</button>
+                    <button type="button" onclick="closeEditCategoryModal()" style="margin-left:8px;">Отмена</button>
+                </div>
+            </form>
+        </div>
+    </div>
+
+)HTML";
+    if (initial) {
+        html += pages::initialData(*initial);
+    }
+    html += pages::script(assets::js_bootstrap_js);
+    html += pages::script(assets::js_categories_js);
+    html += "</body>\n</html>\n";
+    
+    return html;
+}
+
+std::string renderTransactionsPage(bool isFamily, const Json::Value *initial) {
+    std::string pageTitle = isFamily ? "Семейные транзакции" : "Транзакции";
+    
+    // Читаем файл transactions.csp и генерируем HTML на его основе
+    // Для краткости, создам упрощенную версию
+    std::string html;
+    html += pages::head(pageTitle + " - Financial Manager", {assets::css_sakura_css, assets::css_app_css});
+    html += "<body>\n    <h1>" + pageTitle + "</h1>\n";
+    
+    {
+        html += R"(    <form id="createTransactionForm">
+        <label>Счёт
+            <select name="id_account" id="accountSelect" required>
+                <option value="">Загрузка счетов...</option>
+            </select>
+            <small id="accountsError" style="color: red; display: none;">Сначала создайте хотя бы один счёт</small>
+        </label>
+        <label>Категория
+            <select name="id_category" id="categorySelect">
+                <option value="">Загрузка категорий...</option>
+            </select>
+            <small style="color: #666; font-size: 0.9em;">(необязательно)</small>
+        </label>
+        <label>Сумма
+            <input type="number" name="amount" step="0.01" min="0.01" required />
+        </label>
+        <label>Тип
+            <select name="type" required>
+                <option value="income">Доход</option>
+                <option value="expense">Расход</option>
+            </select>
+        </label>
+        <label>Описание
+            <input type="text" name="description" />
+        </label>
+        <button type="submit" id="submitBtn">Создать</button>
+        <button type="button" id="cancelTransactionEdit" style="display:none; margin-left:8px;">Отмена</button>
+    </form>
+)";
+    }
+    
+    html += R"HTML(    <p><a href="/home">← Вернуться на главную</a></p>
+
+    <h2>Список транзакций</h2>
+    <div id="transactionsContainer">
+)HTML";
+    html += listSection("transactions", "Пока не было добавлено ни одной транзакции",
+                        {"Счёт", "Сумма", "Тип", "Категория", "Описание", "Дата", "Доступ", "Действия"},
+                        initial ? transactionRows(*initial) : std::optional<std::string>{});
+    html += R"HTML(    </div>
+
+    <div id="editTransactionModal" style="display:none; position:fixed; z-index:9999; left:0; top:0; width:100%; height:100%; overflow:auto; background-color: rgba(0,0,0,0.4);">
+        <div style="background:#fff; margin:6% auto; padding:20px; border:1px solid #888; width:90%; max-width:520px; border-radius:6px;">
+            <h3>Редактировать транзакцию</h3>
+            <form id="editTransactionForm">
+                <label>Счёт
+                    <select id="editTxAccount" required></select>
+                </label>
+                <label>Категория
+                    <select id="editTxCategory">
+                        <option value="">Не выбрано</option>
+                    </select>
+                </label>
+                <label>Сумма
+                    <input type="number" id="editTxAmount" step="0.01" min="0.01" required />
+                </label>
+                <label>Тип
+                    <select id="editTxType" required>
+                        <option value="income">Доход</option>
+                        <option value="expense">Расход</option>
+                    </select>
+                </label>
+                <label>Описание
+                    <input type="text" id="editTxDescription" />
+                </label>
+                <div style="margin-top:12px;">
+                    <button type="submit">Сохранить</button>
+                    <button type="button" onclick="closeEditTransactionModal()" style="margin-left:8px;">Отмена</button>
+                </div>
+            </form>
+        </div>
+    </div>
+
+)HTML";
+    if (initial) {
+        html += pages::initialData(*initial);
+    }
+    html += pages::script(assets::js_bootstrap_js);
+    html += pages::script(assets::js_transactions_js);
+    html += "</body>\n</html>\n";
+    
+    return html;
+}
+
+std::string renderTransfersPage(bool isFamily, const Json::Value *initial) {
+    std::string pageTitle = isFamily ? "Семейные переводы" : "Переводы";
+    
+    std::string html;
+    html += pages::head(pageTitle + " - Financial Manager", {assets::css_sakura_css, assets::css_app_css});
+    html += "<body>\n    <h1>" + pageTitle + "</h1>\n";
+    
+    {
+        html += R"(    <form id="createTransferForm">
+        <label>Счёт отправителя
+            <select name="account_from" id="accountFromSelect" required>
+                <option value="">Загрузка счетов...</option>
+            </select>
+        </label>
+        <label>Счёт получателя
+            <select name="account_to" id="accountToSelect" required>
+                <option value="">Загрузка счетов...</option>
+            </select>
+        </label>
+        <label>Сумма
+            <input type="number" name="amount" step="0.01" min="0.01" required />
+        </label>
+        <button type="submit" id="submitBtn">Создать перевод</button>
+        <button type="button" id="cancelTransferEdit" style="display:none; margin-left:8px;">Отмена</button>
+    </form>
+)";
+    }
+    
+    html += R"HTML(    <p><a href="/home">← Вернуться на главную</a></p>
+
+    <h2>Список переводов</h2>
+    <div id="transfersContainer">
+)HTML";
+    html += listSection("transfers", "Пока не было добавлено ни одного перевода",
+                        {"От", "К", "Сумма", "Дата", "Доступ", "Действия"},
+                        initial ? transferRows(*initial) : std::optional<std::string>{});
+    html += R"HTML(    </div>
+
+    <div id="editTransferModal" style="display:none; position:fixed; z-index:9999; left:0; top:0; width:100%; height:100%; overflow:auto; background-color: rgba(0,0,0,0.4);">
+        <div style="background:#fff; margin:8% auto; padding:20px; border:1px solid #888; width:90%; max-width:520px; border-radius:6px;">
+            <h3>Редактировать перевод</h3>
+            <form id="editTransferForm">
+                <label>Счёт отправителя
+                    <select id="editTransferFrom" required></select>
+                </label>
+                <label>Счёт получателя
+                    <select id="editTransferTo" required></select>
+                </label>
+                <label>Сумма
+                    <input type="number" id="editTransferAmount" step="0.01" min="0.01" required />
+                </label>
+                <div style="margin-top:12px;">
+                    <button type="submit">Сохранить</button>
+                    <button type="button" onclick="closeEditTransferModal()" style="margin-left:8px;">Отмена</button>
+                </div>
+            </form>
+        </div>
+    </div>
+
+)HTML";
+    if (initial) {
+        html += pages::initialData(*initial);
+    }
+    html += pages::script(assets::js_bootstrap_js);
+    html += pages::script(assets::js_transfers_js);
+    html += "</body>\n</html>\n";
+    
+    return html;
+}
+
+std::string renderBudgetsPage(bool isFamily, const Json::Value *initial) {
+    std::string pageTitle = isFamily ? "Семейные бюджеты" : "Бюджеты";
+    
+    std::string html;
+    html += pages::head(pageTitle + " - Financial Manager", {assets::css_sakura_css, assets::css_app_css});
+    html += "<body>\n    <h1>" + pageTitle + "</h1>\n";
+    
+    if (isFamily) {
+        html += R"(    <form id="createBudgetForm">
+        <label>Категория
+            <select name="id_category" id="categorySelect" required>
+                <option value="">Загрузка категорий...</option>
+            </select>
+            <small id="categoriesError" style="color: red; display: none;">Сначала создайте хотя бы одну категорию</small>
+        </label>
+        <label>Месяц
+            <select name="month" required>
+                <option value="1">Январь</option>
+                <option value="2">Февраль</option>
+                <option value="3">Март</option>
+                <option value="4">Апрель</option>
+                <option value="5">Май</option>
+                <option value="6">Июнь</option>
+                <option value="7">Июль</option>
+                <option value="8">Август</option>
+                <option value="9">Сентябрь</option>
+                <option value="10">Октябрь</option>
+                <option value="11">Ноябрь</option>
+                <option value="12">Декабрь</option>
+            </select>
+        </label>
+        <label>Год
+            <input type="number" name="year" min="2000" max="2100" value="2024" required />
+        </label>
+        <label>Лимит
+            <input type="text" name="limit_amount" placeholder="0.00" required />
+        </label>
+        <button type="submit" id="submitBtn">Создать бюджет</button>
+        <button type="button" id="cancelBudgetEdit" style="display:none; margin-left:8px;">Отмена</button>
+    </form>
+)";
+    } else {
+        html += R"(    <form id="createBudgetForm">
+        <label>Категория
+            <select name="id_category" id="categorySelect" required>
+                <option value="">Загрузка категорий...</option>
+            </select>
+            <small id="categoriesError" style="color: red; display: none;">Сначала создайте хотя бы одну категорию</small>
+        </label>
+        <label>Месяц
+            <select name="month" required>
+                <option value="1">Январь</option>
+                <option value="2">Февраль</option>
+                <option value="3">Март</option>
+                <option value="4">Апрель</option>
+                <option value="5">Май</option>
+                <option value="6">Июнь</option>
+                <option value="7">Июль</option>
+                <option value="8">Август</option>
+                <option value="9">Сентябрь</option>
+                <option value="10">Октябрь</option>
+                <option value="11">Ноябрь</option>
+                <option value="12">Декабрь</option>
+            </select>
+        </label>
+        <label>Год
+            <input type="number" name="year" min="2000" max="2100" value="2024" required />
+        </label>
+        <label>Лимит
+            <input type="text" name="limit_amount" placeholder="0.00" required />
+        </label>
+        <label id="isFamilyLabel" style="display: none;">
+            <input type="checkbox" name="is_family" id="isFamilyCheckbox" />
+            Семейный бюджет
+        </label>
+        <button type="submit" id="submitBtn">Создать бюджет</button>
+        <button type="button" id="cancelBudgetEdit" style="display:none; margin-left:8px;">Отмена</button>
+    </form>
+)";
+    }
+    
+    html += R"HTML(    <p><a href="/home">← Вернуться на главную</a></p>
+
+    <h2>Список бюджетов</h2>
+    <div id="budgetsContainer">
+)HTML";
+    html += listSection("budgets", "Пока не было добавлено ни одного бюджета",
+                        {"Категория", "Месяц", "Год", "Лимит", "Тип доступа", "Действия"},
+                        initial ? budgetRows(*initial) : std::optional<std::string>{});
+    html += R"HTML(    </div>
+
+    <div id="editBudgetModal" style="display:none; position:fixed; z-index:9999; left:0; top:0; width:100%; height:100%; overflow:auto; background-color: rgba(0,0,0,0.4);">
+        <div style="background:#fff; margin:8% auto; padding:20px; border:1px solid #888; width:90%; max-width:520px; border-radius:6px;">
+            <h3>Редактировать бюджет</h3>
+            <form id="editBudgetForm">
+                <label>Категория
+                    <select id="editBudgetCategory" required></select>
+                </label>
+                <label>Месяц
+                    <select id="editBudgetMonth" required>
+                        <option value="1">Январь</option>
+                        <option value="2">Февраль</option>
+                        <option value="3">Март</option>
+                        <option value="4">Апрель</option>
+                        <option value="5">Май</option>
+                        <option value="6">Июнь</option>
+                        <option value="7">Июль</option>
+                        <option value="8">Август</option>
+                        <option value="9">Сентябрь</option>
+                        <option value="10">Октябрь</option>
+                        <option value="11">Ноябрь</option>
+                        <option value="12">Декабрь</option>
+                    </select>
+                </label>
+                <label>Год
+                    <input type="number" id="editBudgetYear" min="2000" max="2100" required />
+                </label>
+                <label>Лимит
+                    <input type="text" id="editBudgetLimit" required />
+                </label>
+                <div style="margin-top:12px;">
+                    <button type="submit">Сохранить</button>
+                    <button type="button" onclick="closeEditBudgetModal()" style="margin-left:8px;">Отмена</button>
+                </div>
+            </form>
+        </div>
+    </div>
+
+)HTML";
+    if (initial) {
+        html += pages::initialData(*initial);
+    }
+    html += pages::script(assets::js_bootstrap_js);
+    html += pages::script(assets::js_budgets_js);
+    html += "</body>\n</html>\n";
+    
+    return html;
+}
+
+std::string renderAccountsPage(bool isFamily) {
+    std::string pageTitle = isFamily ? "Создать семейный счёт" : "Создать счёт";
+
+    std::string html;
+    html += pages::head(pageTitle + " - Financial Manager", {assets::css_sakura_css, assets::css_app_css});
+    html += "<body>\n    <h1>" + pageTitle + "</h1>\n";
+    html += R"HTML(    <form id="accountForm">
+        <label>Название счёта
+            <input type="text" name="account_name" required />
+        </label>
+        <label>Тип счёта
+            <select name="account_type" required>
+                <option value="cash">Наличные</option>
+                <option value="card">Карта</option>
+                <option value="deposit">Депозит</option>
+            </select>
+        </label>
+        <label>Начальный баланс
+            <input type="number" name="balance" step="0.01" min="0" value="0" placeholder="0.00" />
+        </label>
+)HTML";
+    if (isFamily) {
+        html += "        <input type=\"hidden\" name=\"is_family\" value=\"true\" />\n";
+    }
+    html += R"HTML(        <button type="submit">Создать</button>
+    </form>
+    <p id="result"></p>
+
+    <h2>Список счетов</h2>
+    <div id="accountsContainer">
+        <p id="loadingMessage">Загрузка...</p>
+        <div id="emptyMessage" style="display: none;">
+            <p style="color: #666; font-style: italic;">Пока не было добавлено ни одного счёта</p>
+        </div>
+        <table id="accountsTable" style="display: none; margin-top: 1em;">
+            <thead>
+                <tr>
+                    <th>Название</th>
+                    <th>Тип</th>
+                    <th>Баланс</th>
+                    <th>Тип доступа</th>
+                    <th>Дата создания</th>
+                    <th>Действия</th>
+                </tr>
+            </thead>
+            <tbody id="accountsTableBody">
+            </tbody>
+        </table>
+    </div>
+    <p><a href="/home">← Вернуться на главную</a></p>
+
+    <div id="editModal" class="modal-overlay">
+        <div class="modal-box">
+            <h2>Редактировать счёт</h2>
+            <form id="editAccountForm">
+                <input type="hidden" id="editAccountId" />
+                <label>Название счёта
+                    <input type="text" id="editAccountName" required />
+                </label>
+                <label>Тип счёта
+                    <select id="editAccountType" required>
+                        <option value="cash">Наличные</option>
+                        <option value="card">Карта</option>
+                        <option value="deposit">Депозит</option>
+                    </select>
+                </label>
+                <label>Баланс
+                    <input type="number" id="editAccountBalance" step="0.01" min="0" required />
+                </label>
+                <div class="modal-actions">
+                    <button type="submit">Сохранить</button>
+                    <button type="button" onclick="closeEditModal()">Отмена</button>
+                </div>
+            </form>
+        </div>
+    </div>
+
+)HTML";
+    html += pages::script(assets::js_accounts_js);
+    html += "</body>\n</html>\n";
+
+    return html;
+}
+
+std::string renderCreateFamilyPage(const std::string &error) {
+    std::string html = pages::head("Создать семейный аккаунт", {assets::css_sakura_css, assets::css_family_css});
+    html += "<body>\n    <h1>Создать семейный аккаунт</h1>\n";
+    if (!error.empty()) {
+        html += "    <div class=\"error\">" + esc(error) + "</div>\n";
+    }
+    html += R"HTML(    <form id="createFamilyForm">
+        <label for="name">Название семьи:</label>
+        <input type="text" id="name" name="name" required placeholder="Например: Семья Ивановых">
+        <button type="submit">Создать семью</button>
+    </form>
+
+    <p><a href="/home">Вернуться на главную</a></p>
+)HTML";
+    html += pages::script(assets::js_create_family_js);
+    html += "</body>\n</html>\n";
+
+    return html;
+}
+
+}
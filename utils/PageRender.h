@@ -0,0 +1,18 @@
+#pragma once
+#include <string>
+#include <jsoncpp/json/json.h>
+
+// HTML страниц PageController. isFamily — семейный режим страницы; initial — стартовые
+// данные (объект с массивами accounts/categories/...), nullptr — оболочка без данных,
+// списки загружает JS. Функции чистые: их можно кешировать и гонять в микробенчмарках
+namespace pages {
+    std::string renderIndex(bool isFamily);
+    std::string renderHomePage(bool isFamily);
+    std::string renderCategoriesPage(bool isFamily, const Json::Value *initial);
+    std::string renderTransactionsPage(bool isFamily, const Json::Value *initial);
+    std::string renderTransfersPage(bool isFamily, const Json::Value *initial);
+    std::string renderBudgetsPage(bool isFamily, const Json::Value *initial);
+    std::string renderAccountsPage(bool isFamily);
+    // error — сообщение над формой (пользователь уже в семье); пустая строка — без него
+    std::string renderCreateFamilyPage(const std::string &error);
+}
@@ -0,0 +1,65 @@
+#include "PageShell.h"
+#include <algorithm>
+
+namespace pages {
+
+std::string head(const std::string &title, std::initializer_list<const char *> styles) {
+    std::string html;
+    html.reserve(256);
+    html += "<!DOCTYPE html>\n<html lang=\"ru\">\n<head>\n    <meta charset=\"UTF-8\" />\n";
+    html += "    <title>" + title + "</title>\n";
+    for (const char *href : styles) {
+        html += "    <link rel=\"stylesheet\" href=\"";
+        html += href;
+        html += "\" />\n";
+    }
+    html += "</head>\n";
+    return html;
+}
+
+std::string script(const char *src) {
+    std::string html = "    <script src=\"";
+    html += src;
+    html += "\"></script>\n";
+    return html;
+}
+
+std::string initialData(const Json::Value &data) {
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    auto json = Json::writeString(builder, data);
+
+    std::string html = "    <script id=\"initialData\" type=\"application/json\">";
+    html.reserve(html.size() + json.size() + 16);
+    // '<' встречается только внутри строк JSON; экранируем, чтобы не закрыть тег раньше времени
+    for (char c : json) {
+        if (c == '<') {
+            html += "\\u003c";
+        } else {
+            html += c;
+        }
+    }
+    html += "</script>\n";
+    return html;
+}
+
+bool isFingerprintedAsset(std::string_view path) {
+    // Длина хеша — как в cmake/FingerprintAssets.cmake
+    constexpr size_t hashLength = 10;
+    if (!path.starts_with("/static/")) {
+        return false;
+    }
+    const auto ext = path.rfind('.');
+    if (ext == std::string_view::npos || (path.substr(ext) != ".css" && path.substr(ext) != ".js")) {
+        return false;
+    }
+    const auto stem = path.substr(0, ext);
+    const auto dot = stem.rfind('.');
+    if (dot == std::string_view::npos || stem.size() - dot - 1 != hashLength) {
+        return false;
+    }
+    return std::all_of(stem.begin() + dot + 1, stem.end(),
+                       [](char c) { return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'); });
+}
+
+}
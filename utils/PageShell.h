@@ -0,0 +1,17 @@
+#pragma once
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <jsoncpp/json/json.h>
+
+// Каркас HTML-страниц: <head> со ссылками на статические стили и подключение скриптов.
+// Пути к ассетам берутся из сгенерированного StaticAssets.h (с хешем содержимого в имени).
+namespace pages {
+    std::string head(const std::string &title, std::initializer_list<const char *> styles);
+    std::string script(const char *src);
+    // Данные, отрендеренные на сервере, для скриптов страницы: <script id="initialData" type="application/json">
+    std::string initialData(const Json::Value &data);
+    // Путь ассета с хешем содержимого в имени (/static/css/app.<hash>.css): его содержимое
+    // по этому пути не меняется, и ответ можно кешировать как immutable
+    bool isFingerprintedAsset(std::string_view path);
+}
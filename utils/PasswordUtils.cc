@@ -6,7 +6,7 @@
 #include <iomanip>
 #include <sstream>
 
-static std::string bytesToHex(const unsigned char *bytes, size_t len) {
+std::string security::bytesToHex(const unsigned char *bytes, size_t len) {
     std::stringstream ss;
     ss << std::hex << std::setfill('0');
     for (size_t i = 0; i < len; ++i) {
@@ -20,7 +20,7 @@ static std::string generateSalt() {
     if (!RAND_bytes(salt, 16)) {
         throw std::runtime_error("Failed to generate salt");
     }
-    return bytesToHex(salt, 16);
+    return security::bytesToHex(salt, 16);
 }
 
 std::string security::hashPassword(const std::string &password) {
@@ -35,7 +35,7 @@ std::string security::hashPassword(const std::string &password) {
         throw std::runtime_error("PBKDF2 failed");
     }
 
-    return salt + "$" + bytesToHex(hash, 32);
+    return salt + "$" + security::bytesToHex(hash, 32);
 }
 
 bool security::verifyPassword(const std::string &password, const std::string &hash) {
@@ -54,6 +54,6 @@ bool security::verifyPassword(const std::string &password, const std::string &ha
         return false;
     }
 
-    std::string computedHex = bytesToHex(out, 32);
+    std::string computedHex = security::bytesToHex(out, 32);
     return storedHash == computedHex;
 }
\ No newline at end of file
@@ -1,7 +1,10 @@
 #pragma once
+#include <cstddef>
 #include <string>
 
 namespace security {
     std::string hashPassword(const std::string &password);
     bool verifyPassword(const std::string &password, const std::string &hash);
+    // Байты -> строчный hex (соль и хеш в сохранённом пароле)
+    std::string bytesToHex(const unsigned char *bytes, size_t len);
 }
\ No newline at end of file
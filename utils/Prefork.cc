@@ -0,0 +1,278 @@
+#include "Prefork.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <stdexcept>
+#include <string_view>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+#include <drogon/HttpAppFramework.h>
+
+using Clock = std::chrono::steady_clock;
+
+static prefork::Options g_options;
+static size_t g_workerIndex = 0;
+
+// Больше процессов, чем kMaxWorkersPerCore на ядро, — почти наверняка опечатка в конфиге
+static constexpr size_t kMaxWorkersPerCore = 4;
+
+static size_t maxWorkers() {
+    return std::max<size_t>(1, std::thread::hardware_concurrency()) * kMaxWorkersPerCore;
+}
+
+// Число рабочих процессов: целое в 0..maxWorkers(), иначе сервер не стартует
+static size_t parseWorkers(std::string_view value, const char *source) {
+    size_t workers = 0;
+    const auto *end = value.data() + value.size();
+    auto [ptr, ec] = std::from_chars(value.data(), end, workers);
+    if (value.empty() || ec != std::errc() || ptr != end || workers > maxWorkers()) {
+        throw std::runtime_error(std::string(source) + " must be an integer in 0.." +
+                                 std::to_string(maxWorkers()) + ", got '" + std::string(value) + "'");
+    }
+    return workers;
+}
+
+const prefork::Options &prefork::loadOptions() {
+    const auto &cfg = drogon::app().getCustomConfig()["prefork"];
+    if (cfg.isObject()) {
+        const auto &workers = cfg["workers"];
+        if (!workers.isNull()) {
+            g_options.workers = parseWorkers(workers.isIntegral() ? workers.asString() : std::string(),
+                                             "custom_config.prefork.workers");
+        }
+        g_options.metricsPortBase = static_cast<uint16_t>(cfg.get("metrics_port_base", 9100).asUInt());
+        g_options.drainTimeoutSec = cfg.get("drain_timeout_sec", 10.0).asDouble();
+    }
+    if (const char *env = std::getenv("FM_WORKERS")) {
+        g_options.workers = parseWorkers(env, "FM_WORKERS");
+    }
+    if (const char *env = std::getenv("FM_DRAIN_TIMEOUT")) {
+        g_options.drainTimeoutSec = std::atof(env);
+    }
+    // Без явной настройки листенер есть только у рабочих процессов: через него собирается /metrics
+    g_options.localListener = cfg.isObject() && cfg.isMember("local_listener") ? cfg["local_listener"].asBool()
+                                                                               : g_options.workers > 0;
+    return g_options;
+}
+
+const prefork::Options &prefork::options() {
+    return g_options;
+}
+
+size_t prefork::workerIndex() {
+    return g_workerIndex;
+}
+
+uint16_t prefork::localPort() {
+    return static_cast<uint16_t>(g_options.metricsPortBase + g_workerIndex);
+}
+
+bool prefork::hasLocalListener() {
+    return g_options.localListener;
+}
+
+// Сигналы остановки. Обработчики только выставляют флаг, вся работа — в основном цикле
+static std::atomic<bool> stopRequested{false};
+
+static void onStopSignal(int) {
+    stopRequested.store(true);
+}
+
+static void installStopHandler() {
+    struct sigaction sa {};
+    sa.sa_handler = onStopSignal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGTERM, &sa, nullptr);
+    sigaction(SIGINT, &sa, nullptr);
+}
+
+static std::string describeExit(int status) {
+    if (WIFEXITED(status)) {
+        return "exit code " + std::to_string(WEXITSTATUS(status));
+    }
+    if (WIFSIGNALED(status)) {
+        return "signal " + std::to_string(WTERMSIG(status));
+    }
+    return "status " + std::to_string(status);
+}
+
+size_t prefork::runSupervisor() {
+    const size_t workers = g_options.workers;
+    std::vector<pid_t> pids(workers, 0);
+    std::vector<Clock::time_point> startedAt(workers);
+    const pid_t supervisorPid = getpid();
+
+    installStopHandler();
+
+    // В дочернем процессе возвращает true: дальше он работает как обычный сервер
+    auto spawn = [&](size_t i) -> bool {
+        pid_t pid = fork();
+        if (pid < 0) {
+            LOG_ERROR << "fork failed for worker " << i;
+            return false;
+        }
+        if (pid == 0) {
+            g_workerIndex = i;
+            signal(SIGTERM, SIG_DFL);
+            signal(SIGINT, SIG_DFL);
+#ifdef __linux__
+            // Супервизор убит — рабочий процесс тоже завершается (штатно, через SIGTERM)
+            prctl(PR_SET_PDEATHSIG, SIGTERM);
+#endif
+            if (getppid() != supervisorPid) {
+                std::_Exit(0);
+            }
+            return true;
+        }
+        pids[i] = pid;
+        startedAt[i] = Clock::now();
+        LOG_INFO << "Worker " << i << " started, pid " << pid;
+        return false;
+    };
+
+    for (size_t i = 0; i < workers; ++i) {
+        if (spawn(i)) {
+            return i;
+        }
+    }
+
+    // Супервизор: перезапускаем упавшие процессы, пока не пришёл SIGTERM
+    while (!stopRequested.load()) {
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, WNOHANG);
+        if (pid <= 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
+        for (size_t i = 0; i < workers; ++i) {
+            if (pids[i] != pid) {
+                continue;
+            }
+            pids[i] = 0;
+            LOG_ERROR << "Worker " << i << " (pid " << pid << ") exited: " << describeExit(status);
+            // Процесс, упавший сразу после старта, перезапускаем с паузой, чтобы не крутиться в цикле
+            if (Clock::now() - startedAt[i] < std::chrono::seconds(1)) {
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+            }
+            if (!stopRequested.load() && spawn(i)) {
+                return i;
+            }
+        }
+    }
+
+    // Остановка: рабочие процессы доделывают текущие запросы, упрямых добиваем SIGKILL
+    LOG_INFO << "Supervisor: stopping workers";
+    for (pid_t pid : pids) {
+        if (pid > 0) {
+            kill(pid, SIGTERM);
+        }
+    }
+    auto deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                       std::chrono::duration<double>(g_options.drainTimeoutSec + 5));
+    size_t alive = 0;
+    for (pid_t pid : pids) {
+        alive += pid > 0 ? 1 : 0;
+    }
+    bool killed = false;
+    while (alive > 0) {
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, WNOHANG);
+        if (pid > 0) {
+            for (auto &p : pids) {
+                if (p == pid) {
+                    p = 0;
+                    --alive;
+                }
+            }
+            continue;
+        }
+        if (pid < 0) {
+            break;
+        }
+        if (!killed && Clock::now() >= deadline) {
+            LOG_ERROR << "Supervisor: workers did not stop in time, sending SIGKILL";
+            for (pid_t p : pids) {
+                if (p > 0) {
+                    kill(p, SIGKILL);
+                }
+            }
+            killed = true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    std::exit(0);
+}
+
+// Запросы в обработке — по счётчику на IO-поток, чтобы потоки не делили строку кеша.
+// Запрос может завершиться в другом потоке, поэтому смысл имеет только сумма
+struct alignas(64) InFlightCounter {
+    std::atomic<int64_t> value{0};
+};
+static std::array<InFlightCounter, 64> inFlight;
+
+static const std::string kInFlightKey = "prefork.in_flight";
+
+static std::atomic<int64_t> &localInFlight() {
+    return inFlight[drogon::app().getCurrentThreadIndex() % inFlight.size()].value;
+}
+
+static int64_t totalInFlight() {
+    int64_t total = 0;
+    for (const auto &c : inFlight) {
+        total += c.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void prefork::enableGracefulDrain() {
+    auto &app = drogon::app();
+    app.disableSigtermHandling();
+    installStopHandler();
+
+    // Post-handling advice не вызывается для статических файлов, 404 и отказов pre-handling
+    // advice (503), а pre-sending — для любого ответа. Отметка в атрибутах запроса: уменьшается
+    // только то, что было увеличено
+    app.registerPreRoutingAdvice([](const drogon::HttpRequestPtr &req) {
+        req->attributes()->insert(kInFlightKey, true);
+        localInFlight().fetch_add(1, std::memory_order_relaxed);
+    });
+    app.registerPreSendingAdvice([](const drogon::HttpRequestPtr &req, const drogon::HttpResponsePtr &) {
+        const auto &attrs = req->attributes();
+        if (attrs->find(kInFlightKey)) {
+            attrs->erase(kInFlightKey);
+            localInFlight().fetch_sub(1, std::memory_order_relaxed);
+        }
+    });
+
+    app.registerBeginningAdvice([] {
+        drogon::app().getLoop()->runEvery(0.1, [] {
+            static bool draining = false;
+            static bool quitting = false;
+            static Clock::time_point deadline;
+            if (!stopRequested.load() || quitting) {
+                return;
+            }
+            if (!draining) {
+                draining = true;
+                deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                              std::chrono::duration<double>(g_options.drainTimeoutSec));
+                LOG_INFO << "Draining " << totalInFlight() << " in-flight requests before shutdown";
+            }
+            if (totalInFlight() <= 0 || Clock::now() >= deadline) {
+                quitting = true;
+                drogon::app().quit();
+            }
+        });
+    });
+}
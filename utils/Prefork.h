@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Prefork-режим: после загрузки конфига процесс-супервизор форкает N рабочих процессов.
+// Каждый слушает тот же порт через SO_REUSEPORT (ядро само раскидывает соединения),
+// держит свои IO-потоки и свой пул соединений с БД. Упавшие процессы перезапускаются.
+namespace prefork {
+
+struct Options {
+    // 0 — обычный режим: один процесс без супервизора
+    size_t workers = 0;
+    // Рабочий процесс i дополнительно слушает 127.0.0.1:metricsPortBase + i,
+    // через этот порт /metrics собирает метрики всех процессов
+    uint16_t metricsPortBase = 9100;
+    // Loopback-листенер (он же нужен для /admin/log-level). По умолчанию — только в prefork-режиме,
+    // чтобы несколько одиночных процессов на одной машине не спорили за metricsPortBase
+    bool localListener = false;
+    // Сколько ждать завершения текущих запросов после SIGTERM
+    double drainTimeoutSec = 10;
+};
+
+// custom_config.prefork из config.json; FM_WORKERS и FM_DRAIN_TIMEOUT имеют приоритет.
+// Число процессов вне 0..4 * hardware_concurrency — std::runtime_error.
+// Вызывать после loadConfigFile
+const Options &loadOptions();
+
+// Настройки, прочитанные loadOptions()
+const Options &options();
+
+// Форкает рабочие процессы и следит за ними. В рабочем процессе возвращает его номер;
+// супервизор из функции не возвращается: по SIGTERM пересылает сигнал рабочим,
+// дожидается их завершения и выходит. Вызывать до app().run(), пока нет потоков
+size_t runSupervisor();
+
+// Номер текущего рабочего процесса (0 в обычном режиме)
+size_t workerIndex();
+
+// Loopback-порт текущего процесса: metricsPortBase + workerIndex()
+uint16_t localPort();
+
+// Слушает ли процесс localPort() (options().localListener)
+bool hasLocalListener();
+
+// SIGTERM/SIGINT: новые соединения ещё принимаются, но приложение завершается, как только
+// закончатся запросы в обработке (или по истечении drainTimeoutSec), вместо немедленного quit()
+void enableGracefulDrain();
+
+}
@@ -0,0 +1,140 @@
+#include "Profiling.h"
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <drogon/HttpAppFramework.h>
+#include <trantor/utils/Logger.h>
+
+static profiling::Options g_options;
+
+static const std::string kTraceKey = "profiling.trace";
+
+const profiling::Options &profiling::loadOptions() {
+    const auto &cfg = drogon::app().getCustomConfig()["profiling"];
+    if (cfg.isObject()) {
+        g_options.enabled = cfg.get("enabled", false).asBool();
+        g_options.token = cfg.get("server_timing_token", "").asString();
+        g_options.slowRequestMs = cfg.get("slow_request_ms", 0.0).asDouble();
+        g_options.slowSampleRate = cfg.get("slow_sample_rate", 1.0).asDouble();
+    }
+    if (const char *env = std::getenv("FM_PROFILING")) {
+        g_options.enabled = std::atoi(env) != 0;
+    }
+    if (const char *env = std::getenv("FM_SLOW_REQUEST_MS")) {
+        g_options.slowRequestMs = std::atof(env);
+    }
+    return g_options;
+}
+
+const profiling::Options &profiling::options() {
+    return g_options;
+}
+
+void profiling::Trace::add(std::string_view name, double ms) {
+    for (auto &span : spans_) {
+        if (span.name == name) {
+            span.ms += ms;
+            ++span.count;
+            return;
+        }
+    }
+    spans_.push_back({std::string(name), ms, 1});
+}
+
+std::shared_ptr<profiling::Trace> profiling::requestTrace(const drogon::HttpRequestPtr &req) {
+    if (!g_options.enabled) {
+        return nullptr;
+    }
+    const auto &attrs = req->attributes();
+    if (!attrs->find(kTraceKey)) {
+        return nullptr;
+    }
+    return attrs->get<std::shared_ptr<Trace>>(kTraceKey);
+}
+
+drogon::HttpResponsePtr profiling::jsonResponse(const drogon::HttpRequestPtr &req, const Json::Value &value) {
+    Span span(req, "serialize");
+    return drogon::HttpResponse::newHttpJsonResponse(value);
+}
+
+void profiling::markSharedResponse(const drogon::HttpRequestPtr &req) {
+    if (auto trace = requestTrace(req)) {
+        trace->sharedResponse = true;
+    }
+}
+
+void profiling::beginRequest(const drogon::HttpRequestPtr &req) {
+    req->attributes()->insert(kTraceKey, std::make_shared<Trace>());
+    // Тело разбирается лениво при первом getJsonObject(); здесь разбор делается заранее,
+    // чтобы замерить его отдельно, обработчик получит уже готовый объект
+    if (req->contentType() == drogon::CT_APPLICATION_JSON) {
+        Span span(req, "json");
+        req->getJsonObject();
+    }
+}
+
+static bool timingAllowed(const drogon::HttpRequestPtr &req) {
+    const auto &token = profiling::options().token;
+    return !token.empty() && req->getHeader("x-profile-token") == token;
+}
+
+static std::string formatMs(double ms) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.3f", ms);
+    return buf;
+}
+
+static bool sampled() {
+    const double rate = profiling::options().slowSampleRate;
+    if (rate >= 1) {
+        return true;
+    }
+    thread_local std::minstd_rand rng(std::random_device{}());
+    return std::uniform_real_distribution<double>(0, 1)(rng) < rate;
+}
+
+void profiling::finishRequest(const drogon::HttpRequestPtr &req, const drogon::HttpResponsePtr &resp) {
+    auto trace = requestTrace(req);
+    if (!trace) {
+        return;
+    }
+    const double totalMs =
+        static_cast<double>(trantor::Date::now().microSecondsSinceEpoch() - req->creationDate().microSecondsSinceEpoch()) /
+        1000.0;
+
+    if (!trace->sharedResponse && timingAllowed(req)) {
+        std::string header;
+        for (const auto &span : trace->spans()) {
+            header += span.name + ";dur=" + formatMs(span.ms);
+            if (span.count > 1) {
+                header += ";desc=\"x" + std::to_string(span.count) + "\"";
+            }
+            header += ", ";
+        }
+        header += "total;dur=" + formatMs(totalMs);
+        resp->addHeader("Server-Timing", header);
+    }
+
+    if (g_options.slowRequestMs > 0 && totalMs >= g_options.slowRequestMs && sampled()) {
+        Json::Value entry;
+        std::string route(req->matchedPathPattern());
+        entry["route"] = route.empty() ? "unmatched" : route;
+        entry["method"] = std::string(req->methodString());
+        entry["path"] = req->path();
+        entry["status"] = static_cast<int>(resp->statusCode());
+        entry["total_ms"] = totalMs;
+        Json::Value spans(Json::arrayValue);
+        for (const auto &span : trace->spans()) {
+            Json::Value s;
+            s["name"] = span.name;
+            s["ms"] = span.ms;
+            s["count"] = span.count;
+            spans.append(std::move(s));
+        }
+        entry["spans"] = std::move(spans);
+
+        Json::StreamWriterBuilder builder;
+        builder["indentation"] = "";
+        LOG_WARN << "Slow request " << Json::writeString(builder, entry);
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <drogon/HttpRequest.h>
+#include <drogon/HttpResponse.h>
+#include <jsoncpp/json/json.h>
+
+// Профилирование отдельных запросов: из чего сложилось время ответа. Включается
+// custom_config.profiling.enabled (или FM_PROFILING=1); выключенное стоит одну проверку флага
+// на участок. Участки (auth, json, db.<тег запроса>, serialize, render) копятся в Trace запроса.
+// По итогам — заголовок Server-Timing для разрешённых клиентов и строка в логе
+// для медленных запросов.
+namespace profiling {
+
+struct Options {
+    bool enabled = false;
+    // Server-Timing получают запросы с заголовком X-Profile-Token, равным этому значению.
+    // Пустой токен — заголовок не отдаётся никому
+    std::string token;
+    // Запросы дольше порога попадают в лог с разбивкой по участкам; 0 — не логировать
+    double slowRequestMs = 0;
+    // Доля медленных запросов, которые логируются
+    double slowSampleRate = 1;
+};
+
+// custom_config.profiling из config.json; FM_PROFILING и FM_SLOW_REQUEST_MS имеют приоритет.
+// Вызывать после loadConfigFile
+const Options &loadOptions();
+
+const Options &options();
+
+// Участки одного запроса. Одноимённые участки (несколько запросов с одним тегом)
+// складываются. Участки, идущие параллельно (when_all), могут в сумме превышать общее время
+class Trace {
+public:
+    struct Span {
+        std::string name;
+        double ms = 0;
+        uint32_t count = 0;
+    };
+
+    void add(std::string_view name, double ms);
+    const std::vector<Span> &spans() const {
+        return spans_;
+    }
+
+    // Ответ — общий объект из кеша (pages::CachedPage): заголовок в него добавлять нельзя
+    bool sharedResponse = false;
+
+private:
+    std::vector<Span> spans_;
+};
+
+// Trace запроса или nullptr, если профилирование выключено
+std::shared_ptr<Trace> requestTrace(const drogon::HttpRequestPtr &req);
+
+// Замер участка от конструктора до деструктора
+class Span {
+public:
+    Span(const drogon::HttpRequestPtr &req, std::string_view name)
+        : trace_(options().enabled ? requestTrace(req) : nullptr), name_(name) {
+        if (trace_) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+    ~Span() {
+        if (trace_) {
+            trace_->add(name_, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count());
+        }
+    }
+    Span(const Span &) = delete;
+    Span &operator=(const Span &) = delete;
+
+private:
+    std::shared_ptr<Trace> trace_;
+    std::string_view name_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Ответ с JSON; сериализация замеряется как участок serialize
+drogon::HttpResponsePtr jsonResponse(const drogon::HttpRequestPtr &req, const Json::Value &value);
+
+// Отмечает, что запросу отдан общий закешированный ответ
+void markSharedResponse(const drogon::HttpRequestPtr &req);
+
+// Pre-handling advice: заводит Trace и разбирает JSON-тело как участок json
+void beginRequest(const drogon::HttpRequestPtr &req);
+
+// Post-handling advice: Server-Timing и лог медленного запроса
+void finishRequest(const drogon::HttpRequestPtr &req, const drogon::HttpResponsePtr &resp);
+
+}